@@ -7,6 +7,8 @@
 
 #include "Ancora/Core/Timestep.h"
 #include "Ancora/Core/Random.h"
+#include "Ancora/Core/JobSystem.h"
+#include "Ancora/Core/FileWatcher.h"
 
 #include "Ancora/Core/Input.h"
 #include "Ancora/Core/KeyCodes.h"
@@ -16,6 +18,17 @@
 
 #include "Ancora/ImGui/ImGuiLayer.h"
 
+// ------------------- Scene -------------------
+#include "Ancora/Scene/SceneGraph.h"
+#include "Ancora/Scene/World.h"
+#include "Ancora/Scene/Components.h"
+#include "Ancora/Scene/SceneRenderer.h"
+#include "Ancora/Scene/ChunkStreamer.h"
+
+// ------------------ Physics -------------------
+#include "Ancora/Physics/Broadphase.h"
+#include "Ancora/Physics/NarrowPhase.h"
+
 // ------------------ Renderer ------------------
 #include "Ancora/Renderer/Renderer.h"
 #include "Ancora/Renderer/Renderer2D.h"
@@ -23,9 +36,21 @@
 #include "Ancora/Renderer/RenderCommand.h"
 
 #include "Ancora/Renderer/Buffer.h"
+#include "Ancora/Renderer/Framebuffer.h"
+#include "Ancora/Renderer/StorageBuffer.h"
+#include "Ancora/Renderer/StreamingBuffer.h"
 #include "Ancora/Renderer/Shader.h"
 #include "Ancora/Renderer/Texture.h"
+#include "Ancora/Renderer/TextureTable.h"
 #include "Ancora/Renderer/VertexArray.h"
+#include "Ancora/Renderer/StaticMeshBatch.h"
+#include "Ancora/Renderer/CommandBuffer.h"
+#include "Ancora/Renderer/HiZBuffer.h"
+#include "Ancora/Renderer/ShadowMap.h"
+#include "Ancora/Renderer/Primitives.h"
+#include "Ancora/Renderer/Material.h"
+#include "Ancora/Renderer/ParticleSystem.h"
+#include "Ancora/Renderer/GPUTimer.h"
 
 #include "Ancora/Renderer/Light.h"
 #include "Ancora/Renderer/OrthographicCamera.h"
@@ -3,6 +3,9 @@
 
 #include "Ancora/Renderer/Renderer.h"
 
+#include "Ancora/Core/FileWatcher.h"
+#include "Ancora/Core/JobSystem.h"
+
 #include "Ancora/Core/Input.h"
 #include "Ancora/Core/KeyCodes.h"
 
@@ -23,7 +26,13 @@ namespace Ancora {
 		m_Window->SetEventCallback(BIND_EVENT_FN(OnEvent));
 		m_Window->SetVSync(false);
 
+		JobSystem::Init();
+#ifndef AE_DIST
+		// Before anything loads assets, so that they are all watched
+		FileWatcher::Init();
+#endif
 		Renderer::Init();
+		Renderer::OnWindowResize(m_Window->GetWidth(), m_Window->GetHeight());
 
 		m_ImGuiLayer = new ImGuiLayer();
 		PushOverlay(m_ImGuiLayer);
@@ -31,7 +40,8 @@ namespace Ancora {
 
 	Application::~Application()
 	{
-
+		FileWatcher::Shutdown();
+		JobSystem::Shutdown();
 	}
 
 	void Application::PushLayer(Layer* layer)
@@ -68,6 +78,9 @@ namespace Ancora {
 			Timestep timestep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
+			// Reloads changed assets before anything uses them this frame
+			FileWatcher::Update();
+
 			if (!m_Minimized)
 			{
 				for (Layer* layer : m_LayerStack)
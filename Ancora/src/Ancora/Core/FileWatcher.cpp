@@ -0,0 +1,222 @@
+#include "aepch.h"
+#include "FileWatcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifdef AE_PLATFORM_LINUX
+  #include <poll.h>
+  #include <sys/inotify.h>
+  #include <unistd.h>
+#endif
+
+namespace Ancora {
+
+  using Clock = std::chrono::steady_clock;
+
+  struct FileWatch
+  {
+    uint32_t ID;
+    std::function<void()> Callback;
+  };
+
+  struct FileWatcherData
+  {
+    std::thread Thread;
+    std::atomic<bool> Running = false;
+    int Descriptor = -1;
+
+    // Guards everything below, which the watch thread reads
+    std::mutex Mutex;
+    uint32_t NextID = 1;
+    // Keyed by absolute, normalized path
+    std::unordered_map<std::string, std::vector<FileWatch>> Watches;
+    std::unordered_map<uint32_t, std::string> WatchPaths;
+    // Directories are watched instead of files, because editors often replace a file rather
+    // than write to it. They stay watched until shutdown.
+    std::unordered_map<int, std::string> Directories;
+    std::unordered_set<std::string> WatchedDirectories;
+    // Watched files that changed, with the time of their last change
+    std::unordered_map<std::string, Clock::time_point> Changes;
+  };
+
+  // Null while the watcher is not running
+  static FileWatcherData* s_Data = nullptr;
+
+  // A file that changed more recently than this may still be being written
+  static const auto s_SettleTime = std::chrono::milliseconds(100);
+
+#ifdef AE_PLATFORM_LINUX
+  static std::string NormalizePath(const std::string& path)
+  {
+    return std::filesystem::absolute(path).lexically_normal().string();
+  }
+
+  static void WatchLoop()
+  {
+    alignas(inotify_event) char buffer[4096];
+    pollfd descriptor = { s_Data->Descriptor, POLLIN, 0 };
+    while (s_Data->Running)
+    {
+      // Wakes up regularly to notice Shutdown()
+      if (poll(&descriptor, 1, 100) <= 0)
+        continue;
+
+      ssize_t length = read(s_Data->Descriptor, buffer, sizeof(buffer));
+      if (length <= 0)
+        continue;
+
+      std::lock_guard<std::mutex> lock(s_Data->Mutex);
+      auto now = Clock::now();
+      for (char* it = buffer; it < buffer + length; it += sizeof(inotify_event) + ((inotify_event*)it)->len)
+      {
+        const inotify_event* event = (const inotify_event*)it;
+        auto directory = s_Data->Directories.find(event->wd);
+        if (event->len == 0 || directory == s_Data->Directories.end())
+          continue;
+
+        std::string path = directory->second + '/' + event->name;
+        if (s_Data->Watches.find(path) != s_Data->Watches.end())
+          s_Data->Changes[path] = now;
+      }
+    }
+  }
+#endif
+
+  void FileWatcher::Init()
+  {
+    AE_CORE_ASSERT(!s_Data, "FileWatcher already initialized!");
+
+#ifdef AE_PLATFORM_LINUX
+    int descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descriptor < 0)
+    {
+      AE_CORE_WARN("FileWatcher: inotify is not available, assets will not be reloaded");
+      return;
+    }
+
+    s_Data = new FileWatcherData();
+    s_Data->Descriptor = descriptor;
+    s_Data->Running = true;
+    s_Data->Thread = std::thread(WatchLoop);
+    AE_CORE_INFO("FileWatcher: assets are reloaded when they change");
+#else
+    AE_CORE_WARN("FileWatcher: not supported on this platform, assets will not be reloaded");
+#endif
+  }
+
+  void FileWatcher::Shutdown()
+  {
+    if (!s_Data)
+      return;
+
+#ifdef AE_PLATFORM_LINUX
+    s_Data->Running = false;
+    s_Data->Thread.join();
+    close(s_Data->Descriptor);
+#endif
+
+    delete s_Data;
+    s_Data = nullptr;
+  }
+
+  uint32_t FileWatcher::Watch(const std::string& path, const std::function<void()>& callback)
+  {
+    if (!s_Data)
+      return 0;
+
+#ifdef AE_PLATFORM_LINUX
+    std::string file = NormalizePath(path);
+    std::string directory = std::filesystem::path(file).parent_path().string();
+
+    std::lock_guard<std::mutex> lock(s_Data->Mutex);
+    if (s_Data->WatchedDirectories.find(directory) == s_Data->WatchedDirectories.end())
+    {
+      int watch = inotify_add_watch(s_Data->Descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+      if (watch < 0)
+      {
+        AE_CORE_WARN("FileWatcher: cannot watch '{0}'", directory);
+        return 0;
+      }
+      s_Data->Directories[watch] = directory;
+      s_Data->WatchedDirectories.insert(directory);
+    }
+
+    uint32_t id = s_Data->NextID++;
+    s_Data->Watches[file].push_back({ id, callback });
+    s_Data->WatchPaths[id] = file;
+    return id;
+#else
+    return 0;
+#endif
+  }
+
+  void FileWatcher::Unwatch(uint32_t id)
+  {
+    if (!s_Data || id == 0)
+      return;
+
+    std::lock_guard<std::mutex> lock(s_Data->Mutex);
+    auto path = s_Data->WatchPaths.find(id);
+    if (path == s_Data->WatchPaths.end())
+      return;
+
+    auto& watches = s_Data->Watches[path->second];
+    watches.erase(std::remove_if(watches.begin(), watches.end(), [id](const FileWatch& watch) { return watch.ID == id; }), watches.end());
+    if (watches.empty())
+      s_Data->Watches.erase(path->second);
+    s_Data->WatchPaths.erase(path);
+  }
+
+  void FileWatcher::Update()
+  {
+    if (!s_Data)
+      return;
+
+    std::vector<uint32_t> ids;
+    {
+      std::lock_guard<std::mutex> lock(s_Data->Mutex);
+      auto now = Clock::now();
+      for (auto it = s_Data->Changes.begin(); it != s_Data->Changes.end(); )
+      {
+        if (now - it->second < s_SettleTime)
+        {
+          ++it;
+          continue;
+        }
+
+        auto watches = s_Data->Watches.find(it->first);
+        if (watches != s_Data->Watches.end())
+        {
+          for (const auto& watch : watches->second)
+            ids.push_back(watch.ID);
+        }
+        it = s_Data->Changes.erase(it);
+      }
+    }
+
+    // Callbacks can add and remove watches, or destroy the owners of other pending callbacks,
+    // so each one is looked up again right before it runs
+    for (uint32_t id : ids)
+    {
+      std::function<void()> callback;
+      {
+        std::lock_guard<std::mutex> lock(s_Data->Mutex);
+        auto path = s_Data->WatchPaths.find(id);
+        if (path == s_Data->WatchPaths.end())
+          continue;
+
+        for (const auto& watch : s_Data->Watches[path->second])
+        {
+          if (watch.ID == id)
+            callback = watch.Callback;
+        }
+      }
+      callback();
+    }
+  }
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+#include <functional>
+
+namespace Ancora {
+
+  // Watches files for changes on a background thread and runs their callbacks from Update(), on
+  // the main thread. A file is reported once it has been quiet for a moment, so an editor writing
+  // it in several steps causes one callback. Uses inotify on Linux; elsewhere nothing is reported.
+  class FileWatcher
+  {
+  public:
+    static void Init();
+    static void Shutdown();
+
+    // Callbacks of the same file run in the order they were added. Safe to call from any thread.
+    // Returns 0, which Unwatch() ignores, when the watcher is not running.
+    static uint32_t Watch(const std::string& path, const std::function<void()>& callback);
+    static void Unwatch(uint32_t id);
+
+    // Runs the callbacks of files that changed. Call once per frame.
+    static void Update();
+  };
+
+}
@@ -0,0 +1,146 @@
+#include "aepch.h"
+#include "JobSystem.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace Ancora {
+
+  struct JobSystemData
+  {
+    std::vector<std::thread> Workers;
+    std::deque<std::function<void()>> Queue;
+    std::mutex QueueMutex;
+    std::condition_variable WakeCondition;
+    bool Running = false;
+  };
+
+  static JobSystemData s_Data;
+
+  static void WorkerLoop()
+  {
+    while (true)
+    {
+      std::function<void()> job;
+      {
+        std::unique_lock<std::mutex> lock(s_Data.QueueMutex);
+        s_Data.WakeCondition.wait(lock, [] { return !s_Data.Running || !s_Data.Queue.empty(); });
+        if (!s_Data.Running && s_Data.Queue.empty())
+          return;
+
+        job = std::move(s_Data.Queue.front());
+        s_Data.Queue.pop_front();
+      }
+
+      job();
+    }
+  }
+
+  void JobSystem::Init(uint32_t threadCount)
+  {
+    AE_CORE_ASSERT(!s_Data.Running, "JobSystem already initialized!");
+
+    if (threadCount == 0)
+    {
+      uint32_t hardwareThreads = std::thread::hardware_concurrency();
+      threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+
+    s_Data.Running = true;
+    for (uint32_t i = 0; i < threadCount; i++)
+      s_Data.Workers.emplace_back(WorkerLoop);
+
+    AE_CORE_INFO("JobSystem: {0} worker threads", threadCount);
+  }
+
+  void JobSystem::Shutdown()
+  {
+    {
+      std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+      s_Data.Running = false;
+    }
+    s_Data.WakeCondition.notify_all();
+
+    for (auto& worker : s_Data.Workers)
+      worker.join();
+    s_Data.Workers.clear();
+  }
+
+  void JobSystem::Execute(const std::function<void()>& job)
+  {
+    if (s_Data.Workers.empty())
+    {
+      job();
+      return;
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(s_Data.QueueMutex);
+      s_Data.Queue.push_back(job);
+    }
+    s_Data.WakeCondition.notify_one();
+  }
+
+  void JobSystem::ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job)
+  {
+    if (count == 0)
+      return;
+
+    if (count == 1 || s_Data.Workers.empty())
+    {
+      for (uint32_t i = 0; i < count; i++)
+        job(i);
+      return;
+    }
+
+    // Items are handed out one at a time through a shared cursor, so uneven work
+    // (one huge mesh among many small ones) still balances across threads.
+    struct Batch
+    {
+      std::function<void(uint32_t)> Job;
+      uint32_t Count;
+      std::atomic<uint32_t> Next{ 0 };
+      std::atomic<uint32_t> Done{ 0 };
+      std::mutex Mutex;
+      std::condition_variable Finished;
+    };
+
+    auto batch = CreateRef<Batch>();
+    batch->Job = job;
+    batch->Count = count;
+
+    auto drain = [batch]()
+    {
+      uint32_t completed = 0;
+      for (uint32_t i = batch->Next++; i < batch->Count; i = batch->Next++)
+      {
+        batch->Job(i);
+        completed++;
+      }
+
+      if (completed && batch->Done.fetch_add(completed) + completed == batch->Count)
+      {
+        std::lock_guard<std::mutex> lock(batch->Mutex);
+        batch->Finished.notify_all();
+      }
+    };
+
+    uint32_t helpers = std::min(count - 1, (uint32_t)s_Data.Workers.size());
+    for (uint32_t i = 0; i < helpers; i++)
+      Execute(drain);
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(batch->Mutex);
+    batch->Finished.wait(lock, [&batch] { return batch->Done == batch->Count; });
+  }
+
+  uint32_t JobSystem::GetThreadCount()
+  {
+    return (uint32_t)s_Data.Workers.size();
+  }
+
+}
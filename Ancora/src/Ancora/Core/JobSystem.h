@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+#include <functional>
+
+namespace Ancora {
+
+  class JobSystem
+  {
+  public:
+    // threadCount = 0 uses one worker per hardware thread, minus the main thread
+    static void Init(uint32_t threadCount = 0);
+    static void Shutdown();
+
+    // Fire-and-forget, runs on any worker
+    static void Execute(const std::function<void()>& job);
+
+    // Runs job(i) for every i in [0, count) and returns once all of them are done.
+    // The calling thread takes part in the work, so this is safe to call from inside a job.
+    static void ParallelFor(uint32_t count, const std::function<void(uint32_t)>& job);
+
+    static uint32_t GetThreadCount();
+  };
+
+}
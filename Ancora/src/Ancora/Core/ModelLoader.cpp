@@ -1,17 +1,44 @@
 #include "aepch.h"
 #include "ModelLoader.h"
 
+#include "Ancora/Core/FileWatcher.h"
+#include "Ancora/Core/JobSystem.h"
+#include "Ancora/Renderer/Image.h"
+#include "Ancora/Renderer/MeshOptimizer.h"
+
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace Ancora {
 
+  // Textures of every loaded model, by path
+  static std::unordered_map<std::string, std::weak_ptr<Texture2D>> s_TextureCache;
+
   Ref<Model3D> ModelLoader::LoadModel(const std::string& filename)
   {
+    Ref<Model3D> model = ImportModel(filename);
+    AE_CORE_ASSERT(model, "Failed to load model '{0}'", filename);
+
+    Model3D* target = model.get();
+    model->m_WatchID = FileWatcher::Watch(filename, [target, filename]() { ReloadModel(*target, filename); });
+    return model;
+  }
+
+  Ref<Model3D> ModelLoader::ImportModel(const std::string& filename)
+  {
+    auto start = std::chrono::steady_clock::now();
+
     Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(filename, aiProcess_Triangulate | aiProcess_FlipUVs);
+    const aiScene* scene = importer.ReadFile(filename, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs);
 
-    AE_CORE_ASSERT(scene && !(scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) && scene->mRootNode, "Assimp Load Error: {0}", importer.GetErrorString());
+    if (!scene || (scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE) || !scene->mRootNode)
+    {
+      AE_CORE_ERROR("Assimp Load Error: {0}", importer.GetErrorString());
+      return nullptr;
+    }
 
     std::string currentDirectory = filename.substr(0, filename.find_last_of('/'));
     std::string modelName = filename.substr(filename.find_last_of('/') + 1, filename.find_last_of('.'));
@@ -19,252 +46,257 @@ namespace Ancora {
     Ref<Model3D> outModel = CreateRef<Model3D>();
     outModel->SetName(modelName);
 
-    ProcessNode(scene->mRootNode, scene, outModel, currentDirectory);
+    // Images that no loaded model uses yet are decoded below
+    std::vector<MaterialTexturePaths> texturePaths(scene->mNumMaterials);
+    std::vector<std::string> imagePaths;
+    std::unordered_set<std::string> requestedPaths;
+    for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+    {
+      texturePaths[i] = GetTexturePaths(scene->mMaterials[i], currentDirectory);
+      for (const auto& path : texturePaths[i])
+      {
+        if (!path.empty() && !s_TextureCache[path].lock() && requestedPaths.insert(path).second)
+          imagePaths.push_back(path);
+      }
+    }
+
+    std::vector<MeshInstance> instances;
+    CollectMeshes(scene, instances);
+    float importTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // Images decode on the workers next to the meshes; only the GL uploads below need the main thread
+    std::vector<Ref<Image>> images(imagePaths.size());
+    std::vector<Mesh> meshes(instances.size());
+    std::vector<MeshOptimizer::Statistics> stats(instances.size());
+    uint32_t itemCount = (uint32_t)(images.size() + meshes.size());
+    std::atomic<uint32_t> completedCount{ 0 };
+
+    JobSystem::ParallelFor(itemCount, [&](uint32_t i)
+    {
+      if (i < images.size())
+        images[i] = Image::Load(imagePaths[i]);
+      else
+      {
+        uint32_t mesh = i - (uint32_t)images.size();
+        ProcessMesh(instances[mesh].Source, instances[mesh].Transform, meshes[mesh]);
+        stats[mesh] = MeshOptimizer::Optimize(meshes[mesh]);
+        MeshOptimizer::GenerateLODs(meshes[mesh]);
+      }
+
+      // Reports every quarter
+      uint32_t completed = ++completedCount;
+      if (completed * 4 / itemCount != (completed - 1) * 4 / itemCount)
+        AE_CORE_TRACE("Loading '{0}': {1}%", modelName, completed * 100 / itemCount);
+    });
+    float convertTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() - importTime;
+
+    // Held until the materials own them, the cache only keeps weak references
+    std::vector<Ref<Texture2D>> textures;
+    for (const auto& image : images)
+    {
+      if (!image)
+        continue;
+
+      textures.push_back(Texture2D::Create(*image));
+      s_TextureCache[image->GetPath()] = textures.back();
+    }
+
+    // Materials are built once per scene material, so meshes that share one share the Material
+    std::vector<Ref<Material>> materials(scene->mNumMaterials);
+    for (uint32_t i = 0; i < scene->mNumMaterials; i++)
+      materials[i] = LoadMaterial(scene->mMaterials[i], texturePaths[i]);
+
+    LogOptimization(meshes, stats);
+    for (uint32_t i = 0; i < meshes.size(); i++)
+    {
+      if (instances[i].Source->mMaterialIndex < materials.size())
+        meshes[i].MeshMaterial = materials[instances[i].Source->mMaterialIndex];
+
+      meshes[i].Upload();
+      outModel->AddMesh(std::move(meshes[i]));
+    }
+    outModel->CalculateBounds();
+
+    float totalTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    AE_CORE_INFO("Loaded '{0}': {1} meshes, {2} new textures in {3:.1f} ms (import {4:.1f} ms, convert {5:.1f} ms, upload {6:.1f} ms)",
+      modelName, meshes.size(), textures.size(), totalTime, importTime, convertTime, totalTime - importTime - convertTime);
+
     return outModel;
   }
 
-  void ModelLoader::ProcessNode(aiNode* node, const aiScene* scene, Ref<Model3D> model, const std::string& currentDirectory)
+  void ModelLoader::ReloadModel(Model3D& model, const std::string& filename)
   {
-    for (uint32_t i = 0; i < node->mNumMeshes; i++)
+    Ref<Model3D> reloaded = ImportModel(filename);
+    if (!reloaded)
     {
-      aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-      model->AddMesh(ProcessMesh(mesh, scene, currentDirectory));
+      AE_CORE_ERROR("Model '{0}' failed to reload, keeping the previous version", filename);
+      return;
     }
 
-    for (uint32_t i = 0; i < node->mNumChildren; i++)
+    model.GetMeshes() = std::move(reloaded->GetMeshes());
+    model.CalculateBounds();
+    AE_CORE_INFO("Reloaded model '{0}'", filename);
+  }
+
+  void ModelLoader::LogOptimization(const std::vector<Mesh>& meshes, const std::vector<MeshOptimizer::Statistics>& stats)
+  {
+    uint32_t verticesBefore = 0, verticesAfter = 0;
+    float missesBefore = 0.0f, missesAfter = 0.0f, triangles = 0.0f;
+    for (uint32_t i = 0; i < meshes.size(); i++)
     {
-      ProcessNode(node->mChildren[i], scene, model, currentDirectory);
+      float meshTriangles = (float)(meshes[i].LODs[0].IndexCount / 3);
+      AE_CORE_TRACE("  Mesh {0}: {1} -> {2} vertices, ACMR {3:.3f} -> {4:.3f}, {5} LODs", i, stats[i].VerticesBefore, stats[i].VerticesAfter, stats[i].ACMRBefore, stats[i].ACMRAfter, meshes[i].LODs.size());
+      for (const auto& lod : meshes[i].LODs)
+        AE_CORE_TRACE("    {0} triangles, error {1:.4f}", lod.IndexCount / 3, lod.Error);
+
+      verticesBefore += stats[i].VerticesBefore;
+      verticesAfter += stats[i].VerticesAfter;
+      missesBefore += stats[i].ACMRBefore * meshTriangles;
+      missesAfter += stats[i].ACMRAfter * meshTriangles;
+      triangles += meshTriangles;
     }
+
+    if (triangles > 0.0f)
+      AE_CORE_INFO("Optimized {0} meshes: {1} -> {2} vertices, ACMR {3:.3f} -> {4:.3f}", meshes.size(), verticesBefore, verticesAfter, missesBefore / triangles, missesAfter / triangles);
   }
 
-  Mesh ModelLoader::ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& currentDirectory)
+  static glm::mat4 ToMat4(const aiMatrix4x4& matrix)
   {
-    Mesh outMesh;
+    // aiMatrix4x4 is row major
+    return glm::mat4(
+      glm::vec4(matrix.a1, matrix.b1, matrix.c1, matrix.d1),
+      glm::vec4(matrix.a2, matrix.b2, matrix.c2, matrix.d2),
+      glm::vec4(matrix.a3, matrix.b3, matrix.c3, matrix.d3),
+      glm::vec4(matrix.a4, matrix.b4, matrix.c4, matrix.d4));
+  }
 
+  void ModelLoader::CollectMeshes(const aiScene* scene, std::vector<MeshInstance>& instances)
+  {
+    // Depth first with an explicit stack, in the same order as the node tree
+    std::vector<std::pair<const aiNode*, glm::mat4>> stack = { { scene->mRootNode, glm::mat4(1.0f) } };
+    while (!stack.empty())
+    {
+      auto [node, parentTransform] = stack.back();
+      stack.pop_back();
+
+      glm::mat4 transform = parentTransform * ToMat4(node->mTransformation);
+      for (uint32_t i = 0; i < node->mNumMeshes; i++)
+        instances.push_back({ scene->mMeshes[node->mMeshes[i]], transform });
+
+      for (uint32_t i = node->mNumChildren; i > 0; i--)
+        stack.push_back({ node->mChildren[i - 1], transform });
+    }
+  }
+
+  void ModelLoader::ProcessMesh(const aiMesh* mesh, const glm::mat4& transform, Mesh& outMesh)
+  {
+    // Node transforms are baked into the vertices, normals go through the inverse transpose
+    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+
+    outMesh.Vertices.resize(mesh->mNumVertices);
     for (uint32_t i = 0; i < mesh->mNumVertices; i++)
     {
-      VertexData3D vertex;
+      VertexData3D& vertex = outMesh.Vertices[i];
+
+      const aiVector3D& position = mesh->mVertices[i];
+      vertex.Position = glm::vec3(transform * glm::vec4(position.x, position.y, position.z, 1.0f));
+
+      // Points and lines have no normals, even with aiProcess_GenSmoothNormals
+      if (mesh->mNormals)
+      {
+        glm::vec3 normal = normalMatrix * glm::vec3(mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z);
+        float length = glm::length(normal);
+        vertex.Normal = length > 0.0f ? normal / length : normal;
+      }
+      else
+        vertex.Normal = { 0.0f, 0.0f, 0.0f };
 
-      vertex.Position = { mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z };
-      vertex.Normal = { mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z };
       // Currently supports only 1 set of texture coordinates per vertex
       if (mesh->mTextureCoords[0])
         vertex.TexCoord = { mesh->mTextureCoords[0][i].x, mesh->mTextureCoords[0][i].y };
       else
         vertex.TexCoord = { 0.0f, 0.0f };
-
-      outMesh.Vertices.push_back(vertex);
     }
 
+    // Points and lines that triangulation leaves behind are dropped
+    outMesh.Indices.resize(mesh->mNumFaces * 3);
+    uint32_t indexCount = 0;
     for (uint32_t i = 0; i < mesh->mNumFaces; i++)
     {
-      aiFace face = mesh->mFaces[i];
-      for (uint32_t j = 0; j < face.mNumIndices; j++)
-        outMesh.Indices.push_back(face.mIndices[j]);
-    }
+      const aiFace& face = mesh->mFaces[i];
+      if (face.mNumIndices != 3)
+        continue;
 
-    if (mesh->mMaterialIndex >= 0)
-    {
-      aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-
-      // AE_CORE_TRACE("Model Texture Info:");
-      // AE_CORE_TRACE("  Diffuse:      {0}", material->GetTextureCount(aiTextureType_DIFFUSE));
-      // AE_CORE_TRACE("  Specular:     {0}", material->GetTextureCount(aiTextureType_SPECULAR));
-      // AE_CORE_TRACE("  Ambient:      {0}", material->GetTextureCount(aiTextureType_AMBIENT));
-      // AE_CORE_TRACE("  Emissive:     {0}", material->GetTextureCount(aiTextureType_EMISSIVE));
-      // AE_CORE_TRACE("  Height:       {0}", material->GetTextureCount(aiTextureType_HEIGHT));
-      // AE_CORE_TRACE("  Normals:      {0}", material->GetTextureCount(aiTextureType_NORMALS));
-      // AE_CORE_TRACE("  Shininess:    {0}", material->GetTextureCount(aiTextureType_SHININESS));
-      // AE_CORE_TRACE("  Opacity:      {0}", material->GetTextureCount(aiTextureType_OPACITY));
-      // AE_CORE_TRACE("  Displacement: {0}", material->GetTextureCount(aiTextureType_DISPLACEMENT));
-      // AE_CORE_TRACE("  Lightmap:     {0}", material->GetTextureCount(aiTextureType_LIGHTMAP));
-      // AE_CORE_TRACE("  Reflection:   {0}", material->GetTextureCount(aiTextureType_REFLECTION));
-      // AE_CORE_TRACE("  Unknown:      {0}", material->GetTextureCount(aiTextureType_UNKNOWN));
-
-      LoadMaterialTexture(material, aiTextureType_DIFFUSE, outMesh.DiffuseTextures, currentDirectory, outMesh);
-      LoadMaterialTexture(material, aiTextureType_SPECULAR, outMesh.SpecularTextures, currentDirectory, outMesh);
+      outMesh.Indices[indexCount++] = face.mIndices[0];
+      outMesh.Indices[indexCount++] = face.mIndices[1];
+      outMesh.Indices[indexCount++] = face.mIndices[2];
     }
-
-    return outMesh;
+    outMesh.Indices.resize(indexCount);
   }
 
-  void ModelLoader::LoadMaterialTexture(aiMaterial* material, aiTextureType type, std::vector<Ref<Texture2D>>& textures, const std::string& currentDirectory, const Mesh& mesh)
+  ModelLoader::MaterialTexturePaths ModelLoader::GetTexturePaths(aiMaterial* material, const std::string& currentDirectory)
   {
-    for (uint32_t i = 0; i < material->GetTextureCount(type); i++)
+    static const std::pair<aiTextureType, MaterialTexture> textureTypes[] = {
+      { aiTextureType_DIFFUSE, MaterialTexture::Diffuse },
+      { aiTextureType_SPECULAR, MaterialTexture::Specular },
+      { aiTextureType_AMBIENT, MaterialTexture::Ambient },
+      { aiTextureType_EMISSIVE, MaterialTexture::Emissive },
+      { aiTextureType_HEIGHT, MaterialTexture::Height },
+      { aiTextureType_NORMALS, MaterialTexture::Normals },
+      { aiTextureType_SHININESS, MaterialTexture::Shininess },
+      { aiTextureType_OPACITY, MaterialTexture::Opacity },
+      { aiTextureType_DISPLACEMENT, MaterialTexture::Displacement },
+      { aiTextureType_LIGHTMAP, MaterialTexture::Lightmap },
+      { aiTextureType_REFLECTION, MaterialTexture::Reflection },
+    };
+
+    // A material has one texture per slot; further textures of the same type are ignored
+    MaterialTexturePaths paths;
+    for (const auto& [type, slot] : textureTypes)
     {
       aiString str;
-      material->GetTexture(type, i, &str);
+      if (material->GetTextureCount(type) == 0 || material->GetTexture(type, 0, &str) != aiReturn_SUCCESS)
+        continue;
+
       std::string filePath = std::string(str.C_Str());
       std::replace(filePath.begin(), filePath.end(), '\\', '/');
-      std::string texPath = currentDirectory + '/' + filePath;
-      AE_CORE_TRACE("{0}", texPath);
+      paths[(uint32_t)slot] = currentDirectory + '/' + filePath;
+    }
+    return paths;
+  }
 
-      bool present = false;
-      switch (type)
-      {
-        case aiTextureType_DIFFUSE:
-        {
-          for (auto& tex : mesh.DiffuseTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_SPECULAR:
-        {
-          for (auto& tex : mesh.SpecularTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_AMBIENT:
-        {
-          for (auto& tex : mesh.AmbientTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_EMISSIVE:
-        {
-          for (auto& tex : mesh.EmissiveTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_HEIGHT:
-        {
-          for (auto& tex : mesh.HeightTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_NORMALS:
-        {
-          for (auto& tex : mesh.NormalsTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_SHININESS:
-        {
-          for (auto& tex : mesh.ShininessTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_OPACITY:
-        {
-          for (auto& tex : mesh.OpacityTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_DISPLACEMENT:
-        {
-          for (auto& tex : mesh.DisplacementTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_LIGHTMAP:
-        {
-          for (auto& tex : mesh.LightmapTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_REFLECTION:
-        {
-          for (auto& tex : mesh.ReflectionTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-
-        case aiTextureType_UNKNOWN:
-        {
-          for (auto& tex : mesh.UnknownTextures)
-          {
-            if (tex->GetName() == texPath)
-            {
-              textures.push_back(tex);
-              present = true;
-              break;
-            }
-          }
-        }
-      }
+  Ref<Material> ModelLoader::LoadMaterial(aiMaterial* material, const MaterialTexturePaths& texturePaths)
+  {
+    Ref<Material> outMaterial = CreateRef<Material>();
 
-      if (!present)
-      {
-        Ref<Texture2D> texture = Texture2D::Create(texPath);
-        textures.push_back(texture);
-      }
+    // Images that failed to load leave their slot empty
+    for (uint32_t slot = 0; slot < texturePaths.size(); slot++)
+    {
+      if (texturePaths[slot].empty())
+        continue;
+
+      if (Ref<Texture2D> texture = s_TextureCache[texturePaths[slot]].lock())
+        outMaterial->SetTexture((MaterialTexture)slot, texture);
     }
+
+    MaterialParameters parameters;
+    aiColor4D color;
+    float value;
+    // Exporters usually write a grey diffuse color next to the texture, which is only used without one
+    if (!outMaterial->GetTexture(MaterialTexture::Diffuse) && material->Get(AI_MATKEY_COLOR_DIFFUSE, color) == aiReturn_SUCCESS)
+      parameters.Color = { color.r, color.g, color.b, 1.0f };
+    if (material->Get(AI_MATKEY_OPACITY, value) == aiReturn_SUCCESS)
+      parameters.Color.a = value;
+    if (material->Get(AI_MATKEY_COLOR_EMISSIVE, color) == aiReturn_SUCCESS)
+      parameters.Emissive = { color.r, color.g, color.b, 1.0f };
+    // The emissive texture is scaled by the emissive color
+    if (outMaterial->GetTexture(MaterialTexture::Emissive) && glm::vec3(parameters.Emissive) == glm::vec3(0.0f))
+      parameters.Emissive = glm::vec4(1.0f);
+    if (material->Get(AI_MATKEY_SHININESS, value) == aiReturn_SUCCESS && value > 0.0f)
+      parameters.Shininess = value;
+    outMaterial->SetParameters(parameters);
+
+    return MaterialLibrary::Register(outMaterial);
   }
 
 }
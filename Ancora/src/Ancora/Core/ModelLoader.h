@@ -2,6 +2,7 @@
 
 #include "Core.h"
 #include "Ancora/Renderer/Model3D.h"
+#include "Ancora/Renderer/MeshOptimizer.h"
 
 #include <assimp/scene.h>
 
@@ -13,11 +14,31 @@ namespace Ancora {
     static void Init();
     static void Shutdown();
 
+    // The model reloads itself in place when the file changes
     static Ref<Model3D> LoadModel(const std::string& filename);
   private:
-    static void ProcessNode(aiNode* node, const aiScene* scene, Ref<Model3D> model, const std::string& currentDirectory);
-    static Mesh ProcessMesh(aiMesh* mesh, const aiScene* scene, const std::string& currentDirectory);
-    static void LoadMaterialTexture(aiMaterial* material, aiTextureType type, std::vector<Ref<Texture2D>>& textures, const std::string& currentDirectory, const Mesh& mesh);
+    // A mesh of the scene with the transform of the node that places it. Meshes placed by several
+    // nodes are converted once per node.
+    struct MeshInstance
+    {
+      const aiMesh* Source;
+      glm::mat4 Transform;
+    };
+    // Path of the texture in every slot of a material, empty for none
+    using MaterialTexturePaths = std::array<std::string, (size_t)MaterialTexture::Count>;
+
+    // Returns null if the file cannot be imported
+    static Ref<Model3D> ImportModel(const std::string& filename);
+    // Keeps the current meshes if the file cannot be imported
+    static void ReloadModel(Model3D& model, const std::string& filename);
+    static void CollectMeshes(const aiScene* scene, std::vector<MeshInstance>& instances);
+    // Thread safe, so meshes are converted in parallel
+    static void ProcessMesh(const aiMesh* mesh, const glm::mat4& transform, Mesh& outMesh);
+    static void LogOptimization(const std::vector<Mesh>& meshes, const std::vector<MeshOptimizer::Statistics>& stats);
+    static MaterialTexturePaths GetTexturePaths(aiMaterial* material, const std::string& currentDirectory);
+    // Textures are shared by path between all models, so a reload only reads the model file.
+    // They have to be in the cache already.
+    static Ref<Material> LoadMaterial(aiMaterial* material, const MaterialTexturePaths& texturePaths);
   };
 
 }
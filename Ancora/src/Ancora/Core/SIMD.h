@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Widest float vector the build targets: AVX when compiled with it (premake5 --avx), SSE2 on
+// any x86-64 build, plain floats otherwise.
+#if defined(__AVX__)
+  #include <immintrin.h>
+  #define AE_SIMD_AVX
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+  #include <emmintrin.h>
+  #define AE_SIMD_SSE
+#endif
+
+namespace Ancora {
+
+  // Kernels are written once against this interface and instantiated with the widest type and
+  // with FloatScalar for the remainder. Comparisons return masks for Select() and the logical
+  // operators; GetMask() has one bit per lane.
+  struct FloatScalar
+  {
+    static constexpr uint32_t Width = 1;
+    float V;
+
+    FloatScalar() = default;
+    FloatScalar(float value) : V(value) {}
+
+    static FloatScalar Load(const float* source) { return *source; }
+    void Store(float* destination) const { *destination = V; }
+
+    friend FloatScalar operator+(FloatScalar a, FloatScalar b) { return a.V + b.V; }
+    friend FloatScalar operator-(FloatScalar a, FloatScalar b) { return a.V - b.V; }
+    friend FloatScalar operator*(FloatScalar a, FloatScalar b) { return a.V * b.V; }
+    friend FloatScalar operator/(FloatScalar a, FloatScalar b) { return a.V / b.V; }
+
+    friend FloatScalar Min(FloatScalar a, FloatScalar b) { return a.V < b.V ? a.V : b.V; }
+    friend FloatScalar Max(FloatScalar a, FloatScalar b) { return a.V > b.V ? a.V : b.V; }
+    friend FloatScalar Abs(FloatScalar a) { return std::fabs(a.V); }
+    friend FloatScalar Sqrt(FloatScalar a) { return std::sqrt(a.V); }
+
+    // Masks are all bits set or zero, as in the vector types
+    static FloatScalar FromBool(bool value) { uint32_t bits = value ? 0xffffffff : 0; FloatScalar result; std::memcpy(&result.V, &bits, 4); return result; }
+    bool IsSet() const { uint32_t bits; std::memcpy(&bits, &V, 4); return bits != 0; }
+
+    friend FloatScalar operator<(FloatScalar a, FloatScalar b) { return FromBool(a.V < b.V); }
+    friend FloatScalar operator>(FloatScalar a, FloatScalar b) { return FromBool(a.V > b.V); }
+    friend FloatScalar operator<=(FloatScalar a, FloatScalar b) { return FromBool(a.V <= b.V); }
+    friend FloatScalar operator&(FloatScalar a, FloatScalar b) { return FromBool(a.IsSet() && b.IsSet()); }
+    friend FloatScalar operator|(FloatScalar a, FloatScalar b) { return FromBool(a.IsSet() || b.IsSet()); }
+    friend FloatScalar Select(FloatScalar mask, FloatScalar a, FloatScalar b) { return mask.IsSet() ? a : b; }
+    uint32_t GetMask() const { return IsSet() ? 1 : 0; }
+  };
+
+#if defined(AE_SIMD_SSE) || defined(AE_SIMD_AVX)
+  struct Float4
+  {
+    static constexpr uint32_t Width = 4;
+    __m128 V;
+
+    Float4() = default;
+    Float4(__m128 value) : V(value) {}
+    Float4(float value) : V(_mm_set1_ps(value)) {}
+
+    static Float4 Load(const float* source) { return _mm_loadu_ps(source); }
+    void Store(float* destination) const { _mm_storeu_ps(destination, V); }
+
+    friend Float4 operator+(Float4 a, Float4 b) { return _mm_add_ps(a.V, b.V); }
+    friend Float4 operator-(Float4 a, Float4 b) { return _mm_sub_ps(a.V, b.V); }
+    friend Float4 operator*(Float4 a, Float4 b) { return _mm_mul_ps(a.V, b.V); }
+    friend Float4 operator/(Float4 a, Float4 b) { return _mm_div_ps(a.V, b.V); }
+
+    friend Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a.V, b.V); }
+    friend Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a.V, b.V); }
+    friend Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a.V); }
+    friend Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a.V); }
+
+    friend Float4 operator<(Float4 a, Float4 b) { return _mm_cmplt_ps(a.V, b.V); }
+    friend Float4 operator>(Float4 a, Float4 b) { return _mm_cmpgt_ps(a.V, b.V); }
+    friend Float4 operator<=(Float4 a, Float4 b) { return _mm_cmple_ps(a.V, b.V); }
+    friend Float4 operator&(Float4 a, Float4 b) { return _mm_and_ps(a.V, b.V); }
+    friend Float4 operator|(Float4 a, Float4 b) { return _mm_or_ps(a.V, b.V); }
+    friend Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask.V, a.V), _mm_andnot_ps(mask.V, b.V)); }
+    uint32_t GetMask() const { return (uint32_t)_mm_movemask_ps(V); }
+  };
+#endif
+
+#if defined(AE_SIMD_AVX)
+  struct Float8
+  {
+    static constexpr uint32_t Width = 8;
+    __m256 V;
+
+    Float8() = default;
+    Float8(__m256 value) : V(value) {}
+    Float8(float value) : V(_mm256_set1_ps(value)) {}
+
+    static Float8 Load(const float* source) { return _mm256_loadu_ps(source); }
+    void Store(float* destination) const { _mm256_storeu_ps(destination, V); }
+
+    friend Float8 operator+(Float8 a, Float8 b) { return _mm256_add_ps(a.V, b.V); }
+    friend Float8 operator-(Float8 a, Float8 b) { return _mm256_sub_ps(a.V, b.V); }
+    friend Float8 operator*(Float8 a, Float8 b) { return _mm256_mul_ps(a.V, b.V); }
+    friend Float8 operator/(Float8 a, Float8 b) { return _mm256_div_ps(a.V, b.V); }
+
+    friend Float8 Min(Float8 a, Float8 b) { return _mm256_min_ps(a.V, b.V); }
+    friend Float8 Max(Float8 a, Float8 b) { return _mm256_max_ps(a.V, b.V); }
+    friend Float8 Abs(Float8 a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.V); }
+    friend Float8 Sqrt(Float8 a) { return _mm256_sqrt_ps(a.V); }
+
+    friend Float8 operator<(Float8 a, Float8 b) { return _mm256_cmp_ps(a.V, b.V, _CMP_LT_OQ); }
+    friend Float8 operator>(Float8 a, Float8 b) { return _mm256_cmp_ps(a.V, b.V, _CMP_GT_OQ); }
+    friend Float8 operator<=(Float8 a, Float8 b) { return _mm256_cmp_ps(a.V, b.V, _CMP_LE_OQ); }
+    friend Float8 operator&(Float8 a, Float8 b) { return _mm256_and_ps(a.V, b.V); }
+    friend Float8 operator|(Float8 a, Float8 b) { return _mm256_or_ps(a.V, b.V); }
+    friend Float8 Select(Float8 mask, Float8 a, Float8 b) { return _mm256_blendv_ps(b.V, a.V, mask.V); }
+    uint32_t GetMask() const { return (uint32_t)_mm256_movemask_ps(V); }
+  };
+
+  using FloatWide = Float8;
+  #define AE_SIMD_NAME "AVX"
+#elif defined(AE_SIMD_SSE)
+  using FloatWide = Float4;
+  #define AE_SIMD_NAME "SSE2"
+#else
+  using FloatWide = FloatScalar;
+  #define AE_SIMD_NAME "scalar"
+#endif
+
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  struct AABB
+  {
+    glm::vec3 Min = glm::vec3(0.0f);
+    glm::vec3 Max = glm::vec3(0.0f);
+
+    AABB() = default;
+    AABB(const glm::vec3& min, const glm::vec3& max)
+      : Min(min), Max(max) {}
+
+    bool Overlaps(const AABB& other) const
+    {
+      return glm::all(glm::lessThanEqual(Min, other.Max)) && glm::all(glm::lessThanEqual(other.Min, Max));
+    }
+
+    bool Contains(const AABB& other) const
+    {
+      return glm::all(glm::lessThanEqual(Min, other.Min)) && glm::all(glm::lessThanEqual(other.Max, Max));
+    }
+
+    AABB Union(const AABB& other) const { return { glm::min(Min, other.Min), glm::max(Max, other.Max) }; }
+    AABB Expanded(float margin) const { return { Min - margin, Max + margin }; }
+
+    // Half the surface area, which is all the tree's cost heuristic needs
+    float GetPerimeter() const
+    {
+      glm::vec3 size = Max - Min;
+      return size.x * size.y + size.y * size.z + size.z * size.x;
+    }
+  };
+
+  struct Ray
+  {
+    glm::vec3 Origin;
+    // Normalized, so hit distances are in world units
+    glm::vec3 Direction;
+    // Precomputed for the slab test; infinite components are handled by it
+    glm::vec3 InverseDirection;
+
+    Ray(const glm::vec3& origin, const glm::vec3& direction)
+      : Origin(origin), Direction(glm::normalize(direction)), InverseDirection(1.0f / Direction) {}
+
+    // Slab test. On a hit, distance is where the ray enters the box, 0 if it starts inside.
+    bool Intersects(const AABB& box, float maxDistance, float& distance) const
+    {
+      glm::vec3 t0 = (box.Min - Origin) * InverseDirection;
+      glm::vec3 t1 = (box.Max - Origin) * InverseDirection;
+      glm::vec3 tMin = glm::min(t0, t1), tMax = glm::max(t0, t1);
+
+      float enter = glm::max(glm::max(tMin.x, tMin.y), glm::max(tMin.z, 0.0f));
+      float exit = glm::min(glm::min(tMax.x, tMax.y), glm::min(tMax.z, maxDistance));
+      distance = enter;
+      return enter <= exit;
+    }
+  };
+
+}
@@ -0,0 +1,309 @@
+#include "aepch.h"
+#include "AABBTree.h"
+
+namespace Ancora {
+
+  AABBTree::AABBTree(float margin)
+    : m_Margin(margin)
+  {
+  }
+
+  const AABBTree::Node& AABBTree::GetLeaf(uint32_t proxy) const
+  {
+    AE_CORE_ASSERT(proxy < m_Nodes.size() && m_Nodes[proxy].Height == 0, "Invalid broadphase proxy!");
+    return m_Nodes[proxy];
+  }
+
+  AABB AABBTree::GetFatBox(const AABB& bounds, const glm::vec3& displacement) const
+  {
+    AABB box = bounds.Expanded(m_Margin);
+    box.Min += glm::min(displacement, glm::vec3(0.0f));
+    box.Max += glm::max(displacement, glm::vec3(0.0f));
+    return box;
+  }
+
+  uint32_t AABBTree::AddProxy(const AABB& bounds, uint32_t userData)
+  {
+    uint32_t leaf = AllocateNode();
+    Node& node = m_Nodes[leaf];
+    node.Box = GetFatBox(bounds, glm::vec3(0.0f));
+    node.Bounds = bounds;
+    node.UserData = userData;
+    node.Height = 0;
+
+    InsertLeaf(leaf);
+    m_ProxyCount++;
+    MarkMoved(leaf);
+    return leaf;
+  }
+
+  void AABBTree::RemoveProxy(uint32_t proxy)
+  {
+    GetLeaf(proxy);
+
+    RemoveLeaf(proxy);
+    FreeNode(proxy);
+    m_ProxyCount--;
+    MarkRemoved(proxy);
+  }
+
+  void AABBTree::MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement)
+  {
+    GetLeaf(proxy);
+
+    Node& node = m_Nodes[proxy];
+    node.Bounds = bounds;
+    MarkMoved(proxy);
+
+    // A fat box that grew while the proxy moved fast is shrunk again once it slows down
+    AABB box = GetFatBox(bounds, displacement);
+    if (node.Box.Contains(bounds) && box.Expanded(4.0f * m_Margin).Contains(node.Box))
+      return;
+
+    RemoveLeaf(proxy);
+    m_Nodes[proxy].Box = box;
+    InsertLeaf(proxy);
+  }
+
+  void AABBTree::Query(const AABB& bounds, const std::function<bool(uint32_t proxy)>& callback) const
+  {
+    if (m_Root == NullNode)
+      return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+      const Node& node = m_Nodes[stack.back()];
+      uint32_t index = stack.back();
+      stack.pop_back();
+
+      if (!node.Box.Overlaps(bounds))
+        continue;
+
+      if (node.IsLeaf())
+      {
+        if (!callback(index))
+          return;
+      }
+      else
+      {
+        stack.push_back(node.Children[0]);
+        stack.push_back(node.Children[1]);
+      }
+    }
+  }
+
+  void AABBTree::RayCast(const Ray& ray, float maxDistance, const std::function<float(uint32_t proxy, float distance)>& callback) const
+  {
+    if (m_Root == NullNode)
+      return;
+
+    std::vector<uint32_t> stack;
+    stack.reserve(64);
+    stack.push_back(m_Root);
+    while (!stack.empty())
+    {
+      const Node& node = m_Nodes[stack.back()];
+      uint32_t index = stack.back();
+      stack.pop_back();
+
+      float distance;
+      if (!ray.Intersects(node.Box, maxDistance, distance))
+        continue;
+
+      if (node.IsLeaf())
+      {
+        // The fat box only says the proxy may be hit
+        if (ray.Intersects(node.Bounds, maxDistance, distance))
+        {
+          maxDistance = callback(index, distance);
+          if (maxDistance <= 0.0f)
+            return;
+        }
+        continue;
+      }
+
+      // The nearer child is popped first
+      float distances[2];
+      bool hits[2];
+      for (int i = 0; i < 2; i++)
+        hits[i] = ray.Intersects(m_Nodes[node.Children[i]].Box, maxDistance, distances[i]);
+
+      int nearer = hits[1] && (!hits[0] || distances[1] < distances[0]) ? 1 : 0;
+      if (hits[1 - nearer])
+        stack.push_back(node.Children[1 - nearer]);
+      if (hits[nearer])
+        stack.push_back(node.Children[nearer]);
+    }
+  }
+
+  uint32_t AABBTree::AllocateNode()
+  {
+    if (m_FreeNodes == NullNode)
+    {
+      m_Nodes.emplace_back();
+      return (uint32_t)m_Nodes.size() - 1;
+    }
+
+    uint32_t node = m_FreeNodes;
+    m_FreeNodes = m_Nodes[node].Parent;
+    m_Nodes[node] = Node();
+    return node;
+  }
+
+  void AABBTree::FreeNode(uint32_t node)
+  {
+    m_Nodes[node].Parent = m_FreeNodes;
+    m_Nodes[node].Height = -1;
+    m_FreeNodes = node;
+  }
+
+  void AABBTree::InsertLeaf(uint32_t leaf)
+  {
+    if (m_Root == NullNode)
+    {
+      m_Root = leaf;
+      m_Nodes[leaf].Parent = NullNode;
+      return;
+    }
+
+    // Descend to the sibling that increases the total surface area of the tree the least
+    const AABB box = m_Nodes[leaf].Box;
+    uint32_t index = m_Root;
+    while (!m_Nodes[index].IsLeaf())
+    {
+      const Node& node = m_Nodes[index];
+      float area = node.Box.GetPerimeter();
+      float combinedArea = node.Box.Union(box).GetPerimeter();
+
+      // Pairing with this node creates a parent for both
+      float cost = 2.0f * combinedArea;
+      // Descending further grows this node's box no matter what
+      float inheritedCost = 2.0f * (combinedArea - area);
+
+      float childCosts[2];
+      for (int i = 0; i < 2; i++)
+      {
+        const Node& child = m_Nodes[node.Children[i]];
+        float childArea = child.Box.Union(box).GetPerimeter();
+        childCosts[i] = (child.IsLeaf() ? childArea : childArea - child.Box.GetPerimeter()) + inheritedCost;
+      }
+
+      if (cost < childCosts[0] && cost < childCosts[1])
+        break;
+
+      index = childCosts[0] < childCosts[1] ? node.Children[0] : node.Children[1];
+    }
+
+    uint32_t sibling = index;
+    uint32_t oldParent = m_Nodes[sibling].Parent;
+    uint32_t newParent = AllocateNode();
+    Node& parent = m_Nodes[newParent];
+    parent.Parent = oldParent;
+    parent.Box = box.Union(m_Nodes[sibling].Box);
+    parent.Height = m_Nodes[sibling].Height + 1;
+    parent.Children[0] = sibling;
+    parent.Children[1] = leaf;
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    if (oldParent == NullNode)
+      m_Root = newParent;
+    else
+      m_Nodes[oldParent].Children[m_Nodes[oldParent].Children[0] == sibling ? 0 : 1] = newParent;
+
+    Refit(m_Nodes[leaf].Parent);
+  }
+
+  void AABBTree::RemoveLeaf(uint32_t leaf)
+  {
+    if (leaf == m_Root)
+    {
+      m_Root = NullNode;
+      return;
+    }
+
+    uint32_t parent = m_Nodes[leaf].Parent;
+    uint32_t grandParent = m_Nodes[parent].Parent;
+    uint32_t sibling = m_Nodes[parent].Children[m_Nodes[parent].Children[0] == leaf ? 1 : 0];
+    FreeNode(parent);
+
+    m_Nodes[sibling].Parent = grandParent;
+    if (grandParent == NullNode)
+    {
+      m_Root = sibling;
+      return;
+    }
+
+    m_Nodes[grandParent].Children[m_Nodes[grandParent].Children[0] == parent ? 0 : 1] = sibling;
+    Refit(grandParent);
+  }
+
+  void AABBTree::Refit(uint32_t index)
+  {
+    while (index != NullNode)
+    {
+      index = Balance(index);
+
+      Node& node = m_Nodes[index];
+      const Node& child0 = m_Nodes[node.Children[0]];
+      const Node& child1 = m_Nodes[node.Children[1]];
+      node.Height = 1 + std::max(child0.Height, child1.Height);
+      node.Box = child0.Box.Union(child1.Box);
+
+      index = node.Parent;
+    }
+  }
+
+  uint32_t AABBTree::Balance(uint32_t a)
+  {
+    Node& nodeA = m_Nodes[a];
+    if (nodeA.IsLeaf() || nodeA.Height < 2)
+      return a;
+
+    // Rotates the higher child of a up into its place, if the heights differ by more than one
+    int32_t balance = m_Nodes[nodeA.Children[1]].Height - m_Nodes[nodeA.Children[0]].Height;
+    if (balance >= -1 && balance <= 1)
+      return a;
+
+    // up is the higher child, which takes a's place; a keeps the lower child and adopts the
+    // lower child of up
+    int upSide = balance > 1 ? 1 : 0;
+    uint32_t up = nodeA.Children[upSide];
+    uint32_t other = nodeA.Children[1 - upSide];
+    Node& nodeUp = m_Nodes[up];
+
+    uint32_t childF = nodeUp.Children[0];
+    uint32_t childG = nodeUp.Children[1];
+    Node& nodeF = m_Nodes[childF];
+    Node& nodeG = m_Nodes[childG];
+
+    nodeUp.Children[0] = a;
+    nodeUp.Parent = nodeA.Parent;
+    nodeA.Parent = up;
+
+    if (nodeUp.Parent == NullNode)
+      m_Root = up;
+    else
+      m_Nodes[nodeUp.Parent].Children[m_Nodes[nodeUp.Parent].Children[0] == a ? 0 : 1] = up;
+
+    // The higher grandchild stays with up
+    bool keepF = nodeF.Height > nodeG.Height;
+    uint32_t kept = keepF ? childF : childG;
+    uint32_t moved = keepF ? childG : childF;
+
+    nodeUp.Children[1] = kept;
+    nodeA.Children[upSide] = moved;
+    m_Nodes[moved].Parent = a;
+
+    const Node& nodeOther = m_Nodes[other];
+    nodeA.Box = nodeOther.Box.Union(m_Nodes[moved].Box);
+    nodeA.Height = 1 + std::max(nodeOther.Height, m_Nodes[moved].Height);
+    nodeUp.Box = nodeA.Box.Union(m_Nodes[kept].Box);
+    nodeUp.Height = 1 + std::max(nodeA.Height, m_Nodes[kept].Height);
+    return up;
+  }
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Broadphase.h"
+
+namespace Ancora {
+
+  // Dynamic bounding volume tree. Leaves hold fat boxes, the proxy's box enlarged by a margin
+  // and the predicted displacement, so a proxy that stays inside its fat box leaves the tree
+  // untouched. Only proxies that leave it are reinserted, refitting and rebalancing the boxes of
+  // their ancestors on the way up. Proxy IDs are leaf node indices.
+  class AABBTree : public Broadphase
+  {
+  public:
+    AABBTree(float margin);
+
+    virtual uint32_t AddProxy(const AABB& bounds, uint32_t userData) override;
+    virtual void RemoveProxy(uint32_t proxy) override;
+    virtual void MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f)) override;
+
+    virtual const AABB& GetBounds(uint32_t proxy) const override { return GetLeaf(proxy).Bounds; }
+    virtual uint32_t GetUserData(uint32_t proxy) const override { return GetLeaf(proxy).UserData; }
+
+    virtual void Query(const AABB& bounds, const std::function<bool(uint32_t proxy)>& callback) const override;
+    virtual void RayCast(const Ray& ray, float maxDistance, const std::function<float(uint32_t proxy, float distance)>& callback) const override;
+
+    // 0 for an empty tree or a single leaf
+    uint32_t GetHeight() const { return m_Root == NullNode ? 0 : (uint32_t)m_Nodes[m_Root].Height; }
+  protected:
+    virtual uint32_t GetProxyCount() const override { return m_ProxyCount; }
+  private:
+    static constexpr uint32_t NullNode = 0xffffffff;
+
+    struct Node
+    {
+      // Fat box for leaves, union of the children otherwise
+      AABB Box;
+      // Leaves only
+      AABB Bounds;
+      uint32_t UserData = 0;
+      // Next free node while the node is free
+      uint32_t Parent = NullNode;
+      uint32_t Children[2] = { NullNode, NullNode };
+      // 0 for leaves, -1 for free nodes
+      int32_t Height = -1;
+
+      bool IsLeaf() const { return Children[0] == NullNode; }
+    };
+
+    const Node& GetLeaf(uint32_t proxy) const;
+    AABB GetFatBox(const AABB& bounds, const glm::vec3& displacement) const;
+
+    uint32_t AllocateNode();
+    void FreeNode(uint32_t node);
+
+    void InsertLeaf(uint32_t leaf);
+    void RemoveLeaf(uint32_t leaf);
+    // Recomputes the boxes and heights from node up to the root, rotating unbalanced nodes
+    void Refit(uint32_t node);
+    // Returns the node that took the place of node
+    uint32_t Balance(uint32_t node);
+  private:
+    std::vector<Node> m_Nodes;
+    uint32_t m_Root = NullNode;
+    uint32_t m_FreeNodes = NullNode;
+    uint32_t m_ProxyCount = 0;
+    float m_Margin;
+  };
+
+}
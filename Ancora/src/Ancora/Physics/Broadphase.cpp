@@ -0,0 +1,89 @@
+#include "aepch.h"
+#include "Broadphase.h"
+
+#include "AABBTree.h"
+#include "SpatialHash.h"
+
+#include <chrono>
+
+namespace Ancora {
+
+  Scope<Broadphase> Broadphase::Create(const BroadphaseSpecification& specification)
+  {
+    switch (specification.Type)
+    {
+      case BroadphaseType::AABBTree:    return CreateScope<AABBTree>(specification.Margin);
+      case BroadphaseType::SpatialHash: return CreateScope<SpatialHash>(specification.CellSize);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown BroadphaseType!");
+    return nullptr;
+  }
+
+  void Broadphase::MarkMoved(uint32_t proxy)
+  {
+    if (proxy >= m_States.size())
+      m_States.resize(proxy + 1, Unchanged);
+
+    // A removed proxy whose ID is reused still has its old pairs dropped
+    if (m_States[proxy] == Unchanged)
+      m_MovedProxies.push_back(proxy);
+    m_States[proxy] = Moved;
+  }
+
+  void Broadphase::MarkRemoved(uint32_t proxy)
+  {
+    if (m_States[proxy] == Unchanged)
+      m_MovedProxies.push_back(proxy);
+    m_States[proxy] = Removed;
+  }
+
+  const std::vector<BroadphasePair>& Broadphase::UpdatePairs()
+  {
+    auto start = std::chrono::steady_clock::now();
+
+    // Pairs between unchanged proxies still overlap
+    m_ProxyPairs.erase(std::remove_if(m_ProxyPairs.begin(), m_ProxyPairs.end(), [this](const std::pair<uint32_t, uint32_t>& pair)
+    {
+      return m_States[pair.first] != Unchanged || m_States[pair.second] != Unchanged;
+    }), m_ProxyPairs.end());
+
+    uint32_t movedCount = 0;
+    for (uint32_t proxy : m_MovedProxies)
+    {
+      if (m_States[proxy] == Removed)
+        continue;
+
+      movedCount++;
+      const AABB& bounds = GetBounds(proxy);
+      Query(bounds, [this, proxy, &bounds](uint32_t other)
+      {
+        // A pair of two moved proxies is added by the query of the lower one
+        if (other == proxy || (m_States[other] == Moved && other < proxy))
+          return true;
+
+        if (bounds.Overlaps(GetBounds(other)))
+          m_ProxyPairs.push_back({ std::min(proxy, other), std::max(proxy, other) });
+        return true;
+      });
+    }
+
+    for (uint32_t proxy : m_MovedProxies)
+      m_States[proxy] = Unchanged;
+    m_MovedProxies.clear();
+
+    std::sort(m_ProxyPairs.begin(), m_ProxyPairs.end());
+
+    m_Pairs.clear();
+    m_Pairs.reserve(m_ProxyPairs.size());
+    for (const auto& [a, b] : m_ProxyPairs)
+      m_Pairs.push_back({ GetUserData(a), GetUserData(b) });
+
+    m_Stats.ProxyCount = GetProxyCount();
+    m_Stats.MovedProxies = movedCount;
+    m_Stats.PairCount = (uint32_t)m_Pairs.size();
+    m_Stats.UpdateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return m_Pairs;
+  }
+
+}
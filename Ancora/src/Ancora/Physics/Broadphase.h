@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+#include "AABB.h"
+
+#include <functional>
+
+namespace Ancora {
+
+  struct BroadphasePair
+  {
+    uint32_t UserDataA;
+    uint32_t UserDataB;
+  };
+
+  enum class BroadphaseType
+  {
+    // Dynamic bounding volume tree; adapts to any distribution of objects
+    AABBTree = 0,
+    // Uniform grid hashed by cell, for objects of similar size spread along a long corridor
+    SpatialHash = 1
+  };
+
+  struct BroadphaseSpecification
+  {
+    BroadphaseType Type = BroadphaseType::AABBTree;
+    // AABBTree: tree boxes are enlarged by this much, so small moves do not touch the tree
+    float Margin = 0.1f;
+    // SpatialHash: edge length of a cell, ideally a bit larger than the typical object
+    float CellSize = 4.0f;
+  };
+
+  // Finds the pairs of objects whose bounding boxes overlap, so only those go through exact
+  // collision tests. Objects are added as proxies carrying user data (an entity index, say),
+  // moved as they move, and UpdatePairs() is called once per fixed step. Pairs of proxies that
+  // did not move since the last step are kept without being tested again.
+  class Broadphase
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t ProxyCount = 0;
+      // Proxies added or moved since the previous step, which were queried for new pairs
+      uint32_t MovedProxies = 0;
+      uint32_t PairCount = 0;
+      float UpdateTime = 0.0f; // ms
+    };
+
+    virtual ~Broadphase() = default;
+
+    // Returns the proxy ID; IDs of removed proxies are reused
+    virtual uint32_t AddProxy(const AABB& bounds, uint32_t userData) = 0;
+    virtual void RemoveProxy(uint32_t proxy) = 0;
+    // displacement is the expected move over the next step, used to predict the tree box
+    virtual void MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f)) = 0;
+
+    virtual const AABB& GetBounds(uint32_t proxy) const = 0;
+    virtual uint32_t GetUserData(uint32_t proxy) const = 0;
+
+    // Calls callback(proxy) for every proxy that may overlap bounds, at least every one that
+    // does; returning false stops the query
+    virtual void Query(const AABB& bounds, const std::function<bool(uint32_t proxy)>& callback) const = 0;
+    // Calls callback(proxy, distance) for proxies whose box the ray enters within maxDistance,
+    // roughly front to back. The callback returns the new maxDistance: its distance argument to
+    // find only the nearest hit, maxDistance to see all of them, 0 to stop.
+    virtual void RayCast(const Ray& ray, float maxDistance, const std::function<float(uint32_t proxy, float distance)>& callback) const = 0;
+
+    // Recomputes the overlapping pairs after the proxies of this step were moved. Each pair is
+    // reported once, in a deterministic order.
+    const std::vector<BroadphasePair>& UpdatePairs();
+    const std::vector<BroadphasePair>& GetPairs() const { return m_Pairs; }
+
+    // Of the last UpdatePairs()
+    const Statistics& GetStats() const { return m_Stats; }
+
+    static Scope<Broadphase> Create(const BroadphaseSpecification& specification = BroadphaseSpecification());
+  protected:
+    virtual uint32_t GetProxyCount() const = 0;
+
+    // Implementations call these so the pairs of the proxy are found again by UpdatePairs()
+    void MarkMoved(uint32_t proxy);
+    void MarkRemoved(uint32_t proxy);
+  private:
+    enum : uint8_t { Unchanged = 0, Moved = 1, Removed = 2 };
+
+    // Indexed by proxy ID
+    std::vector<uint8_t> m_States;
+    std::vector<uint32_t> m_MovedProxies;
+    // Proxy IDs, lower one first
+    std::vector<std::pair<uint32_t, uint32_t>> m_ProxyPairs;
+    std::vector<BroadphasePair> m_Pairs;
+    Statistics m_Stats;
+  };
+
+}
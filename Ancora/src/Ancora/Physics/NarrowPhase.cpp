@@ -0,0 +1,599 @@
+#include "aepch.h"
+#include "NarrowPhase.h"
+
+#include "Ancora/Core/SIMD.h"
+
+namespace Ancora {
+
+  // Keeps the cross product axes of nearly parallel edges from reporting separation
+  static const float s_ParallelEpsilon = 1e-6f;
+  // Edge cross product axes shorter than this are skipped as degenerate, in the single-pair test
+  // and the batched kernel alike
+  static const float s_EdgeAxisEpsilon = 1e-3f;
+
+  void OBBArray::Resize(uint32_t count)
+  {
+    m_Count = count;
+    for (int i = 0; i < 3; i++)
+    {
+      m_Center[i].resize(count);
+      m_HalfExtents[i].resize(count);
+      for (int j = 0; j < 3; j++)
+        m_Axes[i][j].resize(count);
+    }
+  }
+
+  void OBBArray::Set(uint32_t index, const OBB& box)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      m_Center[i][index] = box.Center[i];
+      m_HalfExtents[i][index] = box.HalfExtents[i];
+      for (int j = 0; j < 3; j++)
+        m_Axes[i][j][index] = box.Orientation[i][j];
+    }
+  }
+
+  OBB OBBArray::Get(uint32_t index) const
+  {
+    OBB box;
+    for (int i = 0; i < 3; i++)
+    {
+      box.Center[i] = m_Center[i][index];
+      box.HalfExtents[i] = m_HalfExtents[i][index];
+      for (int j = 0; j < 3; j++)
+        box.Orientation[i][j] = m_Axes[i][j][index];
+    }
+    return box;
+  }
+
+  void CapsuleArray::Resize(uint32_t count)
+  {
+    m_Count = count;
+    for (int i = 0; i < 3; i++)
+    {
+      m_A[i].resize(count);
+      m_B[i].resize(count);
+    }
+    m_Radii.resize(count);
+  }
+
+  void CapsuleArray::Set(uint32_t index, const Capsule& capsule)
+  {
+    for (int i = 0; i < 3; i++)
+    {
+      m_A[i][index] = capsule.A[i];
+      m_B[i][index] = capsule.B[i];
+    }
+    m_Radii[index] = capsule.Radius;
+  }
+
+  Capsule CapsuleArray::Get(uint32_t index) const
+  {
+    Capsule capsule;
+    for (int i = 0; i < 3; i++)
+    {
+      capsule.A[i] = m_A[i][index];
+      capsule.B[i] = m_B[i][index];
+    }
+    capsule.Radius = m_Radii[index];
+    return capsule;
+  }
+
+  // Closest points between segments p1q1 and p2q2, as parameters s and t along them
+  // (Ericson, Real-Time Collision Detection 5.1.9)
+  static void ClosestPointsSegmentSegment(const glm::vec3& p1, const glm::vec3& q1, const glm::vec3& p2, const glm::vec3& q2, float& s, float& t)
+  {
+    glm::vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    float a = glm::dot(d1, d1), e = glm::dot(d2, d2), f = glm::dot(d2, r);
+
+    if (a <= s_ParallelEpsilon && e <= s_ParallelEpsilon)
+    {
+      s = t = 0.0f;
+      return;
+    }
+    if (a <= s_ParallelEpsilon)
+    {
+      s = 0.0f;
+      t = glm::clamp(f / e, 0.0f, 1.0f);
+      return;
+    }
+
+    float c = glm::dot(d1, r);
+    if (e <= s_ParallelEpsilon)
+    {
+      t = 0.0f;
+      s = glm::clamp(-c / a, 0.0f, 1.0f);
+      return;
+    }
+
+    float b = glm::dot(d1, d2);
+    float denominator = a * e - b * b;
+    s = denominator != 0.0f ? glm::clamp((b * f - c * e) / denominator, 0.0f, 1.0f) : 0.0f;
+    t = (b * s + f) / e;
+    if (t < 0.0f)
+    {
+      t = 0.0f;
+      s = glm::clamp(-c / a, 0.0f, 1.0f);
+    }
+    else if (t > 1.0f)
+    {
+      t = 1.0f;
+      s = glm::clamp((b - c) / a, 0.0f, 1.0f);
+    }
+  }
+
+  static glm::vec3 ClosestPointOnSegment(const glm::vec3& a, const glm::vec3& b, const glm::vec3& point)
+  {
+    glm::vec3 segment = b - a;
+    float length2 = glm::dot(segment, segment);
+    float t = length2 > s_ParallelEpsilon ? glm::clamp(glm::dot(point - a, segment) / length2, 0.0f, 1.0f) : 0.0f;
+    return a + segment * t;
+  }
+
+  // Any unit vector perpendicular to direction
+  static glm::vec3 GetPerpendicular(const glm::vec3& direction)
+  {
+    glm::vec3 other = std::fabs(direction.x) < 0.9f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    return glm::normalize(glm::cross(direction, other));
+  }
+
+  bool NarrowPhase::Collide(const OBB& a, const OBB& b, Contact& contact)
+  {
+    // b's axes and offset in a's frame (Ericson 4.4.1)
+    float r[3][3], absR[3][3];
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        r[i][j] = glm::dot(a.Orientation[i], b.Orientation[j]);
+        absR[i][j] = std::fabs(r[i][j]) + s_ParallelEpsilon;
+      }
+    }
+
+    glm::vec3 offset = b.Center - a.Center;
+    glm::vec3 t = { glm::dot(offset, a.Orientation[0]), glm::dot(offset, a.Orientation[1]), glm::dot(offset, a.Orientation[2]) };
+
+    // The axis of least overlap becomes the contact normal. Edge axes have to be clearly better
+    // than face axes, which give steadier contacts.
+    float minOverlap = std::numeric_limits<float>::max();
+    glm::vec3 normal;
+    auto testAxis = [&](float ra, float rb, float distance, const glm::vec3& axis, float scale, float bias)
+    {
+      float overlap = ra + rb - std::fabs(distance);
+      if (overlap < 0.0f)
+        return false;
+
+      overlap /= scale;
+      if (overlap * bias < minOverlap)
+      {
+        minOverlap = overlap;
+        normal = distance < 0.0f ? -axis : axis;
+      }
+      return true;
+    };
+
+    for (int i = 0; i < 3; i++)
+    {
+      float rb = b.HalfExtents[0] * absR[i][0] + b.HalfExtents[1] * absR[i][1] + b.HalfExtents[2] * absR[i][2];
+      if (!testAxis(a.HalfExtents[i], rb, t[i], a.Orientation[i], 1.0f, 1.0f))
+        return false;
+    }
+
+    for (int j = 0; j < 3; j++)
+    {
+      float ra = a.HalfExtents[0] * absR[0][j] + a.HalfExtents[1] * absR[1][j] + a.HalfExtents[2] * absR[2][j];
+      float distance = t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j];
+      if (!testAxis(ra, b.HalfExtents[j], distance, b.Orientation[j], 1.0f, 1.0f))
+        return false;
+    }
+
+    for (int i = 0; i < 3; i++)
+    {
+      int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+      for (int j = 0; j < 3; j++)
+      {
+        int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        float ra = a.HalfExtents[i1] * absR[i2][j] + a.HalfExtents[i2] * absR[i1][j];
+        float rb = b.HalfExtents[j1] * absR[i][j2] + b.HalfExtents[j2] * absR[i][j1];
+        float distance = t[i2] * r[i1][j] - t[i1] * r[i2][j];
+
+        // Parallel edges: the axis is degenerate and the face axes decide. The axes are unit
+        // length, so the cross product's squared length is 1 - r^2.
+        if (1.0f - r[i][j] * r[i][j] < s_EdgeAxisEpsilon * s_EdgeAxisEpsilon)
+          continue;
+
+        glm::vec3 axis = glm::cross(a.Orientation[i], b.Orientation[j]);
+        float length = glm::length(axis);
+
+        if (!testAxis(ra, rb, distance, axis / length, length, 1.05f))
+          return false;
+      }
+    }
+
+    contact.Normal = normal;
+    contact.Depth = minOverlap;
+    // Vertex of b furthest against the normal
+    contact.Point = b.Center;
+    for (int j = 0; j < 3; j++)
+      contact.Point -= b.Orientation[j] * (glm::dot(b.Orientation[j], normal) > 0.0f ? b.HalfExtents[j] : -b.HalfExtents[j]);
+    return true;
+  }
+
+  bool NarrowPhase::Collide(const Capsule& a, const Capsule& b, Contact& contact)
+  {
+    float s, t;
+    ClosestPointsSegmentSegment(a.A, a.B, b.A, b.B, s, t);
+    glm::vec3 pointA = a.A + (a.B - a.A) * s;
+    glm::vec3 pointB = b.A + (b.B - b.A) * t;
+
+    glm::vec3 direction = pointB - pointA;
+    float distance = glm::length(direction);
+    float radius = a.Radius + b.Radius;
+    if (distance >= radius)
+      return false;
+
+    // Crossing segments have no preferred direction
+    if (distance > s_ParallelEpsilon)
+      contact.Normal = direction / distance;
+    else
+      contact.Normal = GetPerpendicular(glm::length(a.B - a.A) > s_ParallelEpsilon ? glm::normalize(a.B - a.A) : glm::vec3(0.0f, 1.0f, 0.0f));
+
+    contact.Depth = radius - distance;
+    contact.Point = pointB - contact.Normal * b.Radius;
+    return true;
+  }
+
+  bool NarrowPhase::Collide(const Capsule& a, const OBB& b, Contact& contact)
+  {
+    // In the box's frame, where the closest point of the box is a clamp
+    glm::mat3 toLocal = glm::transpose(b.Orientation);
+    glm::vec3 start = toLocal * (a.A - b.Center);
+    glm::vec3 end = toLocal * (a.B - b.Center);
+
+    auto distance2 = [&b](const glm::vec3& point)
+    {
+      glm::vec3 outside = point - glm::clamp(point, -b.HalfExtents, b.HalfExtents);
+      return glm::dot(outside, outside);
+    };
+
+    // The squared distance to a convex box is convex along the segment, so a golden section
+    // search finds its minimum
+    const float ratio = 0.618034f;
+    float low = 0.0f, high = 1.0f;
+    float t1 = high - ratio * (high - low), t2 = low + ratio * (high - low);
+    float d1 = distance2(glm::mix(start, end, t1)), d2 = distance2(glm::mix(start, end, t2));
+    for (int i = 0; i < 24; i++)
+    {
+      if (d1 < d2)
+      {
+        high = t2; t2 = t1; d2 = d1;
+        t1 = high - ratio * (high - low);
+        d1 = distance2(glm::mix(start, end, t1));
+      }
+      else
+      {
+        low = t1; t1 = t2; d1 = d2;
+        t2 = low + ratio * (high - low);
+        d2 = distance2(glm::mix(start, end, t2));
+      }
+    }
+
+    // The ends are not sampled by the search
+    float t = 0.5f * (low + high);
+    float best = distance2(glm::mix(start, end, t));
+    if (distance2(start) < best) { t = 0.0f; best = distance2(start); }
+    if (distance2(end) < best) { t = 1.0f; best = distance2(end); }
+
+    if (best >= a.Radius * a.Radius)
+      return false;
+
+    glm::vec3 point = glm::mix(start, end, t);
+    glm::vec3 closest = glm::clamp(point, -b.HalfExtents, b.HalfExtents);
+    glm::vec3 localNormal;
+    if (best > s_ParallelEpsilon)
+    {
+      float distance = std::sqrt(best);
+      localNormal = (closest - point) / distance;
+      contact.Depth = a.Radius - distance;
+    }
+    else
+    {
+      // The segment is inside the box: push out through the nearest face
+      int axis = 0;
+      float nearest = std::numeric_limits<float>::max();
+      for (int i = 0; i < 3; i++)
+      {
+        float toFace = b.HalfExtents[i] - std::fabs(point[i]);
+        if (toFace < nearest)
+        {
+          nearest = toFace;
+          axis = i;
+        }
+      }
+      localNormal = glm::vec3(0.0f);
+      localNormal[axis] = point[axis] < 0.0f ? 1.0f : -1.0f;
+      contact.Depth = a.Radius + nearest;
+    }
+
+    contact.Normal = b.Orientation * localNormal;
+    contact.Point = b.Center + b.Orientation * closest;
+    return true;
+  }
+
+  bool NarrowPhase::RayCast(const Ray& ray, const OBB& box, float maxDistance, RayHit& hit)
+  {
+    glm::vec3 offset = ray.Origin - box.Center;
+    float enter = 0.0f, exit = maxDistance;
+    glm::vec3 normal = -ray.Direction;
+    for (int i = 0; i < 3; i++)
+    {
+      const glm::vec3& axis = box.Orientation[i];
+      float origin = glm::dot(offset, axis);
+      float direction = glm::dot(ray.Direction, axis);
+      if (std::fabs(direction) < s_ParallelEpsilon)
+      {
+        if (std::fabs(origin) > box.HalfExtents[i])
+          return false;
+        continue;
+      }
+
+      float t1 = (-box.HalfExtents[i] - origin) / direction;
+      float t2 = (box.HalfExtents[i] - origin) / direction;
+      // Entering through the face that faces the ray
+      float sign = -1.0f;
+      if (t1 > t2)
+      {
+        std::swap(t1, t2);
+        sign = 1.0f;
+      }
+
+      if (t1 > enter)
+      {
+        enter = t1;
+        normal = axis * sign;
+      }
+      exit = std::min(exit, t2);
+      if (enter > exit)
+        return false;
+    }
+
+    hit.Distance = enter;
+    hit.Normal = normal;
+    return true;
+  }
+
+  bool NarrowPhase::RayCast(const Ray& ray, const Capsule& capsule, float maxDistance, RayHit& hit)
+  {
+    float radius2 = capsule.Radius * capsule.Radius;
+    glm::vec3 closest = ClosestPointOnSegment(capsule.A, capsule.B, ray.Origin);
+    if (glm::dot(ray.Origin - closest, ray.Origin - closest) <= radius2)
+    {
+      hit.Distance = 0.0f;
+      hit.Normal = -ray.Direction;
+      return true;
+    }
+
+    float nearest = std::numeric_limits<float>::max();
+    auto raySphere = [&](const glm::vec3& center)
+    {
+      glm::vec3 m = ray.Origin - center;
+      float b = glm::dot(m, ray.Direction);
+      float discriminant = b * b - (glm::dot(m, m) - radius2);
+      if (discriminant >= 0.0f)
+      {
+        float t = -b - std::sqrt(discriminant);
+        if (t >= 0.0f)
+          nearest = std::min(nearest, t);
+      }
+    };
+    raySphere(capsule.A);
+    raySphere(capsule.B);
+
+    // The cylinder between the caps, with the axis projected out
+    glm::vec3 segment = capsule.B - capsule.A;
+    float length = glm::length(segment);
+    if (length > s_ParallelEpsilon)
+    {
+      glm::vec3 axis = segment / length;
+      glm::vec3 m = ray.Origin - capsule.A;
+      glm::vec3 direction = ray.Direction - axis * glm::dot(ray.Direction, axis);
+      glm::vec3 offset = m - axis * glm::dot(m, axis);
+
+      float a = glm::dot(direction, direction);
+      float b = glm::dot(offset, direction);
+      float discriminant = b * b - a * (glm::dot(offset, offset) - radius2);
+      if (a > s_ParallelEpsilon && discriminant >= 0.0f)
+      {
+        float t = (-b - std::sqrt(discriminant)) / a;
+        float height = glm::dot(m, axis) + t * glm::dot(ray.Direction, axis);
+        if (t >= 0.0f && height >= 0.0f && height <= length)
+          nearest = std::min(nearest, t);
+      }
+    }
+
+    if (nearest > maxDistance)
+      return false;
+
+    glm::vec3 point = ray.Origin + ray.Direction * nearest;
+    hit.Distance = nearest;
+    hit.Normal = glm::normalize(point - ClosestPointOnSegment(capsule.A, capsule.B, point));
+    return true;
+  }
+
+  // Batched kernels. F is FloatWide for full groups of pairs and FloatScalar for the rest, so
+  // both run the same arithmetic.
+
+  template<typename F>
+  static void TestOBBsKernel(const OBBArray& a, const OBBArray& b, uint32_t index, uint8_t* overlaps)
+  {
+    F aAxes[3][3], bAxes[3][3], aExtents[3], bExtents[3], offset[3];
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        aAxes[i][j] = F::Load(a.GetAxis(i, j) + index);
+        bAxes[i][j] = F::Load(b.GetAxis(i, j) + index);
+      }
+      aExtents[i] = F::Load(a.GetHalfExtents(i) + index);
+      bExtents[i] = F::Load(b.GetHalfExtents(i) + index);
+      offset[i] = F::Load(b.GetCenter(i) + index) - F::Load(a.GetCenter(i) + index);
+    }
+
+    F r[3][3], absR[3][3], t[3];
+    for (int i = 0; i < 3; i++)
+    {
+      for (int j = 0; j < 3; j++)
+      {
+        r[i][j] = aAxes[i][0] * bAxes[j][0] + aAxes[i][1] * bAxes[j][1] + aAxes[i][2] * bAxes[j][2];
+        absR[i][j] = Abs(r[i][j]) + F(s_ParallelEpsilon);
+      }
+      t[i] = offset[0] * aAxes[i][0] + offset[1] * aAxes[i][1] + offset[2] * aAxes[i][2];
+    }
+
+    // All 15 axes are tested; a lane is separated if any of them separates it
+    F separated = F(0.0f) < F(0.0f);
+    for (int i = 0; i < 3; i++)
+    {
+      F rb = bExtents[0] * absR[i][0] + bExtents[1] * absR[i][1] + bExtents[2] * absR[i][2];
+      separated = separated | (aExtents[i] + rb < Abs(t[i]));
+    }
+
+    for (int j = 0; j < 3; j++)
+    {
+      F ra = aExtents[0] * absR[0][j] + aExtents[1] * absR[1][j] + aExtents[2] * absR[2][j];
+      separated = separated | (ra + bExtents[j] < Abs(t[0] * r[0][j] + t[1] * r[1][j] + t[2] * r[2][j]));
+    }
+
+    // Degenerate edge axes are skipped as in the single-pair test
+    const F notSeparated = F(0.0f) < F(0.0f);
+    const F degenerateLength2 = F(s_EdgeAxisEpsilon * s_EdgeAxisEpsilon);
+    for (int i = 0; i < 3; i++)
+    {
+      int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+      for (int j = 0; j < 3; j++)
+      {
+        int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+        F ra = aExtents[i1] * absR[i2][j] + aExtents[i2] * absR[i1][j];
+        F rb = bExtents[j1] * absR[i][j2] + bExtents[j2] * absR[i][j1];
+        F degenerate = F(1.0f) - r[i][j] * r[i][j] < degenerateLength2;
+        separated = separated | Select(degenerate, notSeparated, ra + rb < Abs(t[i2] * r[i1][j] - t[i1] * r[i2][j]));
+      }
+    }
+
+    uint32_t mask = separated.GetMask();
+    for (uint32_t lane = 0; lane < F::Width; lane++)
+      overlaps[index + lane] = (mask >> lane) & 1 ? 0 : 1;
+  }
+
+  template<typename F>
+  static F Clamp01(F value) { return Min(Max(value, F(0.0f)), F(1.0f)); }
+
+  template<typename F>
+  static void GetCapsuleSeparationsKernel(const CapsuleArray& a, const CapsuleArray& b, uint32_t index, float* separations)
+  {
+    F p1[3], d1[3], p2[3], d2[3], r[3];
+    for (int i = 0; i < 3; i++)
+    {
+      p1[i] = F::Load(a.GetA(i) + index);
+      d1[i] = F::Load(a.GetB(i) + index) - p1[i];
+      p2[i] = F::Load(b.GetA(i) + index);
+      d2[i] = F::Load(b.GetB(i) + index) - p2[i];
+      r[i] = p1[i] - p2[i];
+    }
+
+    auto dot = [](const F* x, const F* y) { return x[0] * y[0] + x[1] * y[1] + x[2] * y[2]; };
+    F a2 = dot(d1, d1), e = dot(d2, d2), f = dot(d2, r), c = dot(d1, r), b2 = dot(d1, d2);
+
+    // ClosestPointsSegmentSegment() with its branches turned into selects
+    const F epsilon = F(s_ParallelEpsilon);
+    F safeA = Max(a2, epsilon), safeE = Max(e, epsilon);
+    F denominator = a2 * e - b2 * b2;
+    F s = Select(epsilon < denominator, Clamp01((b2 * f - c * e) / Max(denominator, epsilon)), F(0.0f));
+    F t = (b2 * s + f) / safeE;
+    F sAtStart = Clamp01((F(0.0f) - c) / safeA);
+    F sAtEnd = Clamp01((b2 - c) / safeA);
+    s = Select(t < F(0.0f), sAtStart, Select(F(1.0f) < t, sAtEnd, s));
+    t = Clamp01(t);
+
+    // Degenerate segments: a point against a segment
+    F pointA = a2 <= epsilon, pointB = e <= epsilon;
+    s = Select(pointA, F(0.0f), Select(pointB, sAtStart, s));
+    t = Select(pointA, Clamp01(f / safeE), Select(pointB, F(0.0f), t));
+
+    F distance2 = F(0.0f);
+    for (int i = 0; i < 3; i++)
+    {
+      F difference = (p1[i] + d1[i] * s) - (p2[i] + d2[i] * t);
+      distance2 = distance2 + difference * difference;
+    }
+
+    F separation = Sqrt(distance2) - F::Load(a.GetRadii() + index) - F::Load(b.GetRadii() + index);
+    separation.Store(separations + index);
+  }
+
+  template<typename F>
+  static void RayCastOBBsKernel(const Ray& ray, const OBBArray& boxes, float maxDistance, uint32_t index, float* distances)
+  {
+    F offset[3];
+    for (int i = 0; i < 3; i++)
+      offset[i] = F(ray.Origin[i]) - F::Load(boxes.GetCenter(i) + index);
+
+    // Slab test in each box's frame; axis-parallel rays divide to infinities, which the slab
+    // test handles
+    F enter = F(0.0f), exit = F(maxDistance);
+    for (int i = 0; i < 3; i++)
+    {
+      F axis[3] = { F::Load(boxes.GetAxis(i, 0) + index), F::Load(boxes.GetAxis(i, 1) + index), F::Load(boxes.GetAxis(i, 2) + index) };
+      F origin = offset[0] * axis[0] + offset[1] * axis[1] + offset[2] * axis[2];
+      F direction = F(ray.Direction.x) * axis[0] + F(ray.Direction.y) * axis[1] + F(ray.Direction.z) * axis[2];
+      F inverse = F(1.0f) / direction;
+      F extent = F::Load(boxes.GetHalfExtents(i) + index);
+
+      F t1 = (F(0.0f) - extent - origin) * inverse;
+      F t2 = (extent - origin) * inverse;
+      enter = Max(enter, Min(t1, t2));
+      exit = Min(exit, Max(t1, t2));
+    }
+
+    Select(enter <= exit, enter, F(std::numeric_limits<float>::infinity())).Store(distances + index);
+  }
+
+  // Runs the wide kernel over full groups, the scalar one over the rest
+  template<typename Kernel>
+  static void RunBatched(uint32_t count, const Kernel& kernel)
+  {
+    uint32_t index = 0;
+    for (; index + FloatWide::Width <= count; index += FloatWide::Width)
+      kernel(FloatWide(), index);
+    for (; index < count; index++)
+      kernel(FloatScalar(), index);
+  }
+
+  void NarrowPhase::TestOBBs(const OBBArray& a, const OBBArray& b, uint8_t* overlaps)
+  {
+    AE_CORE_ASSERT(a.GetCount() == b.GetCount(), "Pairs need as many boxes on both sides!");
+    RunBatched(a.GetCount(), [&](auto type, uint32_t index)
+    {
+      TestOBBsKernel<decltype(type)>(a, b, index, overlaps);
+    });
+  }
+
+  void NarrowPhase::GetCapsuleSeparations(const CapsuleArray& a, const CapsuleArray& b, float* separations)
+  {
+    AE_CORE_ASSERT(a.GetCount() == b.GetCount(), "Pairs need as many capsules on both sides!");
+    RunBatched(a.GetCount(), [&](auto type, uint32_t index)
+    {
+      GetCapsuleSeparationsKernel<decltype(type)>(a, b, index, separations);
+    });
+  }
+
+  void NarrowPhase::RayCastOBBs(const Ray& ray, const OBBArray& boxes, float maxDistance, float* distances)
+  {
+    RunBatched(boxes.GetCount(), [&](auto type, uint32_t index)
+    {
+      RayCastOBBsKernel<decltype(type)>(ray, boxes, maxDistance, index, distances);
+    });
+  }
+
+}
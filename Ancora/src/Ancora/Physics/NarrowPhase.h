@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+#include "AABB.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Oriented bounding box
+  struct OBB
+  {
+    glm::vec3 Center = glm::vec3(0.0f);
+    // Columns are the box's unit axes
+    glm::mat3 Orientation = glm::mat3(1.0f);
+    glm::vec3 HalfExtents = glm::vec3(0.5f);
+  };
+
+  // Segment from A to B swept by a sphere
+  struct Capsule
+  {
+    glm::vec3 A = glm::vec3(0.0f);
+    glm::vec3 B = glm::vec3(0.0f);
+    float Radius = 0.5f;
+  };
+
+  struct Contact
+  {
+    // From the first shape towards the second
+    glm::vec3 Normal;
+    float Depth;
+    // On the second shape, roughly where it is deepest in the first
+    glm::vec3 Point;
+  };
+
+  struct RayHit
+  {
+    float Distance;
+    glm::vec3 Normal;
+  };
+
+  // Shapes as structure of arrays, for the batched tests. Every array has the same count.
+  class OBBArray
+  {
+  public:
+    void Resize(uint32_t count);
+    uint32_t GetCount() const { return m_Count; }
+
+    void Set(uint32_t index, const OBB& box);
+    OBB Get(uint32_t index) const;
+
+    const float* GetCenter(int component) const { return m_Center[component].data(); }
+    // Component of one of the box's axes
+    const float* GetAxis(int axis, int component) const { return m_Axes[axis][component].data(); }
+    const float* GetHalfExtents(int axis) const { return m_HalfExtents[axis].data(); }
+  private:
+    uint32_t m_Count = 0;
+    std::vector<float> m_Center[3];
+    std::vector<float> m_Axes[3][3];
+    std::vector<float> m_HalfExtents[3];
+  };
+
+  class CapsuleArray
+  {
+  public:
+    void Resize(uint32_t count);
+    uint32_t GetCount() const { return m_Count; }
+
+    void Set(uint32_t index, const Capsule& capsule);
+    Capsule Get(uint32_t index) const;
+
+    const float* GetA(int component) const { return m_A[component].data(); }
+    const float* GetB(int component) const { return m_B[component].data(); }
+    const float* GetRadii() const { return m_Radii.data(); }
+  private:
+    uint32_t m_Count = 0;
+    std::vector<float> m_A[3];
+    std::vector<float> m_B[3];
+    std::vector<float> m_Radii;
+  };
+
+  // Exact collision tests for the pairs the Broadphase reports. The single-pair tests also
+  // produce contacts and are the reference for the batched ones, which test pair i = (a[i], b[i])
+  // of two arrays, eight pairs at a time with AVX and four with SSE2 (see Core/SIMD.h).
+  class NarrowPhase
+  {
+  public:
+    // Separating axis test over the 15 candidate axes
+    static bool Collide(const OBB& a, const OBB& b, Contact& contact);
+    static bool Collide(const Capsule& a, const Capsule& b, Contact& contact);
+    static bool Collide(const Capsule& a, const OBB& b, Contact& contact);
+
+    // Rays starting inside a shape hit it at distance 0, facing back along the ray
+    static bool RayCast(const Ray& ray, const OBB& box, float maxDistance, RayHit& hit);
+    static bool RayCast(const Ray& ray, const Capsule& capsule, float maxDistance, RayHit& hit);
+
+    // overlaps[i] is 1 if the boxes of pair i overlap, 0 otherwise
+    static void TestOBBs(const OBBArray& a, const OBBArray& b, uint8_t* overlaps);
+    // Distance between the capsules of pair i, negative while they penetrate
+    static void GetCapsuleSeparations(const CapsuleArray& a, const CapsuleArray& b, float* separations);
+    // Distance along the ray to each box, infinity if it misses within maxDistance
+    static void RayCastOBBs(const Ray& ray, const OBBArray& boxes, float maxDistance, float* distances);
+  };
+
+}
@@ -0,0 +1,214 @@
+#include "aepch.h"
+#include "SpatialHash.h"
+
+namespace Ancora {
+
+  SpatialHash::SpatialHash(float cellSize)
+    : m_CellSize(cellSize), m_Extent(glm::vec3(std::numeric_limits<float>::max()), glm::vec3(-std::numeric_limits<float>::max()))
+  {
+    AE_CORE_ASSERT(cellSize > 0.0f, "Cell size must be positive!");
+  }
+
+  const SpatialHash::Proxy& SpatialHash::GetProxy(uint32_t proxy) const
+  {
+    AE_CORE_ASSERT(proxy < m_Proxies.size() && m_Proxies[proxy].Active, "Invalid broadphase proxy!");
+    return m_Proxies[proxy];
+  }
+
+  glm::ivec3 SpatialHash::GetCell(const glm::vec3& position) const
+  {
+    glm::vec3 cell = glm::floor(position / m_CellSize);
+    return { (int)cell.x, (int)cell.y, (int)cell.z };
+  }
+
+  uint64_t SpatialHash::GetKey(const glm::ivec3& cell)
+  {
+    // 21 bits per axis; cells that far apart may share a key, which only costs extra candidates
+    return ((uint64_t)(cell.x & 0x1fffff) << 42) | ((uint64_t)(cell.y & 0x1fffff) << 21) | (uint64_t)(cell.z & 0x1fffff);
+  }
+
+  uint32_t SpatialHash::AddProxy(const AABB& bounds, uint32_t userData)
+  {
+    uint32_t proxy;
+    if (m_FreeProxies.empty())
+    {
+      proxy = (uint32_t)m_Proxies.size();
+      m_Proxies.emplace_back();
+    }
+    else
+    {
+      proxy = m_FreeProxies.back();
+      m_FreeProxies.pop_back();
+    }
+
+    Proxy& data = m_Proxies[proxy];
+    data.Bounds = bounds;
+    data.UserData = userData;
+    data.MinCell = GetCell(bounds.Min);
+    data.MaxCell = GetCell(bounds.Max);
+    data.Active = true;
+    InsertIntoCells(proxy);
+
+    m_Extent = m_Extent.Union(bounds);
+    m_ProxyCount++;
+    MarkMoved(proxy);
+    return proxy;
+  }
+
+  void SpatialHash::RemoveProxy(uint32_t proxy)
+  {
+    GetProxy(proxy);
+
+    RemoveFromCells(proxy);
+    m_Proxies[proxy].Active = false;
+    m_FreeProxies.push_back(proxy);
+    m_ProxyCount--;
+    MarkRemoved(proxy);
+  }
+
+  void SpatialHash::MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement)
+  {
+    GetProxy(proxy);
+
+    Proxy& data = m_Proxies[proxy];
+    data.Bounds = bounds;
+    m_Extent = m_Extent.Union(bounds);
+    MarkMoved(proxy);
+
+    glm::ivec3 minCell = GetCell(bounds.Min), maxCell = GetCell(bounds.Max);
+    if (minCell == data.MinCell && maxCell == data.MaxCell)
+      return;
+
+    RemoveFromCells(proxy);
+    data.MinCell = minCell;
+    data.MaxCell = maxCell;
+    InsertIntoCells(proxy);
+  }
+
+  void SpatialHash::InsertIntoCells(uint32_t proxy)
+  {
+    const Proxy& data = m_Proxies[proxy];
+    for (int x = data.MinCell.x; x <= data.MaxCell.x; x++)
+      for (int y = data.MinCell.y; y <= data.MaxCell.y; y++)
+        for (int z = data.MinCell.z; z <= data.MaxCell.z; z++)
+          m_Cells[GetKey({ x, y, z })].push_back(proxy);
+  }
+
+  void SpatialHash::RemoveFromCells(uint32_t proxy)
+  {
+    const Proxy& data = m_Proxies[proxy];
+    for (int x = data.MinCell.x; x <= data.MaxCell.x; x++)
+    {
+      for (int y = data.MinCell.y; y <= data.MaxCell.y; y++)
+      {
+        for (int z = data.MinCell.z; z <= data.MaxCell.z; z++)
+        {
+          auto cell = m_Cells.find(GetKey({ x, y, z }));
+          auto& proxies = cell->second;
+          auto it = std::find(proxies.begin(), proxies.end(), proxy);
+          *it = proxies.back();
+          proxies.pop_back();
+
+          // Cells behind the player are dropped as the level scrolls by
+          if (proxies.empty())
+            m_Cells.erase(cell);
+        }
+      }
+    }
+  }
+
+  void SpatialHash::Query(const AABB& bounds, const std::function<bool(uint32_t proxy)>& callback) const
+  {
+    glm::ivec3 minCell = GetCell(bounds.Min), maxCell = GetCell(bounds.Max);
+    for (int x = minCell.x; x <= maxCell.x; x++)
+    {
+      for (int y = minCell.y; y <= maxCell.y; y++)
+      {
+        for (int z = minCell.z; z <= maxCell.z; z++)
+        {
+          auto cell = m_Cells.find(GetKey({ x, y, z }));
+          if (cell == m_Cells.end())
+            continue;
+
+          for (uint32_t proxy : cell->second)
+          {
+            // A proxy spanning several cells is only reported from the first cell it shares
+            // with the query box
+            const Proxy& data = m_Proxies[proxy];
+            if (x != std::max(minCell.x, data.MinCell.x) || y != std::max(minCell.y, data.MinCell.y) || z != std::max(minCell.z, data.MinCell.z))
+              continue;
+
+            if (data.Bounds.Overlaps(bounds) && !callback(proxy))
+              return;
+          }
+        }
+      }
+    }
+  }
+
+  void SpatialHash::RayCast(const Ray& ray, float maxDistance, const std::function<float(uint32_t proxy, float distance)>& callback) const
+  {
+    if (m_ProxyCount == 0)
+      return;
+
+    // Only the part of the ray within the extent can hit anything
+    float start;
+    if (!ray.Intersects(m_Extent, maxDistance, start))
+      return;
+
+    glm::vec3 t0 = (m_Extent.Min - ray.Origin) * ray.InverseDirection;
+    glm::vec3 t1 = (m_Extent.Max - ray.Origin) * ray.InverseDirection;
+    glm::vec3 exits = glm::max(t0, t1);
+    float end = std::min(std::min(exits.x, exits.y), std::min(exits.z, maxDistance));
+
+    // Walks the cells along the ray (Amanatides & Woo)
+    glm::vec3 position = ray.Origin + ray.Direction * start;
+    glm::ivec3 cell = GetCell(position);
+    glm::ivec3 step;
+    glm::vec3 next, delta;
+    for (int i = 0; i < 3; i++)
+    {
+      float direction = ray.Direction[i];
+      step[i] = direction > 0.0f ? 1 : (direction < 0.0f ? -1 : 0);
+      float boundary = (cell[i] + (direction > 0.0f ? 1 : 0)) * m_CellSize;
+      next[i] = step[i] ? start + (boundary - position[i]) / direction : std::numeric_limits<float>::infinity();
+      delta[i] = step[i] ? m_CellSize / std::abs(direction) : std::numeric_limits<float>::infinity();
+    }
+
+    std::unordered_set<uint32_t> reported;
+    std::vector<std::pair<float, uint32_t>> hits;
+    float distance = start;
+    while (distance <= std::min(end, maxDistance))
+    {
+      auto it = m_Cells.find(GetKey(cell));
+      if (it != m_Cells.end())
+      {
+        hits.clear();
+        for (uint32_t proxy : it->second)
+        {
+          float hit;
+          if (reported.find(proxy) == reported.end() && ray.Intersects(m_Proxies[proxy].Bounds, maxDistance, hit))
+            hits.push_back({ hit, proxy });
+        }
+
+        std::sort(hits.begin(), hits.end());
+        for (const auto& [hit, proxy] : hits)
+        {
+          if (hit > maxDistance)
+            break;
+
+          reported.insert(proxy);
+          maxDistance = callback(proxy, hit);
+          if (maxDistance <= 0.0f)
+            return;
+        }
+      }
+
+      int axis = next.x < next.y ? (next.x < next.z ? 0 : 2) : (next.y < next.z ? 1 : 2);
+      distance = next[axis];
+      next[axis] += delta[axis];
+      cell[axis] += step[axis];
+    }
+  }
+
+}
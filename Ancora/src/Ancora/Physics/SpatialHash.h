@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Broadphase.h"
+
+namespace Ancora {
+
+  // Uniform grid of cubic cells, of which only the occupied ones are stored, in a hash map. A
+  // proxy is listed in every cell its box touches; moving it within the same cells only updates
+  // its box. Suits many similarly sized objects spread along a long road, where a tree would
+  // spend its depth on the long axis.
+  class SpatialHash : public Broadphase
+  {
+  public:
+    SpatialHash(float cellSize);
+
+    virtual uint32_t AddProxy(const AABB& bounds, uint32_t userData) override;
+    virtual void RemoveProxy(uint32_t proxy) override;
+    virtual void MoveProxy(uint32_t proxy, const AABB& bounds, const glm::vec3& displacement = glm::vec3(0.0f)) override;
+
+    virtual const AABB& GetBounds(uint32_t proxy) const override { return GetProxy(proxy).Bounds; }
+    virtual uint32_t GetUserData(uint32_t proxy) const override { return GetProxy(proxy).UserData; }
+
+    virtual void Query(const AABB& bounds, const std::function<bool(uint32_t proxy)>& callback) const override;
+    virtual void RayCast(const Ray& ray, float maxDistance, const std::function<float(uint32_t proxy, float distance)>& callback) const override;
+
+    uint32_t GetCellCount() const { return (uint32_t)m_Cells.size(); }
+  protected:
+    virtual uint32_t GetProxyCount() const override { return m_ProxyCount; }
+  private:
+    struct Proxy
+    {
+      AABB Bounds;
+      uint32_t UserData = 0;
+      // Range of cells the box touches
+      glm::ivec3 MinCell;
+      glm::ivec3 MaxCell;
+      bool Active = false;
+    };
+
+    const Proxy& GetProxy(uint32_t proxy) const;
+    glm::ivec3 GetCell(const glm::vec3& position) const;
+    static uint64_t GetKey(const glm::ivec3& cell);
+
+    void InsertIntoCells(uint32_t proxy);
+    void RemoveFromCells(uint32_t proxy);
+  private:
+    float m_CellSize;
+    std::vector<Proxy> m_Proxies;
+    std::vector<uint32_t> m_FreeProxies;
+    uint32_t m_ProxyCount = 0;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_Cells;
+    // Box around every proxy ever added, inverted while empty, which bounds the cells a ray
+    // walks through
+    AABB m_Extent;
+  };
+
+}
@@ -31,12 +31,24 @@ namespace Ancora {
     return nullptr;
   }
 
-  Ref<IndexBuffer> IndexBuffer::Create(uint32_t count)
+  Ref<VertexBuffer> VertexBuffer::Create(const Ref<StreamingBuffer>& buffer)
   {
     switch (Renderer::GetAPI())
     {
       case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
-      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLIndexBuffer>(count);
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLVertexBuffer>(buffer);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+  Ref<IndexBuffer> IndexBuffer::Create(uint32_t count, IndexType type)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLIndexBuffer>(count, type);
     }
 
     AE_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -55,4 +67,16 @@ namespace Ancora {
     return nullptr;
   }
 
+  Ref<IndexBuffer> IndexBuffer::Create(uint16_t* indices, uint32_t count)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLIndexBuffer>(indices, count);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
 }
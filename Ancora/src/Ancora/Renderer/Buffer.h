@@ -97,6 +97,8 @@ namespace Ancora {
     uint32_t m_Stride = 0;
   };
 
+  class StreamingBuffer;
+
   class VertexBuffer
   {
   public:
@@ -112,8 +114,28 @@ namespace Ancora {
 
     static Ref<VertexBuffer> Create(uint32_t size);
     static Ref<VertexBuffer> Create(float* vertices, uint32_t size);
+    // Draws read from the whole streaming buffer; pick the vertices with a base vertex. SetData
+    // is not supported, write through StreamingBuffer::Allocate instead.
+    static Ref<VertexBuffer> Create(const Ref<StreamingBuffer>& buffer);
+  };
+
+  enum class IndexType
+  {
+    UInt16 = 0, UInt32
   };
 
+  static uint32_t IndexTypeSize(IndexType type)
+  {
+    switch (type)
+    {
+      case IndexType::UInt16: return 2;
+      case IndexType::UInt32: return 4;
+    }
+
+    AE_CORE_ASSERT(false, "Unknown IndexType!");
+    return 0;
+  }
+
   class IndexBuffer
   {
   public:
@@ -123,11 +145,13 @@ namespace Ancora {
     virtual void Unbind() const = 0;
 
     virtual uint32_t GetCount() const = 0;
+    virtual IndexType GetIndexType() const = 0;
 
-    virtual void SetData(const void* data, uint32_t size) = 0;
+    virtual void SetData(const void* data, uint32_t count) = 0;
 
-    static Ref<IndexBuffer> Create(uint32_t size);
+    static Ref<IndexBuffer> Create(uint32_t count, IndexType type = IndexType::UInt32);
     static Ref<IndexBuffer> Create(uint32_t* indices, uint32_t count);
+    static Ref<IndexBuffer> Create(uint16_t* indices, uint32_t count);
   };
 
 }
@@ -0,0 +1,44 @@
+#include "aepch.h"
+#include "CommandBuffer.h"
+
+namespace Ancora {
+
+  void CommandBuffer::Reset()
+  {
+    m_Commands.clear();
+    m_Transforms.clear();
+    m_Materials.clear();
+    m_Models.clear();
+  }
+
+  void CommandBuffer::SetTransform(const glm::mat4& transform)
+  {
+    m_Commands.push_back({ CommandType::SetTransform, (uint32_t)m_Transforms.size() });
+    m_Transforms.push_back(transform);
+  }
+
+  void CommandBuffer::BindMaterial(const Ref<Material>& material)
+  {
+    m_Commands.push_back({ CommandType::BindMaterial, (uint32_t)m_Materials.size() });
+    m_Materials.push_back({ material, glm::vec4(1.0f), false });
+  }
+
+  void CommandBuffer::BindColor(const glm::vec4& color)
+  {
+    m_Commands.push_back({ CommandType::BindMaterial, (uint32_t)m_Materials.size() });
+    m_Materials.push_back({ nullptr, color, true });
+  }
+
+  void CommandBuffer::Draw(const Ref<Model3D>& model)
+  {
+    m_Commands.push_back({ CommandType::Draw, (uint32_t)m_Models.size() });
+    m_Models.push_back(model);
+  }
+
+  void CommandBuffer::Draw(const Ref<Model3D>& model, const glm::mat4& transform)
+  {
+    SetTransform(transform);
+    Draw(model);
+  }
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Model3D.h"
+#include "Material.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Draws recorded without a graphics context. Recording touches nothing but the buffer, so any
+  // job can fill its own between Renderer3D::BeginScene and EndScene; Renderer3D::Submit then
+  // replays it on the render thread. Keep a buffer around and re-record it every frame, so its
+  // storage is reused.
+  class CommandBuffer
+  {
+  public:
+    enum class CommandType : uint8_t
+    {
+      SetTransform = 0, BindMaterial, Draw
+    };
+
+    struct Command
+    {
+      CommandType Type;
+      // Into the array of the command's type
+      uint32_t Index;
+    };
+
+    struct MaterialBinding
+    {
+      // Null draws the meshes with their own materials
+      Ref<Material> BoundMaterial;
+      glm::vec4 Color;
+      bool UseColor;
+    };
+
+    // Drops all commands. Draws start with the identity transform and the meshes' own materials.
+    void Reset();
+
+    void SetTransform(const glm::mat4& transform);
+    // Used by the draws that follow, registered on the render thread at submission
+    void BindMaterial(const Ref<Material>& material);
+    // Plain material of that color for the draws that follow
+    void BindColor(const glm::vec4& color);
+    void Draw(const Ref<Model3D>& model);
+    void Draw(const Ref<Model3D>& model, const glm::mat4& transform);
+
+    const std::vector<Command>& GetCommands() const { return m_Commands; }
+    const std::vector<glm::mat4>& GetTransforms() const { return m_Transforms; }
+    const std::vector<MaterialBinding>& GetMaterials() const { return m_Materials; }
+    const std::vector<Ref<Model3D>>& GetModels() const { return m_Models; }
+    uint32_t GetDrawCount() const { return (uint32_t)m_Models.size(); }
+  private:
+    std::vector<Command> m_Commands;
+    std::vector<glm::mat4> m_Transforms;
+    std::vector<MaterialBinding> m_Materials;
+    std::vector<Ref<Model3D>> m_Models;
+  };
+
+}
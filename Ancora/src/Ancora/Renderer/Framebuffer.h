@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+namespace Ancora {
+
+  enum class FramebufferTextureFormat
+  {
+    None = 0,
+
+    // Color
+    RGBA8,
+    RGBA16F,
+
+    // Depth/stencil
+    DEPTH24STENCIL8,
+    DEPTH32F,
+
+    // Defaults
+    Depth = DEPTH24STENCIL8
+  };
+
+  struct FramebufferTextureSpecification
+  {
+    FramebufferTextureSpecification() = default;
+    FramebufferTextureSpecification(FramebufferTextureFormat format)
+      : TextureFormat(format) {}
+
+    FramebufferTextureFormat TextureFormat = FramebufferTextureFormat::None;
+  };
+
+  struct FramebufferAttachmentSpecification
+  {
+    FramebufferAttachmentSpecification() = default;
+    FramebufferAttachmentSpecification(std::initializer_list<FramebufferTextureSpecification> attachments)
+      : Attachments(attachments) {}
+
+    std::vector<FramebufferTextureSpecification> Attachments;
+  };
+
+  struct FramebufferSpecification
+  {
+    uint32_t Width = 0, Height = 0;
+    FramebufferAttachmentSpecification Attachments;
+    // More than 1 creates multisampled attachments, which have to be resolved before they can be sampled
+    uint32_t Samples = 1;
+  };
+
+  class Framebuffer
+  {
+  public:
+    virtual ~Framebuffer() = default;
+
+    // Binding also sets the viewport to the size of the framebuffer
+    virtual void Bind() = 0;
+    virtual void Unbind() = 0;
+
+    virtual void Resize(uint32_t width, uint32_t height) = 0;
+
+    // Copies the first color attachment and the depth attachment into target, which must be the same size.
+    // This is how multisampled attachments are resolved.
+    virtual void Resolve(const Ref<Framebuffer>& target) const = 0;
+    // Stretches the first color attachment over the given rectangle of the window with linear filtering
+    virtual void BlitToScreen(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const = 0;
+
+    virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const = 0;
+    virtual uint32_t GetDepthAttachmentRendererID() const = 0;
+
+    virtual const FramebufferSpecification& GetSpecification() const = 0;
+
+    static Ref<Framebuffer> Create(const FramebufferSpecification& spec);
+  };
+
+}
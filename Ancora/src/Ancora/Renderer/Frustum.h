@@ -0,0 +1,53 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // View frustum as six inward-facing planes (xyz = normal, w = distance)
+  struct Frustum
+  {
+    glm::vec4 Planes[6];
+
+    Frustum() = default;
+
+    // Gribb/Hartmann extraction from a view-projection matrix
+    explicit Frustum(const glm::mat4& viewProjection)
+    {
+      for (int i = 0; i < 3; i++)
+      {
+        for (int j = 0; j < 4; j++)
+        {
+          Planes[i * 2 + 0][j] = viewProjection[j][3] + viewProjection[j][i];
+          Planes[i * 2 + 1][j] = viewProjection[j][3] - viewProjection[j][i];
+        }
+      }
+
+      for (auto& plane : Planes)
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    bool IntersectsSphere(const glm::vec3& center, float radius) const
+    {
+      for (const auto& plane : Planes)
+      {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+          return false;
+      }
+      return true;
+    }
+
+    bool IntersectsAABB(const glm::vec3& min, const glm::vec3& max) const
+    {
+      for (const auto& plane : Planes)
+      {
+        // Corner furthest along the plane normal
+        glm::vec3 corner = { plane.x >= 0.0f ? max.x : min.x, plane.y >= 0.0f ? max.y : min.y, plane.z >= 0.0f ? max.z : min.z };
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+          return false;
+      }
+      return true;
+    }
+  };
+
+}
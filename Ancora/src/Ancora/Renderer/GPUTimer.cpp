@@ -0,0 +1,22 @@
+#include "aepch.h"
+#include "GPUTimer.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLGPUTimer.h"
+
+namespace Ancora {
+
+  Ref<GPUTimer> GPUTimer::Create()
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLGPUTimer>();
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace Ancora {
+
+  // Measures the GPU time of the commands between Begin() and End(). Queries are read back once
+  // the GPU is done with them, usually a few frames later, so measuring never stalls. Timers can
+  // be nested and interleaved freely.
+  class GPUTimer
+  {
+  public:
+    virtual ~GPUTimer() = default;
+
+    // Skipped while every query is still in flight; End() then does nothing either
+    virtual void Begin() = 0;
+    virtual void End() = 0;
+
+    // Milliseconds of the latest finished measurement, 0 before the first one
+    virtual float GetTime() = 0;
+
+    static Ref<GPUTimer> Create();
+  };
+
+}
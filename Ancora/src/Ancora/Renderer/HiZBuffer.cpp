@@ -0,0 +1,68 @@
+#include "aepch.h"
+#include "HiZBuffer.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLHiZBuffer.h"
+
+namespace Ancora {
+
+  bool HiZBuffer::IsOccluded(const HiZReadback& readback, const glm::vec3& min, const glm::vec3& max)
+  {
+    if (readback.Depth.empty())
+      return false;
+
+    // Screen rectangle and nearest depth of the box
+    glm::vec2 rectMin = glm::vec2(1.0f);
+    glm::vec2 rectMax = glm::vec2(-1.0f);
+    float nearestDepth = 1.0f;
+    for (int i = 0; i < 8; i++)
+    {
+      glm::vec4 corner = { i & 1 ? max.x : min.x, i & 2 ? max.y : min.y, i & 4 ? max.z : min.z, 1.0f };
+      glm::vec4 clip = readback.ViewProjection * corner;
+      // Crosses the near plane, so it covers the camera
+      if (clip.w <= 0.0f)
+        return false;
+
+      glm::vec3 ndc = glm::vec3(clip) / clip.w;
+      rectMin = glm::min(rectMin, glm::vec2(ndc));
+      rectMax = glm::max(rectMax, glm::vec2(ndc));
+      nearestDepth = std::min(nearestDepth, ndc.z * 0.5f + 0.5f);
+    }
+
+    rectMin = glm::clamp(rectMin * 0.5f + 0.5f, 0.0f, 1.0f);
+    rectMax = glm::clamp(rectMax * 0.5f + 0.5f, 0.0f, 1.0f);
+    if (rectMin.x >= rectMax.x || rectMin.y >= rectMax.y)
+      return false;
+
+    uint32_t x0 = std::min((uint32_t)(rectMin.x * readback.Width), readback.Width - 1);
+    uint32_t y0 = std::min((uint32_t)(rectMin.y * readback.Height), readback.Height - 1);
+    // Odd level sizes fold the last row/column into the previous texel, so look one texel further
+    uint32_t x1 = std::min((uint32_t)(rectMax.x * readback.Width) + 1, readback.Width - 1);
+    uint32_t y1 = std::min((uint32_t)(rectMax.y * readback.Height) + 1, readback.Height - 1);
+
+    for (uint32_t y = y0; y <= y1; y++)
+    {
+      const float* row = &readback.Depth[y * readback.Width];
+      for (uint32_t x = x0; x <= x1; x++)
+      {
+        if (row[x] >= nearestDepth)
+          return false;
+      }
+    }
+    return true;
+  }
+
+  Ref<HiZBuffer> HiZBuffer::Create()
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLHiZBuffer>();
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
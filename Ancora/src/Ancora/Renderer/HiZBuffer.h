@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Ancora/Renderer/Framebuffer.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // CPU copy of one coarse Hi-Z level, together with the camera it was rendered with
+  struct HiZReadback
+  {
+    uint32_t Width = 0, Height = 0;
+    std::vector<float> Depth;
+    glm::mat4 ViewProjection = glm::mat4(1.0f);
+  };
+
+  // Hierarchical depth pyramid. Every texel of level N holds the farthest depth of
+  // the 2x2 texels below it in level N - 1, so a single lookup at the right level
+  // tells whether a screen rectangle is completely covered by something nearer.
+  class HiZBuffer
+  {
+  public:
+    virtual ~HiZBuffer() = default;
+
+    // Reduces the depth attachment of a single-sampled framebuffer into the pyramid.
+    // Follows the size of the framebuffer.
+    virtual void Build(const Ref<Framebuffer>& depthSource, const glm::mat4& viewProjection) = 0;
+    virtual void Bind(uint32_t slot = 0) const = 0;
+
+    virtual uint32_t GetWidth() const = 0;
+    virtual uint32_t GetHeight() const = 0;
+    virtual uint32_t GetMipCount() const = 0;
+    virtual const glm::mat4& GetViewProjection() const = 0;
+
+    // Starts an asynchronous copy of a coarse level to the CPU. Ignored while one is in flight.
+    virtual void RequestReadback() = 0;
+    // Latest finished readback, or nullptr if none has completed yet. Usually a frame or two old.
+    virtual const HiZReadback* GetReadback() = 0;
+
+    // True if the world space box is hidden behind the depth in the readback
+    static bool IsOccluded(const HiZReadback& readback, const glm::vec3& min, const glm::vec3& max);
+
+    static Ref<HiZBuffer> Create();
+  };
+
+}
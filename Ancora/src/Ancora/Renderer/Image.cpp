@@ -0,0 +1,63 @@
+#include "aepch.h"
+#include "Image.h"
+
+#include <stb_image.h>
+
+namespace Ancora {
+
+  Image::~Image()
+  {
+    stbi_image_free(m_Data);
+  }
+
+  Ref<Image> Image::Load(const std::string& path, bool flip)
+  {
+    // The flag is per thread when set this way, so concurrent loads do not race on it
+    stbi_set_flip_vertically_on_load_thread(flip);
+
+    int width, height, channels;
+    stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
+    if (!data)
+    {
+      AE_CORE_ERROR("Failed to load image '{0}': {1}", path, stbi_failure_reason());
+      return nullptr;
+    }
+
+    Ref<Image> image(new Image());
+    image->m_Path = path;
+    image->m_Width = width;
+    image->m_Height = height;
+    image->m_Channels = channels;
+    image->m_Data = data;
+    return image;
+  }
+
+  Ref<Image> Image::LoadHDR(const std::string& path, bool flip)
+  {
+    if (!stbi_is_hdr(path.c_str()))
+    {
+      AE_CORE_ERROR("Failed to load image '{0}': not an HDR file", path);
+      return nullptr;
+    }
+
+    stbi_set_flip_vertically_on_load_thread(flip);
+
+    int width, height, channels;
+    float* data = stbi_loadf(path.c_str(), &width, &height, &channels, 3);
+    if (!data)
+    {
+      AE_CORE_ERROR("Failed to load image '{0}': {1}", path, stbi_failure_reason());
+      return nullptr;
+    }
+
+    Ref<Image> image(new Image());
+    image->m_Path = path;
+    image->m_Width = width;
+    image->m_Height = height;
+    image->m_Channels = 3;
+    image->m_Data = (uint8_t*)data;
+    image->m_HDR = true;
+    return image;
+  }
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+namespace Ancora {
+
+  // Pixels of an image file, decoded on the CPU. Textures are flipped so the first row is the
+  // bottom one, as OpenGL expects; cube map faces are not. Loading is thread safe, so images can
+  // be decoded on workers and uploaded on the main thread.
+  class Image
+  {
+  public:
+    ~Image();
+
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    const std::string& GetPath() const { return m_Path; }
+    uint32_t GetWidth() const { return m_Width; }
+    uint32_t GetHeight() const { return m_Height; }
+    uint32_t GetChannels() const { return m_Channels; }
+    // 8 bits per channel, or floats for HDR images
+    const uint8_t* GetData() const { return m_Data; }
+    const float* GetHDRData() const { return (const float*)m_Data; }
+    bool IsHDR() const { return m_HDR; }
+
+    // Returns null and logs the reason if the file cannot be decoded
+    static Ref<Image> Load(const std::string& path, bool flip = true);
+    // Radiance .hdr files, as linear float RGB
+    static Ref<Image> LoadHDR(const std::string& path, bool flip = true);
+  private:
+    Image() = default;
+  private:
+    std::string m_Path;
+    uint32_t m_Width = 0, m_Height = 0, m_Channels = 0;
+    uint8_t* m_Data = nullptr;
+    bool m_HDR = false;
+  };
+
+}
@@ -0,0 +1,201 @@
+#include "aepch.h"
+#include "Material.h"
+
+#include "Ancora/Renderer/StorageBuffer.h"
+
+namespace Ancora {
+
+  static_assert(sizeof(MaterialParameters) == 48, "MaterialParameters must match the std430 layout in the shaders");
+
+  static void HashCombine(size_t& seed, size_t value)
+  {
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+  }
+
+  Material::Material(const Ref<Shader>& shader)
+    : m_Shader(shader)
+  {
+  }
+
+  void Material::SetTexture(MaterialTexture slot, const Ref<Texture2D>& texture)
+  {
+    AE_CORE_ASSERT(m_Index == InvalidIndex, "Textures of a registered material cannot change!");
+
+    m_Textures[(uint32_t)slot] = texture;
+    if (texture)
+      m_Parameters.TextureMask |= 1u << (uint32_t)slot;
+    else
+      m_Parameters.TextureMask &= ~(1u << (uint32_t)slot);
+  }
+
+  void Material::SetParameters(const MaterialParameters& parameters)
+  {
+    size_t oldHash = m_Index != InvalidIndex ? GetHash() : 0;
+
+    uint32_t textureMask = m_Parameters.TextureMask;
+    m_Parameters = parameters;
+    m_Parameters.TextureMask = textureMask;
+
+    if (m_Index != InvalidIndex)
+    {
+      MaterialLibrary::Rehash(this, oldHash);
+      MaterialLibrary::Invalidate(m_Index);
+    }
+  }
+
+  size_t Material::GetHash() const
+  {
+    size_t hash = std::hash<const Shader*>()(m_Shader.get());
+    for (const auto& texture : m_Textures)
+      HashCombine(hash, std::hash<const Texture2D*>()(texture.get()));
+
+    const float* values = &m_Parameters.Color.x;
+    for (uint32_t i = 0; i < 9; i++)
+      HashCombine(hash, std::hash<float>()(values[i]));
+    HashCombine(hash, m_Parameters.TextureMask);
+    return hash;
+  }
+
+  bool Material::operator==(const Material& other) const
+  {
+    return m_Shader == other.m_Shader && m_Textures == other.m_Textures &&
+      m_Parameters.Color == other.m_Parameters.Color && m_Parameters.Emissive == other.m_Parameters.Emissive &&
+      m_Parameters.Shininess == other.m_Parameters.Shininess && m_Parameters.TextureMask == other.m_Parameters.TextureMask;
+  }
+
+  static const uint32_t TextureCount = (uint32_t)MaterialTexture::Count;
+  static const uint32_t TextureReferencesSize = TextureCount * sizeof(glm::uvec2);
+
+  struct MaterialLibraryData
+  {
+    std::unordered_multimap<size_t, Ref<Material>> Materials;
+    std::vector<MaterialParameters> Parameters;
+    Ref<Material> Default;
+
+    // MaterialTexture::Count references per material, zero for empty slots
+    std::vector<glm::uvec2> TextureReferences;
+    Ref<TextureTable> Textures;
+
+    Ref<StorageBuffer> Buffer;
+    Ref<StorageBuffer> TextureBuffer;
+    // Range of materials that has not been uploaded yet
+    uint32_t DirtyBegin = 0, DirtyEnd = 0;
+  };
+
+  static MaterialLibraryData s_Data;
+
+  void MaterialLibrary::Init()
+  {
+    s_Data.Textures = TextureTable::Create();
+    s_Data.Default = Register(CreateRef<Material>());
+  }
+
+  void MaterialLibrary::Shutdown()
+  {
+    s_Data = MaterialLibraryData();
+  }
+
+  Ref<Material> MaterialLibrary::Register(const Ref<Material>& material)
+  {
+    if (material->m_Index != Material::InvalidIndex)
+      return material;
+
+    size_t hash = material->GetHash();
+    auto range = s_Data.Materials.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (*it->second == *material)
+        return it->second;
+    }
+
+    material->m_Index = (uint32_t)s_Data.Parameters.size();
+    s_Data.Parameters.push_back(material->m_Parameters);
+    for (const auto& texture : material->m_Textures)
+      s_Data.TextureReferences.push_back(texture ? s_Data.Textures->Add(texture) : glm::uvec2(0));
+    s_Data.Materials.emplace(hash, material);
+    Invalidate(material->m_Index);
+    return material;
+  }
+
+  const Ref<Material>& MaterialLibrary::GetDefault()
+  {
+    AE_CORE_ASSERT(s_Data.Default, "MaterialLibrary has not been initialized!");
+    return s_Data.Default;
+  }
+
+  uint32_t MaterialLibrary::GetCount()
+  {
+    return (uint32_t)s_Data.Parameters.size();
+  }
+
+  const Ref<TextureTable>& MaterialLibrary::GetTextureTable()
+  {
+    return s_Data.Textures;
+  }
+
+  void MaterialLibrary::Rehash(const Material* material, size_t oldHash)
+  {
+    // Materials that become equal to another one through an edit stay separate
+    auto range = s_Data.Materials.equal_range(oldHash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+      if (it->second.get() == material)
+      {
+        Ref<Material> registered = it->second;
+        s_Data.Materials.erase(it);
+        s_Data.Materials.emplace(material->GetHash(), registered);
+        return;
+      }
+    }
+    AE_CORE_ASSERT(false, "Material is not in the MaterialLibrary!");
+  }
+
+  void MaterialLibrary::Invalidate(uint32_t index)
+  {
+    if (s_Data.DirtyBegin == s_Data.DirtyEnd)
+    {
+      s_Data.DirtyBegin = index;
+      s_Data.DirtyEnd = index + 1;
+    }
+    else
+    {
+      s_Data.DirtyBegin = std::min(s_Data.DirtyBegin, index);
+      s_Data.DirtyEnd = std::max(s_Data.DirtyEnd, index + 1);
+    }
+  }
+
+  void MaterialLibrary::Bind()
+  {
+    uint32_t size = (uint32_t)(s_Data.Parameters.size() * sizeof(MaterialParameters));
+    if (!s_Data.Buffer || s_Data.Buffer->GetSize() < size)
+    {
+      // Grow geometrically and upload everything into the new buffer
+      uint32_t capacity = std::max(size, s_Data.Buffer ? s_Data.Buffer->GetSize() * 2 : 64 * (uint32_t)sizeof(MaterialParameters));
+      s_Data.Buffer = StorageBuffer::Create(capacity);
+      s_Data.TextureBuffer = StorageBuffer::Create(capacity / sizeof(MaterialParameters) * TextureReferencesSize);
+      s_Data.DirtyBegin = 0;
+      s_Data.DirtyEnd = (uint32_t)s_Data.Parameters.size();
+    }
+
+    if (s_Data.DirtyBegin != s_Data.DirtyEnd)
+    {
+      // Registered materials may have been edited since they were copied
+      for (const auto& [hash, material] : s_Data.Materials)
+      {
+        if (material->m_Index >= s_Data.DirtyBegin && material->m_Index < s_Data.DirtyEnd)
+          s_Data.Parameters[material->m_Index] = material->m_Parameters;
+      }
+
+      uint32_t offset = s_Data.DirtyBegin * sizeof(MaterialParameters);
+      uint32_t count = s_Data.DirtyEnd - s_Data.DirtyBegin;
+      s_Data.Buffer->SetData(&s_Data.Parameters[s_Data.DirtyBegin], count * sizeof(MaterialParameters), offset);
+      s_Data.TextureBuffer->SetData(&s_Data.TextureReferences[s_Data.DirtyBegin * TextureCount], count * TextureReferencesSize, s_Data.DirtyBegin * TextureReferencesSize);
+      s_Data.DirtyBegin = s_Data.DirtyEnd = 0;
+    }
+
+    s_Data.Buffer->Bind(MaterialBinding);
+    s_Data.TextureBuffer->Bind(MaterialTextureBinding);
+    s_Data.Textures->Bind();
+  }
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Ancora/Renderer/Shader.h"
+#include "Ancora/Renderer/Texture.h"
+#include "Ancora/Renderer/TextureTable.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Texture slots of a material. Shaders look up slot i of a material in the texture reference
+  // buffer, so a new kind of texture only needs an entry here and code in the shaders that use it.
+  enum class MaterialTexture : uint32_t
+  {
+    Diffuse = 0, Specular, Ambient, Emissive, Height, Normals, Shininess, Opacity, Displacement, Lightmap, Reflection,
+    Count
+  };
+
+  // Mirrors the std430 Material struct in the shaders
+  struct MaterialParameters
+  {
+    glm::vec4 Color = glm::vec4(1.0f);
+    glm::vec4 Emissive = glm::vec4(0.0f);
+    float Shininess = 32.0f;
+    // Bit i is set when slot i has a texture. Maintained by Material.
+    uint32_t TextureMask = 0;
+    float Padding[2] = {};
+  };
+
+  // A shader, its textures and a parameter block. Materials are registered with the
+  // MaterialLibrary, which merges identical ones and keeps their parameters on the GPU.
+  class Material
+  {
+  public:
+    static const uint32_t InvalidIndex = 0xffffffff;
+
+    // A null shader stands for the renderer's default lit shader
+    Material(const Ref<Shader>& shader = nullptr);
+
+    const Ref<Shader>& GetShader() const { return m_Shader; }
+
+    void SetTexture(MaterialTexture slot, const Ref<Texture2D>& texture);
+    const Ref<Texture2D>& GetTexture(MaterialTexture slot) const { return m_Textures[(uint32_t)slot]; }
+
+    // Changing the parameters of a registered material changes every draw that shares it. Later
+    // registrations of its new content find it; those of its old content no longer do.
+    void SetParameters(const MaterialParameters& parameters);
+    const MaterialParameters& GetParameters() const { return m_Parameters; }
+
+    // Position in the GPU material buffer, InvalidIndex until registered
+    uint32_t GetIndex() const { return m_Index; }
+
+    size_t GetHash() const;
+    bool operator==(const Material& other) const;
+  private:
+    Ref<Shader> m_Shader;
+    std::array<Ref<Texture2D>, (size_t)MaterialTexture::Count> m_Textures;
+    MaterialParameters m_Parameters;
+    uint32_t m_Index = InvalidIndex;
+
+    friend class MaterialLibrary;
+  };
+
+  // Every registered material, deduplicated by content, with their parameters in one
+  // shader storage buffer that draws index into. A second buffer holds the TextureTable
+  // reference of every slot, MaterialTexture::Count per material.
+  class MaterialLibrary
+  {
+  public:
+    static const uint32_t MaterialBinding = 5;
+    static const uint32_t MaterialTextureBinding = 7;
+
+    static void Init();
+    static void Shutdown();
+
+    // Returns the registered material with the same content, or registers this one
+    static Ref<Material> Register(const Ref<Material>& material);
+    // Registered material with default parameters and no textures, always at index 0
+    static const Ref<Material>& GetDefault();
+    static uint32_t GetCount();
+    static const Ref<TextureTable>& GetTextureTable();
+
+    // Uploads parameters that changed and binds the buffers and the texture table
+    static void Bind();
+  private:
+    // Moves a registered material whose parameters changed to the bucket of its new hash
+    static void Rehash(const Material* material, size_t oldHash);
+    static void Invalidate(uint32_t index);
+
+    friend class Material;
+  };
+
+}
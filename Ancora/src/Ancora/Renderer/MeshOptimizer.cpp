@@ -0,0 +1,727 @@
+#include "aepch.h"
+#include "MeshOptimizer.h"
+
+#include <cstring>
+
+namespace Ancora {
+
+  static_assert(sizeof(VertexData3D) == 8 * sizeof(float), "VertexData3D is expected to be tightly packed for welding");
+
+  static const uint32_t s_InvalidIndex = ~0u;
+
+  // ------------------------- Forsyth scoring -------------------------
+  static const uint32_t s_ForsythCacheSize = 32;
+  static const float s_CacheDecayPower = 1.5f;
+  static const float s_LastTriangleScore = 0.75f;
+  static const float s_ValenceBoostScale = 2.0f;
+  static const float s_ValenceBoostPower = 0.5f;
+
+  // FIFO size used for cluster splitting and ACMR reporting
+  static const uint32_t s_FIFOCacheSize = 16;
+
+  static float ForsythVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+  {
+    if (remainingTriangles == 0)
+      return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+      if (cachePosition < 3)
+        score = s_LastTriangleScore;
+      else
+      {
+        const float scaler = 1.0f / (s_ForsythCacheSize - 3);
+        score = std::pow(1.0f - (cachePosition - 3) * scaler, s_CacheDecayPower);
+      }
+    }
+
+    score += s_ValenceBoostScale * std::pow((float)remainingTriangles, -s_ValenceBoostPower);
+    return score;
+  }
+
+  // Simulates a FIFO cache using per-vertex timestamps; returns the number of misses for one triangle
+  static uint32_t SimulateFIFO(const uint32_t* triangle, std::vector<uint32_t>& timestamps, uint32_t& time, uint32_t cacheSize)
+  {
+    uint32_t misses = 0;
+    for (uint32_t k = 0; k < 3; k++)
+    {
+      if (time - timestamps[triangle[k]] > cacheSize)
+      {
+        timestamps[triangle[k]] = time++;
+        misses++;
+      }
+    }
+    return misses;
+  }
+
+  struct VertexHasher
+  {
+    size_t operator()(const VertexData3D& vertex) const
+    {
+      uint32_t words[8];
+      std::memcpy(words, &vertex, sizeof(words));
+
+      // FNV-1a over the raw float bits
+      size_t hash = 2166136261u;
+      for (uint32_t word : words)
+        hash = (hash ^ word) * 16777619u;
+      return hash;
+    }
+  };
+
+  struct VertexEqual
+  {
+    bool operator()(const VertexData3D& a, const VertexData3D& b) const
+    {
+      return std::memcmp(&a, &b, sizeof(VertexData3D)) == 0;
+    }
+  };
+
+  // ------------------------ Quadric simplification ------------------------
+  struct Quadric
+  {
+    // Symmetric 3x3 matrix A, vector b and scalar c of the plane distance quadric
+    double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+    double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+    double C = 0.0;
+    double Weight = 0.0;
+
+    void AddPlane(const glm::vec3& normal, float distance, float weight)
+    {
+      A00 += weight * normal.x * normal.x; A01 += weight * normal.x * normal.y; A02 += weight * normal.x * normal.z;
+      A11 += weight * normal.y * normal.y; A12 += weight * normal.y * normal.z; A22 += weight * normal.z * normal.z;
+      B0 += weight * normal.x * distance; B1 += weight * normal.y * distance; B2 += weight * normal.z * distance;
+      C += weight * distance * distance;
+      Weight += weight;
+    }
+
+    void Add(const Quadric& other)
+    {
+      A00 += other.A00; A01 += other.A01; A02 += other.A02;
+      A11 += other.A11; A12 += other.A12; A22 += other.A22;
+      B0 += other.B0; B1 += other.B1; B2 += other.B2;
+      C += other.C;
+      Weight += other.Weight;
+    }
+
+    // Weighted mean squared distance of p to the accumulated planes
+    double Error(const glm::vec3& p) const
+    {
+      double x = p.x, y = p.y, z = p.z;
+      double result = A00 * x * x + A11 * y * y + A22 * z * z
+        + 2.0 * (A01 * x * y + A02 * x * z + A12 * y * z)
+        + 2.0 * (B0 * x + B1 * y + B2 * z) + C;
+      return Weight > 0.0 ? std::abs(result) / Weight : 0.0;
+    }
+  };
+
+  enum class VertexKind : uint8_t
+  {
+    Manifold = 0, Border, Locked
+  };
+
+  struct Collapse
+  {
+    uint32_t From; // canonical vertex that disappears
+    uint32_t To;   // vertex index it is replaced with
+    bool BorderEdge;
+    double Cost;
+  };
+
+  static uint64_t EdgeKey(uint32_t a, uint32_t b)
+  {
+    return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+  }
+
+  // True if moving canonical vertex 'from' onto position 'target' turns any of its
+  // remaining triangles upside down
+  static bool HasTriangleFlip(uint32_t from, uint32_t toCanonical, const glm::vec3& target, const std::vector<uint32_t>& indices,
+    const std::vector<uint32_t>& canonical, const std::vector<VertexData3D>& vertices,
+    const std::vector<uint32_t>& adjacencyOffset, const std::vector<uint32_t>& adjacency)
+  {
+    for (uint32_t j = adjacencyOffset[from]; j < adjacencyOffset[from + 1]; j++)
+    {
+      const uint32_t* triangle = &indices[adjacency[j] * 3];
+      uint32_t c0 = canonical[triangle[0]], c1 = canonical[triangle[1]], c2 = canonical[triangle[2]];
+      if (c0 == toCanonical || c1 == toCanonical || c2 == toCanonical)
+        continue;
+
+      glm::vec3 p0 = vertices[triangle[0]].Position, p1 = vertices[triangle[1]].Position, p2 = vertices[triangle[2]].Position;
+      glm::vec3 before = glm::cross(p1 - p0, p2 - p0);
+
+      if (c0 == from) p0 = target;
+      if (c1 == from) p1 = target;
+      if (c2 == from) p2 = target;
+      glm::vec3 after = glm::cross(p1 - p0, p2 - p0);
+
+      if (glm::dot(before, after) <= 0.0f)
+        return true;
+    }
+
+    return false;
+  }
+
+  MeshOptimizer::Statistics MeshOptimizer::Optimize(Mesh& mesh)
+  {
+    Statistics stats;
+    stats.VerticesBefore = (uint32_t)mesh.Vertices.size();
+    stats.VerticesAfter = stats.VerticesBefore;
+
+    if (mesh.Indices.empty() || mesh.Indices.size() % 3 != 0)
+    {
+      AE_CORE_WARN("MeshOptimizer: skipping mesh with non-triangle index list ({0} indices)", mesh.Indices.size());
+      return stats;
+    }
+
+    stats.ACMRBefore = ComputeACMR(mesh.Indices, (uint32_t)mesh.Vertices.size());
+
+    WeldVertices(mesh.Vertices, mesh.Indices);
+    OptimizeVertexCache(mesh.Indices, (uint32_t)mesh.Vertices.size());
+    OptimizeOverdraw(mesh.Indices, mesh.Vertices);
+    OptimizeVertexFetch(mesh.Vertices, mesh.Indices);
+
+    stats.VerticesAfter = (uint32_t)mesh.Vertices.size();
+    stats.ACMRAfter = ComputeACMR(mesh.Indices, (uint32_t)mesh.Vertices.size());
+    return stats;
+  }
+
+  void MeshOptimizer::WeldVertices(std::vector<VertexData3D>& vertices, std::vector<uint32_t>& indices)
+  {
+    std::unordered_map<VertexData3D, uint32_t, VertexHasher, VertexEqual> unique;
+    unique.reserve(vertices.size());
+
+    std::vector<VertexData3D> welded;
+    welded.reserve(vertices.size());
+
+    std::vector<uint32_t> remap(vertices.size());
+    for (uint32_t i = 0; i < vertices.size(); i++)
+    {
+      auto result = unique.emplace(vertices[i], (uint32_t)welded.size());
+      if (result.second)
+        welded.push_back(vertices[i]);
+      remap[i] = result.first->second;
+    }
+
+    for (auto& index : indices)
+      index = remap[index];
+
+    vertices.swap(welded);
+  }
+
+  void MeshOptimizer::OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount)
+  {
+    uint32_t triangleCount = (uint32_t)indices.size() / 3;
+    if (triangleCount == 0)
+      return;
+
+    // Vertex -> triangle adjacency. The first LiveTriangles[v] entries of each range
+    // are the triangles of v that have not been emitted yet.
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (uint32_t index : indices)
+      liveTriangles[index]++;
+
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (uint32_t v = 0; v < vertexCount; v++)
+      adjacencyOffset[v + 1] = adjacencyOffset[v] + liveTriangles[v];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+      std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+      for (uint32_t i = 0; i < indices.size(); i++)
+        adjacency[fill[indices[i]]++] = i / 3;
+    }
+
+    std::vector<int32_t> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+      vertexScore[v] = ForsythVertexScore(-1, liveTriangles[v]);
+
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    for (uint32_t t = 0; t < triangleCount; t++)
+      triangleScore[t] = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    std::vector<uint32_t> cache, newCache;
+    cache.reserve(s_ForsythCacheSize + 3);
+    newCache.reserve(s_ForsythCacheSize + 3);
+
+    uint32_t bestTriangle = (uint32_t)(std::max_element(triangleScore.begin(), triangleScore.end()) - triangleScore.begin());
+    uint32_t scanCursor = 0;
+
+    for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+      if (bestTriangle == s_InvalidIndex)
+      {
+        // Nothing in the cache has live triangles left; restart from the next unemitted triangle
+        while (emitted[scanCursor])
+          scanCursor++;
+        bestTriangle = scanCursor;
+      }
+
+      const uint32_t* triangle = &indices[bestTriangle * 3];
+      emitted[bestTriangle] = 1;
+      output.insert(output.end(), triangle, triangle + 3);
+
+      newCache.clear();
+      for (uint32_t k = 0; k < 3; k++)
+      {
+        uint32_t v = triangle[k];
+
+        uint32_t* begin = &adjacency[adjacencyOffset[v]];
+        uint32_t* end = begin + liveTriangles[v];
+        uint32_t* it = std::find(begin, end, bestTriangle);
+        AE_CORE_ASSERT(it != end, "Vertex cache adjacency is out of sync!");
+        std::swap(*it, *(end - 1));
+        liveTriangles[v]--;
+
+        if (std::find(newCache.begin(), newCache.end(), v) == newCache.end())
+          newCache.push_back(v);
+      }
+
+      for (uint32_t v : cache)
+      {
+        if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+          newCache.push_back(v);
+      }
+
+      // Rescore every vertex whose cache position changed, including those just evicted,
+      // and pick the best live triangle among what is still cached.
+      for (uint32_t i = 0; i < newCache.size(); i++)
+      {
+        uint32_t v = newCache[i];
+        cachePosition[v] = i < s_ForsythCacheSize ? (int32_t)i : -1;
+
+        float score = ForsythVertexScore(cachePosition[v], liveTriangles[v]);
+        float delta = score - vertexScore[v];
+        vertexScore[v] = score;
+
+        for (uint32_t j = 0; j < liveTriangles[v]; j++)
+          triangleScore[adjacency[adjacencyOffset[v] + j]] += delta;
+      }
+
+      if (newCache.size() > s_ForsythCacheSize)
+        newCache.resize(s_ForsythCacheSize);
+
+      bestTriangle = s_InvalidIndex;
+      float bestScore = -1.0f;
+      for (uint32_t v : newCache)
+      {
+        for (uint32_t j = 0; j < liveTriangles[v]; j++)
+        {
+          uint32_t t = adjacency[adjacencyOffset[v] + j];
+          if (triangleScore[t] > bestScore)
+          {
+            bestScore = triangleScore[t];
+            bestTriangle = t;
+          }
+        }
+      }
+
+      cache.swap(newCache);
+    }
+
+    indices.swap(output);
+  }
+
+  void MeshOptimizer::OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData3D>& vertices, float threshold)
+  {
+    uint32_t triangleCount = (uint32_t)indices.size() / 3;
+    if (triangleCount < 2)
+      return;
+
+    std::vector<uint32_t> timestamps(vertices.size(), 0);
+    uint32_t time = s_FIFOCacheSize + 1;
+
+    // Hard boundaries: a triangle that misses on all three vertices starts a new cluster
+    std::vector<uint32_t> hardClusters;
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+      if (SimulateFIFO(&indices[t * 3], timestamps, time, s_FIFOCacheSize) == 3 || t == 0)
+        hardClusters.push_back(t);
+    }
+    hardClusters.push_back(triangleCount);
+
+    // Soft boundaries: split a hard cluster wherever the running ACMR (with a cold cache)
+    // is already within threshold of the whole cluster's ACMR
+    std::vector<uint32_t> clusters;
+    for (uint32_t c = 0; c + 1 < hardClusters.size(); c++)
+    {
+      uint32_t start = hardClusters[c];
+      uint32_t end = hardClusters[c + 1];
+
+      time += s_FIFOCacheSize + 1;
+      uint32_t clusterMisses = 0;
+      for (uint32_t t = start; t < end; t++)
+        clusterMisses += SimulateFIFO(&indices[t * 3], timestamps, time, s_FIFOCacheSize);
+      float clusterThreshold = threshold * (float)clusterMisses / (float)(end - start);
+
+      time += s_FIFOCacheSize + 1;
+      uint32_t runStart = start;
+      uint32_t runMisses = 0;
+      clusters.push_back(start);
+      for (uint32_t t = start; t < end; t++)
+      {
+        runMisses += SimulateFIFO(&indices[t * 3], timestamps, time, s_FIFOCacheSize);
+        if (t + 1 < end && (float)runMisses <= clusterThreshold * (float)(t + 1 - runStart))
+        {
+          clusters.push_back(t + 1);
+          runStart = t + 1;
+          runMisses = 0;
+          time += s_FIFOCacheSize + 1;
+        }
+      }
+    }
+    clusters.push_back(triangleCount);
+
+    // Sort clusters so that those facing away from the mesh centre, i.e. the likely
+    // occluders, are drawn first
+    uint32_t clusterCount = (uint32_t)clusters.size() - 1;
+    std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+    std::vector<float> clusterArea(clusterCount, 0.0f);
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+
+    for (uint32_t c = 0; c < clusterCount; c++)
+    {
+      for (uint32_t t = clusters[c]; t < clusters[c + 1]; t++)
+      {
+        const glm::vec3& p0 = vertices[indices[t * 3 + 0]].Position;
+        const glm::vec3& p1 = vertices[indices[t * 3 + 1]].Position;
+        const glm::vec3& p2 = vertices[indices[t * 3 + 2]].Position;
+
+        glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+        float area = glm::length(normal);
+        glm::vec3 centroid = (p0 + p1 + p2) / 3.0f;
+
+        clusterCentroid[c] += centroid * area;
+        clusterNormal[c] += normal;
+        clusterArea[c] += area;
+      }
+
+      meshCentroid += clusterCentroid[c];
+      meshArea += clusterArea[c];
+    }
+
+    if (meshArea > 0.0f)
+      meshCentroid /= meshArea;
+
+    std::vector<float> sortKey(clusterCount, 0.0f);
+    for (uint32_t c = 0; c < clusterCount; c++)
+    {
+      float normalLength = glm::length(clusterNormal[c]);
+      if (clusterArea[c] <= 0.0f || normalLength <= 0.0f)
+        continue;
+
+      glm::vec3 centroid = clusterCentroid[c] / clusterArea[c];
+      sortKey[c] = glm::dot(centroid - meshCentroid, clusterNormal[c] / normalLength);
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++)
+      order[c] = c;
+    std::stable_sort(order.begin(), order.end(), [&sortKey](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (uint32_t c : order)
+      output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+
+    indices.swap(output);
+  }
+
+  void MeshOptimizer::OptimizeVertexFetch(std::vector<VertexData3D>& vertices, std::vector<uint32_t>& indices)
+  {
+    std::vector<uint32_t> remap(vertices.size(), s_InvalidIndex);
+    std::vector<VertexData3D> ordered;
+    ordered.reserve(vertices.size());
+
+    for (auto& index : indices)
+    {
+      if (remap[index] == s_InvalidIndex)
+      {
+        remap[index] = (uint32_t)ordered.size();
+        ordered.push_back(vertices[index]);
+      }
+      index = remap[index];
+    }
+
+    vertices.swap(ordered);
+  }
+
+  std::vector<uint32_t> MeshOptimizer::Simplify(const std::vector<VertexData3D>& vertices, const std::vector<uint32_t>& indices, uint32_t targetIndexCount, float targetError, float* resultError)
+  {
+    std::vector<uint32_t> result = indices;
+    if (resultError)
+      *resultError = 0.0f;
+
+    uint32_t vertexCount = (uint32_t)vertices.size();
+    if (result.size() <= targetIndexCount || vertexCount == 0)
+      return result;
+
+    // Vertices sharing a position are wedges of one canonical vertex; topology is
+    // evaluated on canonical vertices so attribute seams do not look like holes
+    std::vector<uint32_t> canonical(vertexCount);
+    std::vector<uint32_t> wedgeCount(vertexCount, 0);
+    {
+      struct PositionHasher
+      {
+        size_t operator()(const glm::vec3& p) const
+        {
+          uint32_t words[3];
+          std::memcpy(words, &p, sizeof(words));
+          return (size_t)((words[0] * 73856093u) ^ (words[1] * 19349663u) ^ (words[2] * 83492791u));
+        }
+      };
+
+      std::unordered_map<glm::vec3, uint32_t, PositionHasher> positions;
+      positions.reserve(vertexCount);
+      for (uint32_t v = 0; v < vertexCount; v++)
+      {
+        canonical[v] = positions.emplace(vertices[v].Position, v).first->second;
+        wedgeCount[canonical[v]]++;
+      }
+    }
+
+    glm::vec3 boundsMin = vertices[0].Position, boundsMax = vertices[0].Position;
+    for (const auto& vertex : vertices)
+    {
+      boundsMin = glm::min(boundsMin, vertex.Position);
+      boundsMax = glm::max(boundsMax, vertex.Position);
+    }
+    glm::vec3 extent = boundsMax - boundsMin;
+    float scale = std::max(extent.x, std::max(extent.y, extent.z));
+    if (scale <= 0.0f)
+      return result;
+
+    double maxCost = (double)targetError * scale * (double)targetError * scale;
+
+    std::unordered_map<uint64_t, uint32_t> edgeUse;
+    edgeUse.reserve(result.size());
+    for (uint32_t i = 0; i < result.size(); i += 3)
+    {
+      for (uint32_t k = 0; k < 3; k++)
+        edgeUse[EdgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]])]++;
+    }
+
+    // Quadrics are built once from the input and merged as vertices collapse
+    std::vector<Quadric> quadrics(vertexCount);
+    for (uint32_t i = 0; i < result.size(); i += 3)
+    {
+      uint32_t c[3] = { canonical[result[i]], canonical[result[i + 1]], canonical[result[i + 2]] };
+      const glm::vec3& p0 = vertices[c[0]].Position;
+      const glm::vec3& p1 = vertices[c[1]].Position;
+      const glm::vec3& p2 = vertices[c[2]].Position;
+
+      glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+      float area = glm::length(normal);
+      if (area <= 0.0f)
+        continue;
+      normal /= area;
+
+      Quadric face;
+      face.AddPlane(normal, -glm::dot(normal, p0), area);
+      for (uint32_t k = 0; k < 3; k++)
+        quadrics[c[k]].Add(face);
+
+      // Borders get an extra plane through the edge, perpendicular to the face, so they keep their silhouette
+      for (uint32_t k = 0; k < 3; k++)
+      {
+        uint32_t a = c[k], b = c[(k + 1) % 3];
+        if (edgeUse[EdgeKey(a, b)] != 1)
+          continue;
+
+        glm::vec3 edge = vertices[b].Position - vertices[a].Position;
+        float length = glm::length(edge);
+        if (length <= 0.0f)
+          continue;
+
+        glm::vec3 borderNormal = glm::normalize(glm::cross(edge, normal));
+        Quadric border;
+        border.AddPlane(borderNormal, -glm::dot(borderNormal, vertices[a].Position), 2.0f * length * length);
+        quadrics[a].Add(border);
+        quadrics[b].Add(border);
+      }
+    }
+
+    std::vector<uint32_t> vertexRemap(vertexCount);
+    std::vector<VertexKind> kind(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1);
+    std::vector<uint32_t> adjacency;
+    std::vector<Collapse> collapses;
+    double resultCost = 0.0;
+
+    while (result.size() > targetIndexCount)
+    {
+      // Classify canonical vertices against the current topology
+      edgeUse.clear();
+      for (uint32_t i = 0; i < result.size(); i += 3)
+      {
+        for (uint32_t k = 0; k < 3; k++)
+          edgeUse[EdgeKey(canonical[result[i + k]], canonical[result[i + (k + 1) % 3]])]++;
+      }
+
+      for (uint32_t v = 0; v < vertexCount; v++)
+        kind[v] = wedgeCount[v] > 1 ? VertexKind::Locked : VertexKind::Manifold;
+      for (const auto& edge : edgeUse)
+      {
+        if (edge.second != 1)
+          continue;
+        for (uint32_t c : { (uint32_t)(edge.first >> 32), (uint32_t)(edge.first & 0xffffffff) })
+        {
+          if (kind[c] == VertexKind::Manifold)
+            kind[c] = VertexKind::Border;
+        }
+      }
+
+      // Canonical vertex -> triangle adjacency
+      std::fill(adjacencyOffset.begin(), adjacencyOffset.end(), 0);
+      for (uint32_t index : result)
+        adjacencyOffset[canonical[index] + 1]++;
+      for (uint32_t v = 0; v < vertexCount; v++)
+        adjacencyOffset[v + 1] += adjacencyOffset[v];
+      adjacency.resize(result.size());
+      {
+        std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+        for (uint32_t i = 0; i < result.size(); i++)
+          adjacency[fill[canonical[result[i]]]++] = i / 3;
+      }
+
+      collapses.clear();
+      for (uint32_t i = 0; i < result.size(); i += 3)
+      {
+        for (uint32_t k = 0; k < 3; k++)
+        {
+          uint32_t v0 = result[i + k], v1 = result[i + (k + 1) % 3];
+          uint32_t c0 = canonical[v0], c1 = canonical[v1];
+          if (c0 == c1)
+            continue;
+
+          bool borderEdge = edgeUse[EdgeKey(c0, c1)] == 1;
+          for (uint32_t direction = 0; direction < 2; direction++)
+          {
+            uint32_t from = direction ? c1 : c0;
+            uint32_t to = direction ? v0 : v1;
+            uint32_t toCanonical = canonical[to];
+
+            bool allowed = kind[from] == VertexKind::Manifold
+              || (kind[from] == VertexKind::Border && borderEdge && kind[toCanonical] != VertexKind::Manifold);
+            if (!allowed)
+              continue;
+
+            Quadric merged = quadrics[from];
+            merged.Add(quadrics[toCanonical]);
+            collapses.push_back({ from, to, borderEdge, merged.Error(vertices[to].Position) });
+          }
+        }
+      }
+
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.Cost < b.Cost; });
+
+      for (uint32_t v = 0; v < vertexCount; v++)
+        vertexRemap[v] = v;
+      std::fill(touched.begin(), touched.end(), 0);
+
+      uint32_t trianglesToRemove = (uint32_t)(result.size() - targetIndexCount) / 3;
+      uint32_t trianglesRemoved = 0;
+      uint32_t applied = 0;
+      for (const auto& collapse : collapses)
+      {
+        if (collapse.Cost > maxCost || trianglesRemoved >= trianglesToRemove)
+          break;
+
+        uint32_t toCanonical = canonical[collapse.To];
+        if (touched[collapse.From] || touched[toCanonical])
+          continue;
+
+        if (HasTriangleFlip(collapse.From, toCanonical, vertices[collapse.To].Position, result, canonical, vertices, adjacencyOffset, adjacency))
+          continue;
+
+        // Non-locked vertices have exactly one wedge, which is the canonical vertex itself
+        vertexRemap[collapse.From] = collapse.To;
+        quadrics[toCanonical].Add(quadrics[collapse.From]);
+        touched[collapse.From] = 1;
+        touched[toCanonical] = 1;
+
+        resultCost = std::max(resultCost, collapse.Cost);
+        trianglesRemoved += collapse.BorderEdge ? 1 : 2;
+        applied++;
+      }
+
+      if (applied == 0)
+        break;
+
+      uint32_t writeIndex = 0;
+      for (uint32_t i = 0; i < result.size(); i += 3)
+      {
+        uint32_t a = vertexRemap[result[i]], b = vertexRemap[result[i + 1]], c = vertexRemap[result[i + 2]];
+        if (canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[a] == canonical[c])
+          continue;
+
+        result[writeIndex++] = a;
+        result[writeIndex++] = b;
+        result[writeIndex++] = c;
+      }
+      result.resize(writeIndex);
+    }
+
+    if (resultError)
+      *resultError = (float)(std::sqrt(resultCost) / scale);
+
+    return result;
+  }
+
+  void MeshOptimizer::GenerateLODs(Mesh& mesh)
+  {
+    uint32_t baseCount = (uint32_t)mesh.Indices.size();
+    mesh.LODs.clear();
+    mesh.LODs.push_back({ 0, baseCount, 0.0f });
+    if (baseCount == 0 || baseCount % 3 != 0)
+      return;
+
+    std::vector<uint32_t> previous(mesh.Indices.begin(), mesh.Indices.end());
+    float accumulatedError = 0.0f;
+
+    for (uint32_t level = 1; level < Mesh::MaxLODs; level++)
+    {
+      // Each level halves the triangle count of the one before and allows twice the error
+      uint32_t targetCount = (baseCount >> level) / 3 * 3;
+      float targetError = 0.01f * (float)(1 << (level - 1));
+
+      float error = 0.0f;
+      std::vector<uint32_t> lod = Simplify(mesh.Vertices, previous, targetCount, targetError, &error);
+
+      // Stop once simplification no longer buys a meaningful reduction
+      if (lod.empty() || lod.size() > previous.size() * 9 / 10)
+        break;
+
+      OptimizeVertexCache(lod, (uint32_t)mesh.Vertices.size());
+      accumulatedError += error;
+
+      mesh.LODs.push_back({ (uint32_t)mesh.Indices.size(), (uint32_t)lod.size(), accumulatedError });
+      mesh.Indices.insert(mesh.Indices.end(), lod.begin(), lod.end());
+      previous.swap(lod);
+    }
+  }
+
+  float MeshOptimizer::ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+  {
+    uint32_t triangleCount = (uint32_t)indices.size() / 3;
+    if (triangleCount == 0)
+      return 0.0f;
+
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (uint32_t t = 0; t < triangleCount; t++)
+      misses += SimulateFIFO(&indices[t * 3], timestamps, time, cacheSize);
+
+    return (float)misses / (float)triangleCount;
+  }
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Ancora/Renderer/Model3D.h"
+
+namespace Ancora {
+
+  class MeshOptimizer
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t VerticesBefore = 0;
+      uint32_t VerticesAfter = 0;
+      float ACMRBefore = 0.0f;
+      float ACMRAfter = 0.0f;
+    };
+
+    // Full post-import pipeline: weld, vertex cache order, overdraw order, fetch order
+    static Statistics Optimize(Mesh& mesh);
+
+    // Merges bitwise identical vertices and rewrites the indices to match
+    static void WeldVertices(std::vector<VertexData3D>& vertices, std::vector<uint32_t>& indices);
+    // Reorders triangles for post-transform cache hits (Forsyth)
+    static void OptimizeVertexCache(std::vector<uint32_t>& indices, uint32_t vertexCount);
+    // Splits the cache-ordered triangles into clusters and sorts them outside-in (Tipsify-style).
+    // threshold is how much ACMR may degrade in exchange for finer clusters.
+    static void OptimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<VertexData3D>& vertices, float threshold = 1.05f);
+    // Reorders vertices in order of first use and drops unreferenced ones
+    static void OptimizeVertexFetch(std::vector<VertexData3D>& vertices, std::vector<uint32_t>& indices);
+
+    // Quadric error metric edge collapse. Returns a new index list over the same vertices with
+    // at most targetIndexCount indices, unless that would exceed targetError (relative to the
+    // mesh extent). UV/normal seams are kept in place and borders only collapse along themselves.
+    static std::vector<uint32_t> Simplify(const std::vector<VertexData3D>& vertices, const std::vector<uint32_t>& indices, uint32_t targetIndexCount, float targetError, float* resultError = nullptr);
+    // Appends progressively simplified LODs to mesh.Indices and fills mesh.LODs
+    static void GenerateLODs(Mesh& mesh);
+
+    // Average cache miss ratio (misses per triangle) of a FIFO cache
+    static float ComputeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = 16);
+  };
+
+}
@@ -0,0 +1,67 @@
+#include "aepch.h"
+#include "Model3D.h"
+
+#include "Ancora/Core/FileWatcher.h"
+
+namespace Ancora {
+
+  BufferLayout VertexData3D::GetLayout()
+  {
+    return {
+      { ShaderDataType::Float3, "a_Position" },
+      { ShaderDataType::Float2, "a_TexCoord" },
+      { ShaderDataType::Float3, "a_Normal" }
+    };
+  }
+
+  void Mesh::Upload()
+  {
+    if (LODs.empty())
+      LODs.push_back({ 0, (uint32_t)Indices.size(), 0.0f });
+
+    MeshVertexArray = VertexArray::Create();
+
+    Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create((float*)Vertices.data(), (uint32_t)(Vertices.size() * sizeof(VertexData3D)));
+    vertexBuffer->SetLayout(VertexData3D::GetLayout());
+    MeshVertexArray->AddVertexBuffer(vertexBuffer);
+
+    Ref<IndexBuffer> indexBuffer;
+    if (Vertices.size() <= std::numeric_limits<uint16_t>::max() + 1)
+    {
+      std::vector<uint16_t> shortIndices(Indices.begin(), Indices.end());
+      indexBuffer = IndexBuffer::Create(shortIndices.data(), (uint32_t)shortIndices.size());
+    }
+    else
+      indexBuffer = IndexBuffer::Create(Indices.data(), (uint32_t)Indices.size());
+
+    MeshVertexArray->SetIndexBuffer(indexBuffer);
+  }
+
+  Model3D::~Model3D()
+  {
+    FileWatcher::Unwatch(m_WatchID);
+  }
+
+  void Model3D::CalculateBounds()
+  {
+    bool first = true;
+    for (const auto& mesh : m_Meshes)
+    {
+      for (const auto& vertex : mesh.Vertices)
+      {
+        m_BoundsMin = first ? vertex.Position : glm::min(m_BoundsMin, vertex.Position);
+        m_BoundsMax = first ? vertex.Position : glm::max(m_BoundsMax, vertex.Position);
+        first = false;
+      }
+    }
+  }
+
+  uint32_t Model3D::GetLODCount() const
+  {
+    uint32_t count = 1;
+    for (const auto& mesh : m_Meshes)
+      count = std::max(count, (uint32_t)mesh.LODs.size());
+    return count;
+  }
+
+}
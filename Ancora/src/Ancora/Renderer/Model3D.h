@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Texture.h"
+#include "Material.h"
+#include "VertexArray.h"
 
 #include <glm/glm.hpp>
 
@@ -11,40 +12,62 @@ namespace Ancora {
     glm::vec3 Position;
     glm::vec2 TexCoord;
     glm::vec3 Normal;
+
+    static BufferLayout GetLayout();
+  };
+
+  struct MeshLOD
+  {
+    uint32_t IndexOffset;
+    uint32_t IndexCount;
+    // Simplification error relative to the mesh extent
+    float Error;
   };
 
   struct Mesh
   {
+    static const uint32_t MaxLODs = 5;
+
     std::vector<VertexData3D> Vertices;
+    // All detail levels back to back, LOD 0 first. LODs[i] gives the range of each.
     std::vector<uint32_t> Indices;
-    std::vector<Ref<Texture2D>> DiffuseTextures;
-    std::vector<Ref<Texture2D>> SpecularTextures;
-    std::vector<Ref<Texture2D>> AmbientTextures;
-    std::vector<Ref<Texture2D>> EmissiveTextures;
-    std::vector<Ref<Texture2D>> HeightTextures;
-    std::vector<Ref<Texture2D>> NormalsTextures;
-    std::vector<Ref<Texture2D>> ShininessTextures;
-    std::vector<Ref<Texture2D>> OpacityTextures;
-    std::vector<Ref<Texture2D>> DisplacementTextures;
-    std::vector<Ref<Texture2D>> LightmapTextures;
-    std::vector<Ref<Texture2D>> ReflectionTextures;
-    std::vector<Ref<Texture2D>> UnknownTextures;
+    std::vector<MeshLOD> LODs;
+    // Registered with the MaterialLibrary; null draws with the default material
+    Ref<Material> MeshMaterial;
+
+    // GPU copy of Vertices/Indices, created by Upload(). Indices are stored as
+    // 16-bit whenever the vertex count allows it.
+    Ref<VertexArray> MeshVertexArray;
+
+    void Upload();
   };
 
   class Model3D
   {
   public:
     Model3D() {}
-    ~Model3D() = default;
+    ~Model3D();
 
     void SetName(const std::string& name) { m_Name = name; }
 
-    void AddMesh(Mesh mesh) { m_Meshes.push_back(mesh); }
+    void AddMesh(Mesh mesh) { m_Meshes.push_back(std::move(mesh)); }
 
-    const std::vector<Mesh> GetMesh() const { return m_Meshes; }
+    void CalculateBounds();
+    const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+    const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+    uint32_t GetLODCount() const;
+
+    const std::vector<Mesh>& GetMesh() const { return m_Meshes; }
+    std::vector<Mesh>& GetMeshes() { return m_Meshes; }
   private:
     std::string m_Name;
     std::vector<Mesh> m_Meshes;
+    glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+    glm::vec3 m_BoundsMax = glm::vec3(0.0f);
+    // Set by ModelLoader, which reloads the model when its file changes
+    uint32_t m_WatchID = 0;
+
+    friend class ModelLoader;
   };
 
 }
@@ -0,0 +1,348 @@
+#include "aepch.h"
+#include "ParticleSystem.h"
+
+#include "Ancora/Renderer/RenderCommand.h"
+#include "Ancora/Core/JobSystem.h"
+#include "Ancora/Core/Random.h"
+#include "Ancora/Core/SIMD.h"
+
+#include <chrono>
+#include <cstddef>
+#include <numeric>
+
+namespace Ancora {
+
+  // Mirrors the Counters block of the particle shaders. The first five fields are the
+  // indirect draw command.
+  struct ParticleCounters
+  {
+    uint32_t Count;
+    uint32_t InstanceCount;
+    uint32_t FirstIndex;
+    int32_t BaseVertex;
+    uint32_t BaseInstance;
+    uint32_t DrawCount;
+    int32_t DeadCount;
+    uint32_t Padding;
+  };
+
+  // Two vec4s per particle: position and seconds left, velocity and lifetime
+  static const uint32_t s_ParticleSize = 2 * sizeof(glm::vec4);
+  // Local size of the particle compute shaders
+  static const uint32_t s_WorkGroupSize = 64;
+  // Statistics buffers per emitter, so the one read back is a few frames old
+  static const uint32_t s_FramesInFlight = 3;
+  // Particles per job on the CPU path
+  static const uint32_t s_BlockSize = 4096;
+
+  // Uniformly distributed within spread radians of axis, from two random numbers in [0, 1].
+  // Matches ConeDirection in ParticleEmit.glsl.
+  static glm::vec3 ConeDirection(const glm::vec3& axis, float spread, float u, float v)
+  {
+    glm::vec3 direction = glm::normalize(axis);
+    glm::vec3 tangent = glm::normalize(glm::cross(direction, std::abs(direction.y) < 0.99f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f)));
+    glm::vec3 bitangent = glm::cross(direction, tangent);
+
+    float cosTheta = 1.0f + (std::cos(spread) - 1.0f) * u;
+    float sinTheta = std::sqrt(std::max(1.0f - cosTheta * cosTheta, 0.0f));
+    float phi = 6.2831853f * v;
+    return direction * cosTheta + (tangent * std::cos(phi) + bitangent * std::sin(phi)) * sinTheta;
+  }
+
+  // Moves the particles in [begin, end) in steps of F::Width and returns where it stopped,
+  // so the rest can be done with a narrower F
+  template<typename F>
+  static uint32_t IntegrateParticles(std::vector<float>* arrays[8], uint32_t begin, uint32_t end, float timestep, const glm::vec3& acceleration, float drag)
+  {
+    F dt = timestep;
+    F damping = std::max(1.0f - drag * timestep, 0.0f);
+    F velocityChange[3] = { acceleration.x * timestep, acceleration.y * timestep, acceleration.z * timestep };
+
+    uint32_t i = begin;
+    for (; i + F::Width <= end; i += F::Width)
+    {
+      for (uint32_t axis = 0; axis < 3; axis++)
+      {
+        float* position = arrays[axis]->data() + i;
+        float* velocity = arrays[3 + axis]->data() + i;
+        F newVelocity = (F::Load(velocity) + velocityChange[axis]) * damping;
+        newVelocity.Store(velocity);
+        (F::Load(position) + newVelocity * dt).Store(position);
+      }
+
+      float* life = arrays[6]->data() + i;
+      (F::Load(life) - dt).Store(life);
+    }
+    return i;
+  }
+
+  ParticleSystem::ParticleSystem()
+    : ParticleSystem(GetDefaultSimulation())
+  {
+  }
+
+  ParticleSystem::ParticleSystem(ParticleSimulation simulation)
+    : m_Simulation(simulation)
+  {
+    if (m_Simulation == ParticleSimulation::GPU && !RenderCommand::GetCapabilities().Compute)
+    {
+      AE_CORE_WARN("ParticleSystem: compute shaders are not supported, simulating on the CPU");
+      m_Simulation = ParticleSimulation::CPU;
+    }
+    AE_CORE_INFO("ParticleSystem: simulating on the {0}", m_Simulation == ParticleSimulation::GPU ? "GPU" : "CPU (" AE_SIMD_NAME ")");
+
+    if (m_Simulation == ParticleSimulation::GPU)
+    {
+      m_EmitShader = Shader::Create("Sandbox/assets/shaders/ParticleEmit.glsl");
+      m_SimulateShader = Shader::Create("Sandbox/assets/shaders/ParticleSimulate.glsl");
+    }
+    m_RenderShader = Shader::Create("Sandbox/assets/shaders/Particle.glsl");
+
+    float quadVertices[] = {
+      -0.5f, -0.5f,
+       0.5f, -0.5f,
+       0.5f,  0.5f,
+      -0.5f,  0.5f
+    };
+    uint16_t quadIndices[] = { 0, 1, 2, 2, 3, 0 };
+
+    m_QuadVertexArray = VertexArray::Create();
+    Ref<VertexBuffer> quadVertexBuffer = VertexBuffer::Create(quadVertices, sizeof(quadVertices));
+    quadVertexBuffer->SetLayout({ { ShaderDataType::Float2, "a_Corner" } });
+    m_QuadVertexArray->AddVertexBuffer(quadVertexBuffer);
+    m_QuadVertexArray->SetIndexBuffer(IndexBuffer::Create(quadIndices, sizeof(quadIndices) / sizeof(uint16_t)));
+  }
+
+  uint32_t ParticleSystem::AddEmitter(const ParticleEmitterProps& props, uint32_t maxParticles)
+  {
+    AE_CORE_ASSERT(maxParticles > 0, "Emitter without particles!");
+
+    Scope<Emitter> emitter = CreateScope<Emitter>();
+    emitter->Props = props;
+    emitter->MaxParticles = maxParticles;
+
+    // Every particle starts out dead, with every slot on the dead list. The CPU path keeps its
+    // particles packed, so its alive list never changes.
+    std::vector<uint32_t> indices(maxParticles);
+    std::iota(indices.begin(), indices.end(), 0);
+
+    emitter->ParticleBuffer = StorageBuffer::Create(maxParticles * s_ParticleSize);
+    emitter->ParticleBuffer->Clear();
+    emitter->AliveListBuffer = StorageBuffer::Create(maxParticles * sizeof(uint32_t));
+    if (m_Simulation == ParticleSimulation::CPU)
+      emitter->AliveListBuffer->SetData(indices.data(), maxParticles * sizeof(uint32_t));
+
+    ParticleCounters counters = { (uint32_t)m_QuadVertexArray->GetIndexBuffer()->GetCount(), 0, 0, 0, 0, 1, (int32_t)maxParticles, 0 };
+    emitter->CounterBuffer = StorageBuffer::Create(sizeof(ParticleCounters));
+    emitter->CounterBuffer->SetData(&counters, sizeof(ParticleCounters));
+
+    if (m_Simulation == ParticleSimulation::GPU)
+    {
+      emitter->DeadListBuffer = StorageBuffer::Create(maxParticles * sizeof(uint32_t));
+      emitter->DeadListBuffer->SetData(indices.data(), maxParticles * sizeof(uint32_t));
+
+      for (uint32_t i = 0; i < s_FramesInFlight; i++)
+      {
+        emitter->StatisticsBuffers.push_back(StorageBuffer::Create(4 * sizeof(uint32_t)));
+        emitter->StatisticsBuffers.back()->Clear();
+      }
+      emitter->SimulationTimer = GPUTimer::Create();
+    }
+    else
+    {
+      ParticlePool& pool = emitter->Pool;
+      for (auto* array : { &pool.PositionX, &pool.PositionY, &pool.PositionZ, &pool.VelocityX, &pool.VelocityY, &pool.VelocityZ, &pool.Life, &pool.Lifetime })
+        array->resize(maxParticles);
+      emitter->Upload.resize(2 * maxParticles);
+    }
+    emitter->DrawTimer = GPUTimer::Create();
+
+    m_Emitters.push_back(std::move(emitter));
+    return (uint32_t)m_Emitters.size() - 1;
+  }
+
+  void ParticleSystem::Burst(uint32_t emitter, uint32_t count)
+  {
+    m_Emitters[emitter]->BurstCount += count;
+  }
+
+  void ParticleSystem::OnUpdate(Timestep ts)
+  {
+    for (auto& emitter : m_Emitters)
+    {
+      emitter->EmissionRemainder += emitter->Props.EmissionRate * ts;
+      uint32_t emitCount = (uint32_t)emitter->EmissionRemainder;
+      emitter->EmissionRemainder -= (float)emitCount;
+      emitCount = std::min(emitCount + emitter->BurstCount, emitter->MaxParticles);
+      emitter->BurstCount = 0;
+
+      if (m_Simulation == ParticleSimulation::GPU)
+        SimulateGPU(*emitter, emitCount, ts);
+      else
+        SimulateCPU(*emitter, emitCount, ts);
+    }
+  }
+
+  void ParticleSystem::SimulateGPU(Emitter& emitter, uint32_t emitCount, float timestep)
+  {
+    const ParticleEmitterProps& props = emitter.Props;
+
+    // The oldest statistics buffer is reused. Its count is only read once its fence has
+    // signalled; while the GPU lags behind that far the last count stays.
+    emitter.FrameIndex = (emitter.FrameIndex + 1) % s_FramesInFlight;
+    const auto& statisticsBuffer = emitter.StatisticsBuffers[emitter.FrameIndex];
+    statisticsBuffer->TryGetData(&emitter.Stats.AliveParticles, sizeof(uint32_t));
+    statisticsBuffer->Clear();
+
+    emitter.SimulationTimer->Begin();
+
+    // The simulate shader rebuilds the alive list from scratch
+    uint32_t instanceCount = 0;
+    emitter.CounterBuffer->SetData(&instanceCount, sizeof(uint32_t), offsetof(ParticleCounters, InstanceCount));
+
+    emitter.ParticleBuffer->Bind(ParticleBinding);
+    emitter.DeadListBuffer->Bind(DeadListBinding);
+    emitter.AliveListBuffer->Bind(AliveListBinding);
+    emitter.CounterBuffer->Bind(CounterBinding);
+    statisticsBuffer->Bind(StatisticsBinding);
+
+    if (emitCount > 0)
+    {
+      m_EmitShader->Bind();
+      m_EmitShader->SetInt("u_EmitCount", (int)emitCount);
+      m_EmitShader->SetInt("u_Seed", (int)m_Seed++);
+      m_EmitShader->SetFloat3("u_Position", props.Position);
+      m_EmitShader->SetFloat("u_SpawnRadius", props.SpawnRadius);
+      m_EmitShader->SetFloat3("u_Direction", props.Direction);
+      m_EmitShader->SetFloat("u_Spread", props.Spread);
+      m_EmitShader->SetFloat2("u_Speed", { props.SpeedMin, props.SpeedMax });
+      m_EmitShader->SetFloat2("u_Lifetime", { props.LifetimeMin, props.LifetimeMax });
+      RenderCommand::DispatchCompute((emitCount + s_WorkGroupSize - 1) / s_WorkGroupSize);
+      // The simulate shader moves the new particles along with the rest
+      RenderCommand::Barrier(StorageBarrier);
+    }
+
+    m_SimulateShader->Bind();
+    m_SimulateShader->SetInt("u_MaxParticles", (int)emitter.MaxParticles);
+    m_SimulateShader->SetFloat("u_Timestep", timestep);
+    m_SimulateShader->SetFloat3("u_Acceleration", props.Acceleration);
+    m_SimulateShader->SetFloat("u_Drag", props.Drag);
+    RenderCommand::DispatchCompute((emitter.MaxParticles + s_WorkGroupSize - 1) / s_WorkGroupSize);
+    // For the indirect draw of the alive list, and the instance count reset and statistics
+    // readback of later frames
+    RenderCommand::Barrier(StorageBarrier | IndirectCommandBarrier | BufferUpdateBarrier);
+    statisticsBuffer->Fence();
+
+    emitter.SimulationTimer->End();
+  }
+
+  void ParticleSystem::SimulateCPU(Emitter& emitter, uint32_t emitCount, float timestep)
+  {
+    auto start = std::chrono::steady_clock::now();
+    const ParticleEmitterProps& props = emitter.Props;
+    ParticlePool& pool = emitter.Pool;
+
+    // New particles go to the back and are moved along with the rest, as on the GPU path
+    emitCount = std::min(emitCount, emitter.MaxParticles - pool.Count);
+    for (uint32_t n = 0; n < emitCount; n++)
+    {
+      uint32_t i = pool.Count++;
+      glm::vec3 position = props.Position + ConeDirection(props.Direction, 3.14159265f, Random::Float(), Random::Float()) * props.SpawnRadius * std::cbrt(Random::Float());
+      glm::vec3 velocity = ConeDirection(props.Direction, props.Spread, Random::Float(), Random::Float()) * (props.SpeedMin + (props.SpeedMax - props.SpeedMin) * Random::Float());
+      float lifetime = std::max(props.LifetimeMin + (props.LifetimeMax - props.LifetimeMin) * Random::Float(), 0.001f);
+
+      pool.PositionX[i] = position.x; pool.PositionY[i] = position.y; pool.PositionZ[i] = position.z;
+      pool.VelocityX[i] = velocity.x; pool.VelocityY[i] = velocity.y; pool.VelocityZ[i] = velocity.z;
+      pool.Life[i] = lifetime;
+      pool.Lifetime[i] = lifetime;
+    }
+
+    std::vector<float>* arrays[8] = { &pool.PositionX, &pool.PositionY, &pool.PositionZ, &pool.VelocityX, &pool.VelocityY, &pool.VelocityZ, &pool.Life, &pool.Lifetime };
+    uint32_t count = pool.Count;
+    JobSystem::ParallelFor((count + s_BlockSize - 1) / s_BlockSize, [&](uint32_t block)
+    {
+      uint32_t begin = block * s_BlockSize;
+      uint32_t end = std::min(begin + s_BlockSize, count);
+      uint32_t rest = IntegrateParticles<FloatWide>(arrays, begin, end, timestep, props.Acceleration, props.Drag);
+      IntegrateParticles<FloatScalar>(arrays, rest, end, timestep, props.Acceleration, props.Drag);
+    });
+
+    // Dead particles are replaced by the last live one, keeping the pool packed
+    for (uint32_t i = 0; i < pool.Count; )
+    {
+      if (pool.Life[i] > 0.0f)
+      {
+        i++;
+        continue;
+      }
+
+      pool.Count--;
+      for (auto* array : arrays)
+        (*array)[i] = (*array)[pool.Count];
+    }
+
+    count = pool.Count;
+    JobSystem::ParallelFor((count + s_BlockSize - 1) / s_BlockSize, [&](uint32_t block)
+    {
+      uint32_t end = std::min((block + 1) * s_BlockSize, count);
+      for (uint32_t i = block * s_BlockSize; i < end; i++)
+      {
+        emitter.Upload[2 * i] = { pool.PositionX[i], pool.PositionY[i], pool.PositionZ[i], pool.Life[i] };
+        emitter.Upload[2 * i + 1] = { pool.VelocityX[i], pool.VelocityY[i], pool.VelocityZ[i], pool.Lifetime[i] };
+      }
+    });
+
+    if (count > 0)
+      emitter.ParticleBuffer->SetData(emitter.Upload.data(), count * s_ParticleSize);
+    emitter.CounterBuffer->SetData(&count, sizeof(uint32_t), offsetof(ParticleCounters, InstanceCount));
+
+    emitter.Stats.AliveParticles = count;
+    emitter.Stats.SimulationTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+  }
+
+  void ParticleSystem::Draw(const PerspectiveCamera& camera)
+  {
+    const glm::mat4& view = camera.GetViewMatrix();
+    m_RenderShader->Bind();
+    m_RenderShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+    // The rows of the view rotation are the camera axes in world space
+    m_RenderShader->SetFloat3("u_CameraRight", { view[0][0], view[1][0], view[2][0] });
+    m_RenderShader->SetFloat3("u_CameraUp", { view[0][1], view[1][1], view[2][1] });
+
+    m_QuadVertexArray->Bind();
+    for (auto& emitter : m_Emitters)
+    {
+      if (m_Simulation == ParticleSimulation::CPU && emitter->Pool.Count == 0)
+        continue;
+
+      const ParticleEmitterProps& props = emitter->Props;
+      m_RenderShader->SetFloat4("u_ColorBegin", props.ColorBegin);
+      m_RenderShader->SetFloat4("u_ColorEnd", props.ColorEnd);
+      m_RenderShader->SetFloat2("u_Size", { props.SizeBegin, props.SizeEnd });
+      emitter->ParticleBuffer->Bind(ParticleBinding);
+      emitter->AliveListBuffer->Bind(AliveListBinding);
+
+      // One command, whose instance count the simulation wrote
+      emitter->DrawTimer->Begin();
+      RenderCommand::DrawIndexedIndirect(m_QuadVertexArray, emitter->CounterBuffer, emitter->CounterBuffer, 1, 0, offsetof(ParticleCounters, DrawCount));
+      emitter->DrawTimer->End();
+    }
+  }
+
+  ParticleSystem::EmitterStatistics ParticleSystem::GetStats(uint32_t emitter)
+  {
+    Emitter& data = *m_Emitters[emitter];
+    EmitterStatistics stats = data.Stats;
+    if (data.SimulationTimer)
+      stats.SimulationTime = data.SimulationTimer->GetTime();
+    stats.DrawTime = data.DrawTimer->GetTime();
+    return stats;
+  }
+
+  ParticleSimulation ParticleSystem::GetDefaultSimulation()
+  {
+    const RendererAPI::Capabilities& capabilities = RenderCommand::GetCapabilities();
+    return capabilities.Compute && !capabilities.SoftwareRenderer ? ParticleSimulation::GPU : ParticleSimulation::CPU;
+  }
+
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include "Ancora/Core/Timestep.h"
+#include "Ancora/Renderer/PerspectiveCamera.h"
+#include "Ancora/Renderer/Shader.h"
+#include "Ancora/Renderer/StorageBuffer.h"
+#include "Ancora/Renderer/VertexArray.h"
+#include "Ancora/Renderer/GPUTimer.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  struct ParticleEmitterProps
+  {
+    glm::vec3 Position = glm::vec3(0.0f);
+    // Particles start anywhere within this distance of Position
+    float SpawnRadius = 0.0f;
+    glm::vec3 Direction = { 0.0f, 1.0f, 0.0f };
+    // Half angle of the cone particles leave in, in radians
+    float Spread = 0.3f;
+    float SpeedMin = 1.0f, SpeedMax = 2.0f;
+    float LifetimeMin = 1.0f, LifetimeMax = 2.0f;
+    // Gravity, wind and the like
+    glm::vec3 Acceleration = { 0.0f, -9.81f, 0.0f };
+    // Fraction of the velocity lost per second
+    float Drag = 0.0f;
+    // Interpolated over the life of a particle
+    glm::vec4 ColorBegin = glm::vec4(1.0f), ColorEnd = { 1.0f, 1.0f, 1.0f, 0.0f };
+    float SizeBegin = 0.2f, SizeEnd = 0.0f;
+    // Particles per second, on top of Burst()
+    float EmissionRate = 50.0f;
+  };
+
+  enum class ParticleSimulation
+  {
+    // Emit and simulate in compute shaders; the particles never leave the GPU
+    GPU = 0,
+    // Simulate with SIMD on the CPU and upload the live particles every frame
+    CPU = 1
+  };
+
+  // Emitters of camera-facing particles. Each emitter owns a fixed pool of particles in shader
+  // storage. On the GPU path a compute shader pops free slots off an atomic dead list to emit,
+  // and another one moves the particles, pushes the ones that died back onto the dead list and
+  // compacts the survivors into an alive list, whose length is the instance count of the
+  // indirect draw. The CPU has nothing to do but set uniforms.
+  // Software renderers run compute shaders far slower than the engine can on the CPU itself,
+  // so they get the CPU path, which feeds the same buffers and draw.
+  class ParticleSystem
+  {
+  public:
+    // Shader storage bindings shared with the particle shaders
+    enum Binding : uint32_t
+    {
+      ParticleBinding = 0,
+      DeadListBinding = 1,
+      AliveListBinding = 2,
+      CounterBinding = 3,
+      StatisticsBinding = 4
+    };
+
+    struct EmitterStatistics
+    {
+      // A few frames late on the GPU path
+      uint32_t AliveParticles = 0;
+      // Milliseconds spent emitting and simulating: GPU time on the GPU path, CPU time on the CPU path
+      float SimulationTime = 0.0f;
+      // GPU milliseconds of the draw
+      float DrawTime = 0.0f;
+    };
+
+    ParticleSystem();
+    ParticleSystem(ParticleSimulation simulation);
+
+    ParticleSystem(const ParticleSystem&) = delete;
+    ParticleSystem& operator=(const ParticleSystem&) = delete;
+
+    // Returns the ID of the emitter. Its pool holds up to maxParticles at a time; emission
+    // stops while it is full.
+    uint32_t AddEmitter(const ParticleEmitterProps& props, uint32_t maxParticles);
+    ParticleEmitterProps& GetEmitter(uint32_t emitter) { return m_Emitters[emitter]->Props; }
+    uint32_t GetEmitterCount() const { return (uint32_t)m_Emitters.size(); }
+    // Emits count particles at once during the next update
+    void Burst(uint32_t emitter, uint32_t count);
+
+    // Emits and moves the particles of every emitter. Call once per frame.
+    void OnUpdate(Timestep ts);
+    // Draws the particles of every emitter into the bound framebuffer, without writing depth.
+    // Called by Renderer3D for the systems queued with DrawParticles.
+    void Draw(const PerspectiveCamera& camera);
+
+    ParticleSimulation GetSimulation() const { return m_Simulation; }
+    EmitterStatistics GetStats(uint32_t emitter);
+
+    // CPU on software renderers and where compute shaders are missing, GPU otherwise
+    static ParticleSimulation GetDefaultSimulation();
+  private:
+    // Particles of one emitter on the CPU path, packed at the front of each array
+    struct ParticlePool
+    {
+      std::vector<float> PositionX, PositionY, PositionZ;
+      std::vector<float> VelocityX, VelocityY, VelocityZ;
+      // Seconds left and seconds in total
+      std::vector<float> Life, Lifetime;
+      uint32_t Count = 0;
+    };
+
+    struct Emitter
+    {
+      ParticleEmitterProps Props;
+      uint32_t MaxParticles = 0;
+      // Fraction of a particle EmissionRate has built up
+      float EmissionRemainder = 0.0f;
+      uint32_t BurstCount = 0;
+
+      Ref<StorageBuffer> ParticleBuffer;
+      Ref<StorageBuffer> DeadListBuffer;
+      Ref<StorageBuffer> AliveListBuffer;
+      // Indirect draw command, draw count and dead list length
+      Ref<StorageBuffer> CounterBuffer;
+      // Alive count of the last few frames, read back once the GPU is done with it
+      std::vector<Ref<StorageBuffer>> StatisticsBuffers;
+      uint32_t FrameIndex = 0;
+
+      Ref<GPUTimer> SimulationTimer;
+      Ref<GPUTimer> DrawTimer;
+
+      ParticlePool Pool;
+      // Live particles in the layout of the particle buffer, uploaded every frame
+      std::vector<glm::vec4> Upload;
+
+      EmitterStatistics Stats;
+    };
+
+    void SimulateGPU(Emitter& emitter, uint32_t emitCount, float timestep);
+    void SimulateCPU(Emitter& emitter, uint32_t emitCount, float timestep);
+  private:
+    ParticleSimulation m_Simulation;
+    std::vector<Scope<Emitter>> m_Emitters;
+    // Changes with every emit dispatch, so particles differ between emitters and frames
+    uint32_t m_Seed = 0;
+
+    Ref<Shader> m_EmitShader;
+    Ref<Shader> m_SimulateShader;
+    Ref<Shader> m_RenderShader;
+    // Unit quad every particle is drawn as
+    Ref<VertexArray> m_QuadVertexArray;
+  };
+
+}
@@ -6,7 +6,7 @@
 namespace Ancora {
 
   PerspectiveCamera::PerspectiveCamera(float fov, float aspect, float near, float far)
-    : m_ProjectionMatrix(glm::perspective(fov, aspect, near, far))
+    : m_ProjectionMatrix(glm::perspective(fov, aspect, near, far)), m_NearClip(near), m_FarClip(far)
   {
     m_ViewMatrix = glm::lookAt(m_Position, m_Center, m_Up);
     m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
@@ -15,6 +15,8 @@ namespace Ancora {
   void PerspectiveCamera::SetProjection(float fov, float aspect, float near, float far)
   {
     m_ProjectionMatrix = glm::perspective(fov, aspect, near, far);
+    m_NearClip = near;
+    m_FarClip = far;
     m_ViewProjectionMatrix = m_ProjectionMatrix * m_ViewMatrix;
   }
 
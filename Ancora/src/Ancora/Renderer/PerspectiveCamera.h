@@ -17,6 +17,9 @@ namespace Ancora {
     const glm::vec3& GetCenter() const { return m_Center; }
     const glm::vec3& GetUp() const { return m_Up; }
 
+    float GetNearClip() const { return m_NearClip; }
+    float GetFarClip() const { return m_FarClip; }
+
     const glm::mat4& GetProjectionMatrix() const { return m_ProjectionMatrix; }
     const glm::mat4& GetViewMatrix() const { return m_ViewMatrix; }
     const glm::mat4& GetViewProjectionMatrix() const { return m_ViewProjectionMatrix; }
@@ -25,6 +28,8 @@ namespace Ancora {
     glm::mat4 m_ViewMatrix;
     glm::mat4 m_ViewProjectionMatrix;
 
+    float m_NearClip, m_FarClip;
+
     glm::vec3 m_Position = { 5.0f, 5.0f, 5.0f };
     glm::vec3 m_Center = { 0.0f, 0.0f, 0.0f };
     glm::vec3 m_Up = { -0.5f, 1.0f, -0.5f };
@@ -0,0 +1,153 @@
+#include "aepch.h"
+#include "Primitives.h"
+
+#include <glm/gtc/constants.hpp>
+
+namespace Ancora {
+
+  struct PrimitivesData
+  {
+    Ref<Model3D> Models[4];
+  };
+
+  static PrimitivesData s_Data;
+
+  // Wraps rows of vertices around the y axis. Each row is a latitude and the y offset it is moved by.
+  static Mesh GenerateRevolved(const std::vector<std::pair<float, float>>& rows, uint32_t segments, float height)
+  {
+    Mesh mesh;
+    for (const auto& [latitude, offset] : rows)
+    {
+      for (uint32_t s = 0; s <= segments; s++)
+      {
+        float longitude = glm::two_pi<float>() * (float)s / (float)segments;
+        glm::vec3 normal = { std::sin(latitude) * std::cos(longitude), std::cos(latitude), std::sin(latitude) * std::sin(longitude) };
+
+        VertexData3D vertex;
+        vertex.Position = normal * 0.5f + glm::vec3(0.0f, offset, 0.0f);
+        vertex.TexCoord = { (float)s / (float)segments, vertex.Position.y / height + 0.5f };
+        vertex.Normal = normal;
+        mesh.Vertices.push_back(vertex);
+      }
+    }
+
+    uint32_t stride = segments + 1;
+    for (uint32_t r = 0; r + 1 < (uint32_t)rows.size(); r++)
+    {
+      for (uint32_t s = 0; s < segments; s++)
+      {
+        uint32_t a = r * stride + s;
+        uint32_t b = a + stride;
+        mesh.Indices.insert(mesh.Indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+      }
+    }
+    return mesh;
+  }
+
+  void Primitives::Init()
+  {
+    Mesh meshes[] = { GenerateCube(), GenerateSphere(), GeneratePlane(), GenerateCapsule() };
+    for (uint32_t i = 0; i < 4; i++)
+    {
+      meshes[i].Upload();
+      s_Data.Models[i] = CreateRef<Model3D>();
+      s_Data.Models[i]->AddMesh(std::move(meshes[i]));
+      s_Data.Models[i]->CalculateBounds();
+    }
+  }
+
+  void Primitives::Shutdown()
+  {
+    for (auto& model : s_Data.Models)
+      model = nullptr;
+  }
+
+  const Ref<Model3D>& Primitives::Get(Primitive primitive)
+  {
+    AE_CORE_ASSERT(s_Data.Models[(int)primitive], "Primitives have not been initialized!");
+    return s_Data.Models[(int)primitive];
+  }
+
+  Mesh Primitives::GenerateCube()
+  {
+    // Normal, then two edge directions whose cross product is the normal, so every face winds counter-clockwise
+    const glm::vec3 faces[6][3] = {
+      { {  1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f } },
+      { { -1.0f,  0.0f,  0.0f }, {  0.0f,  0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f } },
+      { {  0.0f,  1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } },
+      { {  0.0f, -1.0f,  0.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f } },
+      { {  0.0f,  0.0f,  1.0f }, {  1.0f,  0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+      { {  0.0f,  0.0f, -1.0f }, { -1.0f,  0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } },
+    };
+    const glm::vec2 corners[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+
+    Mesh mesh;
+    for (const auto& face : faces)
+    {
+      uint32_t first = (uint32_t)mesh.Vertices.size();
+      for (const auto& corner : corners)
+      {
+        VertexData3D vertex;
+        vertex.Position = (face[0] + face[1] * (corner.x * 2.0f - 1.0f) + face[2] * (corner.y * 2.0f - 1.0f)) * 0.5f;
+        vertex.TexCoord = corner;
+        vertex.Normal = face[0];
+        mesh.Vertices.push_back(vertex);
+      }
+      mesh.Indices.insert(mesh.Indices.end(), { first, first + 1, first + 2, first + 2, first + 3, first });
+    }
+    return mesh;
+  }
+
+  Mesh Primitives::GenerateSphere(uint32_t segments, uint32_t rings)
+  {
+    std::vector<std::pair<float, float>> rows;
+    for (uint32_t r = 0; r <= rings; r++)
+      rows.push_back({ glm::pi<float>() * (float)r / (float)rings, 0.0f });
+    return GenerateRevolved(rows, segments, 1.0f);
+  }
+
+  Mesh Primitives::GeneratePlane(uint32_t subdivisions)
+  {
+    subdivisions = std::max(subdivisions, 1u);
+
+    Mesh mesh;
+    for (uint32_t z = 0; z <= subdivisions; z++)
+    {
+      for (uint32_t x = 0; x <= subdivisions; x++)
+      {
+        glm::vec2 t = { (float)x / (float)subdivisions, (float)z / (float)subdivisions };
+
+        VertexData3D vertex;
+        vertex.Position = { t.x - 0.5f, 0.0f, t.y - 0.5f };
+        vertex.TexCoord = t;
+        vertex.Normal = { 0.0f, 1.0f, 0.0f };
+        mesh.Vertices.push_back(vertex);
+      }
+    }
+
+    uint32_t stride = subdivisions + 1;
+    for (uint32_t z = 0; z < subdivisions; z++)
+    {
+      for (uint32_t x = 0; x < subdivisions; x++)
+      {
+        uint32_t a = z * stride + x;
+        uint32_t c = a + stride;
+        mesh.Indices.insert(mesh.Indices.end(), { a, c, a + 1, a + 1, c, c + 1 });
+      }
+    }
+    return mesh;
+  }
+
+  Mesh Primitives::GenerateCapsule(uint32_t segments, uint32_t rings)
+  {
+    // Two hemispheres half a unit above and below the origin; the repeated equator forms the cylinder
+    rings += rings % 2;
+    std::vector<std::pair<float, float>> rows;
+    for (uint32_t r = 0; r <= rings / 2; r++)
+      rows.push_back({ glm::pi<float>() * (float)r / (float)rings, 0.5f });
+    for (uint32_t r = rings / 2; r <= rings; r++)
+      rows.push_back({ glm::pi<float>() * (float)r / (float)rings, -0.5f });
+    return GenerateRevolved(rows, segments, 2.0f);
+  }
+
+}
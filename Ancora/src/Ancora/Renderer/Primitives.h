@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Ancora/Renderer/Model3D.h"
+
+namespace Ancora {
+
+  enum class Primitive
+  {
+    Cube = 0, Sphere, Plane, Capsule
+  };
+
+  // Built-in meshes, generated and uploaded once at startup. The cube and the plane span
+  // -0.5 to 0.5, the sphere has a radius of 0.5 and the capsule is a 0.5 radius pill,
+  // 2 units tall along y. The plane lies in xz and faces +y.
+  class Primitives
+  {
+  public:
+    static void Init();
+    static void Shutdown();
+
+    static const Ref<Model3D>& Get(Primitive primitive);
+
+    // CPU-side geometry, not uploaded
+    static Mesh GenerateCube();
+    static Mesh GenerateSphere(uint32_t segments = 32, uint32_t rings = 16);
+    static Mesh GeneratePlane(uint32_t subdivisions = 1);
+    static Mesh GenerateCapsule(uint32_t segments = 32, uint32_t rings = 16);
+  };
+
+}
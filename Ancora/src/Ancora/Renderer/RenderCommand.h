@@ -12,6 +12,11 @@ namespace Ancora {
       s_RendererAPI->Init();
     }
 
+    inline static const RendererAPI::Capabilities& GetCapabilities()
+    {
+      return s_RendererAPI->GetCapabilities();
+    }
+
     inline static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
     {
       s_RendererAPI->SetViewport(x, y, width, height);
@@ -27,9 +32,64 @@ namespace Ancora {
       s_RendererAPI->Clear();
     }
 
-    inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0)
+    inline static void SetDepthFunction(DepthFunction function)
+    {
+      s_RendererAPI->SetDepthFunction(function);
+    }
+
+    inline static void SetDepthWrite(bool enabled)
+    {
+      s_RendererAPI->SetDepthWrite(enabled);
+    }
+
+    inline static void SetColorWrite(bool enabled)
+    {
+      s_RendererAPI->SetColorWrite(enabled);
+    }
+
+    inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t indexOffset = 0, uint32_t baseVertex = 0)
+    {
+      s_RendererAPI->DrawIndexed(vertexArray, indexCount, indexOffset, baseVertex);
+    }
+
+    inline static void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commandBuffer, const Ref<StorageBuffer>& drawCountBuffer, uint32_t maxDrawCount, uint32_t commandOffset = 0, uint32_t drawCountOffset = 0)
+    {
+      s_RendererAPI->DrawIndexedIndirect(vertexArray, commandBuffer, drawCountBuffer, maxDrawCount, commandOffset, drawCountOffset);
+    }
+
+    inline static void DispatchCompute(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1)
+    {
+      s_RendererAPI->DispatchCompute(groupsX, groupsY, groupsZ);
+    }
+
+    inline static void Barrier(uint32_t bits)
+    {
+      s_RendererAPI->Barrier(bits);
+    }
+
+    inline static void SetStateValidation(bool enabled)
+    {
+      s_RendererAPI->SetStateValidation(enabled);
+    }
+
+    inline static bool GetStateValidation()
+    {
+      return s_RendererAPI->GetStateValidation();
+    }
+
+    inline static void InvalidateState()
+    {
+      s_RendererAPI->InvalidateState();
+    }
+
+    inline static void ResetStateStats()
+    {
+      s_RendererAPI->ResetStateStats();
+    }
+
+    inline static RendererAPI::StateStatistics GetStateStats()
     {
-      s_RendererAPI->DrawIndexed(vertexArray, indexCount);
+      return s_RendererAPI->GetStateStats();
     }
   private:
     static RendererAPI* s_RendererAPI;
@@ -18,6 +18,7 @@ namespace Ancora {
   void Renderer::OnWindowResize(uint32_t width, uint32_t height)
   {
     RenderCommand::SetViewport(0, 0, width, height);
+    Renderer3D::OnWindowResize(width, height);
   }
 
   void Renderer::BeginScene(OrthographicCamera& camera)
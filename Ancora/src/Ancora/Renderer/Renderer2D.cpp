@@ -4,16 +4,46 @@
 #include "Ancora/Renderer/VertexArray.h"
 #include "Ancora/Renderer/Shader.h"
 #include "Ancora/Renderer/RenderCommand.h"
+#include "Ancora/Renderer/StreamingBuffer.h"
+
+#include <cstring>
 
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace Ancora {
 
+  struct QuadVertex
+  {
+    glm::vec3 Position;
+    glm::vec4 Color;
+    glm::vec2 TexCoord;
+    float TexIndex;
+    float TilingFactor;
+  };
+
   struct Renderer2DStorage
   {
+    static constexpr uint32_t MaxQuads = 10000;
+    static constexpr uint32_t MaxVertices = MaxQuads * 4;
+    static constexpr uint32_t MaxIndices = MaxQuads * 6;
+    // Has to match Texture.glsl
+    static constexpr uint32_t MaxTextureSlots = 16;
+
+    Ref<StreamingBuffer> QuadBuffer;
     Ref<VertexArray> QuadVertexArray;
     Ref<Shader> TextureShader;
     Ref<Texture2D> WhiteTexture;
+
+    // The batch is gathered here and copied into QuadBuffer in one go when it is drawn, since
+    // the part of QuadBuffer it would be written to is only known then
+    std::vector<QuadVertex> QuadVertices;
+    std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+    // Slot 0 is the white texture
+    uint32_t TextureSlotCount = 1;
+
+    glm::vec4 QuadVertexPositions[4];
+
+    Renderer2D::Statistics Stats;
   };
 
   static Renderer2DStorage* s_Data;
@@ -22,40 +52,47 @@ namespace Ancora {
   {
     s_Data = new Renderer2DStorage();
 
+    s_Data->QuadBuffer = StreamingBuffer::Create(Renderer2DStorage::MaxVertices * sizeof(QuadVertex));
     s_Data->QuadVertexArray = VertexArray::Create();
 
-    float vertices[] = {
-      -0.75f, -0.75f,  0.0f, 0.0f, 0.0f,
-       0.75f, -0.75f,  0.0f, 1.0f, 0.0f,
-       0.75f,  0.75f,  0.0f, 1.0f, 1.0f,
-      -0.75f,  0.75f,  0.0f, 0.0f, 1.0f
-    };
-
     Ref<VertexBuffer> vertexBuffer;
-    vertexBuffer = VertexBuffer::Create(vertices, sizeof(vertices));
+    vertexBuffer = VertexBuffer::Create(s_Data->QuadBuffer);
     BufferLayout layout = {
       { ShaderDataType::Float3, "a_Position" },
-      { ShaderDataType::Float2, "a_TexCoord" }
+      { ShaderDataType::Float4, "a_Color" },
+      { ShaderDataType::Float2, "a_TexCoord" },
+      { ShaderDataType::Float, "a_TexIndex" },
+      { ShaderDataType::Float, "a_TilingFactor" }
     };
     vertexBuffer->SetLayout(layout);
     s_Data->QuadVertexArray->AddVertexBuffer(vertexBuffer);
 
-    uint32_t indices[6] = {
-      0, 1, 2,
-      2, 3, 0
-    };
+    // Every batch starts at its own base vertex, so 16 bit indices are enough
+    std::vector<uint16_t> indices(Renderer2DStorage::MaxIndices);
+    for (uint32_t quad = 0; quad < Renderer2DStorage::MaxQuads; quad++)
+    {
+      uint16_t first = (uint16_t)(quad * 4);
+      uint16_t quadIndices[6] = { 0, 1, 2, 2, 3, 0 };
+      for (uint32_t i = 0; i < 6; i++)
+        indices[quad * 6 + i] = first + quadIndices[i];
+    }
 
     Ref<IndexBuffer> indexBuffer;
-    indexBuffer = IndexBuffer::Create(indices, sizeof(indices) / sizeof(uint32_t));
+    indexBuffer = IndexBuffer::Create(indices.data(), (uint32_t)indices.size());
     s_Data->QuadVertexArray->SetIndexBuffer(indexBuffer);
 
     s_Data->WhiteTexture = Texture2D::Create(1, 1);
     uint32_t whiteTextureData = 0xffffffff;
     s_Data->WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
+    s_Data->TextureSlots[0] = s_Data->WhiteTexture;
+
+    s_Data->QuadVertices.reserve(Renderer2DStorage::MaxVertices);
+    s_Data->QuadVertexPositions[0] = { -0.75f, -0.75f, 0.0f, 1.0f };
+    s_Data->QuadVertexPositions[1] = {  0.75f, -0.75f, 0.0f, 1.0f };
+    s_Data->QuadVertexPositions[2] = {  0.75f,  0.75f, 0.0f, 1.0f };
+    s_Data->QuadVertexPositions[3] = { -0.75f,  0.75f, 0.0f, 1.0f };
 
     s_Data->TextureShader = Shader::Create("Sandbox/assets/shaders/Texture.glsl");
-    s_Data->TextureShader->Bind();
-    s_Data->TextureShader->SetInt("u_Texture", 0);
   }
 
   void Renderer2D::Shutdown()
@@ -71,7 +108,59 @@ namespace Ancora {
 
   void Renderer2D::EndScene()
   {
+    Flush();
+  }
+
+  void Renderer2D::Flush()
+  {
+    if (s_Data->QuadVertices.empty())
+      return;
+
+    uint32_t size = (uint32_t)(s_Data->QuadVertices.size() * sizeof(QuadVertex));
+    StreamingBuffer::Allocation allocation = s_Data->QuadBuffer->Allocate(size, sizeof(QuadVertex));
+    std::memcpy(allocation.Data, s_Data->QuadVertices.data(), size);
+
+    for (uint32_t i = 0; i < s_Data->TextureSlotCount; i++)
+      s_Data->TextureSlots[i]->Bind(i);
+
+    s_Data->TextureShader->Bind();
+    s_Data->QuadVertexArray->Bind();
+    uint32_t quadCount = (uint32_t)s_Data->QuadVertices.size() / 4;
+    RenderCommand::DrawIndexed(s_Data->QuadVertexArray, quadCount * 6, 0, allocation.Offset / sizeof(QuadVertex));
+    s_Data->Stats.DrawCalls++;
+
+    s_Data->QuadVertices.clear();
+    for (uint32_t i = 1; i < s_Data->TextureSlotCount; i++)
+      s_Data->TextureSlots[i] = nullptr;
+    s_Data->TextureSlotCount = 1;
+  }
+
+  static float GetTextureSlot(const Ref<Texture2D>& texture)
+  {
+    for (uint32_t i = 0; i < s_Data->TextureSlotCount; i++)
+    {
+      if (s_Data->TextureSlots[i] == texture)
+        return (float)i;
+    }
 
+    if (s_Data->TextureSlotCount == Renderer2DStorage::MaxTextureSlots)
+      Renderer2D::Flush();
+
+    s_Data->TextureSlots[s_Data->TextureSlotCount] = texture;
+    return (float)s_Data->TextureSlotCount++;
+  }
+
+  static void SubmitQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, int tilingFactor, const glm::vec4& color)
+  {
+    if (s_Data->QuadVertices.size() == Renderer2DStorage::MaxVertices)
+      Renderer2D::Flush();
+
+    float textureSlot = GetTextureSlot(texture);
+    static const glm::vec2 texCoords[4] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+    for (uint32_t i = 0; i < 4; i++)
+      s_Data->QuadVertices.push_back({ glm::vec3(transform * s_Data->QuadVertexPositions[i]), color, texCoords[i], textureSlot, (float)tilingFactor });
+
+    s_Data->Stats.QuadCount++;
   }
 
   void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
@@ -81,14 +170,7 @@ namespace Ancora {
 
   void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color)
   {
-    s_Data->TextureShader->SetInt("u_TilingFactor", 1);
-    s_Data->TextureShader->SetFloat4("u_Color", color);
-    s_Data->WhiteTexture->Bind();
-
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3({ size.x, size.y, 1.0f }));
-    s_Data->TextureShader->SetMat4("u_Transform", transform);
-
-    RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+    DrawQuad(position, size, s_Data->WhiteTexture, 1, color);
   }
 
   void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor, const glm::vec4& color)
@@ -98,15 +180,8 @@ namespace Ancora {
 
   void Renderer2D::DrawQuad(const glm::vec3& position, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor, const glm::vec4& color)
   {
-    s_Data->TextureShader->SetInt("u_TilingFactor", tilingFactor);
-    s_Data->TextureShader->SetFloat4("u_Color", color);
-    texture->Bind();
-
     glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), glm::vec3({ size.x, size.y, 1.0f }));
-    s_Data->TextureShader->SetMat4("u_Transform", transform);
-
-    s_Data->QuadVertexArray->Bind();
-    RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+    SubmitQuad(transform, texture, tilingFactor, color);
   }
 
   void Renderer2D::DrawRotatedQuad(const glm::vec2& position, float rotation, const glm::vec2& size, const glm::vec4& color)
@@ -116,16 +191,7 @@ namespace Ancora {
 
   void Renderer2D::DrawRotatedQuad(const glm::vec3& position, float rotation, const glm::vec2& size, const glm::vec4& color)
   {
-    s_Data->TextureShader->SetInt("u_TilingFactor", 1);
-    s_Data->TextureShader->SetFloat4("u_Color", color);
-    s_Data->WhiteTexture->Bind();
-
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
-      * glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
-      * glm::scale(glm::mat4(1.0f), glm::vec3({ size.x, size.y, 1.0f }));
-    s_Data->TextureShader->SetMat4("u_Transform", transform);
-
-    RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+    DrawRotatedQuad(position, rotation, size, s_Data->WhiteTexture, 1, color);
   }
 
   void Renderer2D::DrawRotatedQuad(const glm::vec2& position, float rotation, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor, const glm::vec4& color)
@@ -135,19 +201,20 @@ namespace Ancora {
 
   void Renderer2D::DrawRotatedQuad(const glm::vec3& position, float rotation, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor, const glm::vec4& color)
   {
-    s_Data->TextureShader->SetInt("u_TilingFactor", tilingFactor);
-    s_Data->TextureShader->SetFloat4("u_Color", color);
-    texture->Bind();
-
     glm::mat4 transform = glm::translate(glm::mat4(1.0f), position)
       * glm::rotate(glm::mat4(1.0f), rotation, { 0.0f, 0.0f, 1.0f })
       * glm::scale(glm::mat4(1.0f), glm::vec3({ size.x, size.y, 1.0f }));
-    s_Data->TextureShader->SetMat4("u_Transform", transform);
-
-    s_Data->QuadVertexArray->Bind();
-    RenderCommand::DrawIndexed(s_Data->QuadVertexArray);
+    SubmitQuad(transform, texture, tilingFactor, color);
   }
 
+  void Renderer2D::ResetStats()
+  {
+    s_Data->Stats = Statistics();
+  }
 
+  Renderer2D::Statistics Renderer2D::GetStats()
+  {
+    return s_Data->Stats;
+  }
 
 }
@@ -25,6 +25,18 @@ namespace Ancora {
     static void DrawRotatedQuad(const glm::vec3& position, float rotation, const glm::vec2& size, const glm::vec4& color);
     static void DrawRotatedQuad(const glm::vec2& position, float rotation, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor = 1, const glm::vec4& color = glm::vec4(1.0f));
     static void DrawRotatedQuad(const glm::vec3& position, float rotation, const glm::vec2& size, const Ref<Texture2D>& texture, int tilingFactor = 1, const glm::vec4& color = glm::vec4(1.0f));
+
+    // Quads are batched and drawn when the batch is full, runs out of texture slots, or at EndScene()
+    static void Flush();
+
+    struct Statistics
+    {
+      uint32_t DrawCalls = 0;
+      uint32_t QuadCount = 0;
+    };
+
+    static void ResetStats();
+    static Statistics GetStats();
   };
 
 }
@@ -4,332 +4,1075 @@
 #include "Ancora/Renderer/VertexArray.h"
 #include "Ancora/Renderer/Shader.h"
 #include "Ancora/Renderer/RenderCommand.h"
+#include "Ancora/Renderer/Frustum.h"
+#include "Ancora/Renderer/HiZBuffer.h"
+#include "Ancora/Renderer/Framebuffer.h"
+#include "Ancora/Renderer/ShadowMap.h"
+#include "Ancora/Renderer/Primitives.h"
+#include "Ancora/Renderer/Material.h"
+#include "Ancora/Core/JobSystem.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <chrono>
+
 namespace Ancora {
 
-  struct Renderer3DStorage
+  struct ModelDrawCommand
+  {
+    Ref<Model3D> Model;
+    glm::mat4 Transform;
+    // Replaces the materials of every mesh when set
+    Ref<Material> MaterialOverride;
+    // Multiplied into the material color; white unless drawn with a flat color
+    glm::vec4 Color;
+    uint32_t LOD;
+    // Squared distance from the camera, for front-to-back sorting
+    float Distance;
+  };
+
+  // One mesh of a queued model, the unit the lit pass sorts and draws
+  struct MeshDrawCommand
+  {
+    const Mesh* DrawMesh;
+    const Material* DrawMaterial;
+    const Shader* DrawShader;
+    const glm::mat4* Transform;
+    const glm::vec4* Color;
+    uint32_t LOD;
+    float Distance;
+  };
+
+  // Last LOD of every instance, keyed by model and by the order it is drawn in within a scene
+  struct LODHistory
+  {
+    std::unordered_map<const Model3D*, std::vector<uint8_t>> InstanceLODs;
+    std::unordered_map<const Model3D*, uint32_t> InstanceCursors;
+  };
+
+  // Material binding of a command buffer as it is drawn: flat colors are the default material
+  // with that color
+  struct ReplayMaterial
   {
-    const uint32_t MaxTriangles = 50000;
-    const uint32_t MaxVertices = MaxTriangles * 3;
-    const uint32_t MaxIndices = MaxTriangles * 3;
+    Ref<Material> BoundMaterial;
+    glm::vec4 Color;
+  };
+
+  // Scratch space of one command buffer during Submit()
+  struct CommandBufferReplay
+  {
+    // Registered version of each material binding
+    std::vector<ReplayMaterial> Materials;
+    std::vector<ModelDrawCommand> Draws;
+  };
+
+  struct SkyBoxDrawCommand
+  {
+    Ref<CubeMap> Texture;
+    glm::mat4 Transform;
+  };
+
+  struct ShadowCascade
+  {
+    glm::mat4 ViewProjection = glm::mat4(1.0f);
+    // Snapped light space center and half extent of what was last rendered
+    glm::vec3 Center = glm::vec3(0.0f);
+    float Radius = 0.0f;
+    float TexelSize = 0.0f;
+    bool Valid = false;
+  };
 
-    Ref<VertexArray> QuadVertexArray;
-    Ref<VertexBuffer> QuadVertexBuffer;
-    Ref<IndexBuffer> QuadIndexBuffer;
-    Ref<Shader> QuadShader;
+  struct Renderer3DStorage
+  {
+    // Position-only unit cube the sky box is drawn with
+    Ref<VertexArray> SkyBoxVertexArray;
     Ref<Shader> CubeMapShader;
     Ref<Shader> LightingShader;
-    Ref<Texture2D> WhiteTexture;
-    Ref<Texture2D> ColorTexture;
+    Ref<Shader> StaticMeshShader;
+    Ref<Shader> StaticMeshCullShader;
+    Ref<Shader> DepthShader;
+    Ref<Shader> StaticMeshDepthShader;
+
+    Renderer3DSceneData SceneData;
+
+    // Everything submitted since BeginScene
+    std::vector<ModelDrawCommand> ModelQueue;
+    std::vector<Ref<StaticMeshBatch>> StaticMeshBatchQueue;
+    std::vector<SkyBoxDrawCommand> SkyBoxQueue;
+    std::vector<Ref<ParticleSystem>> ParticleQueue;
+    std::vector<MeshDrawCommand> MeshQueue;
+
+    // State of the lit pass, so draws that share a shader or a material do not set it again
+    const Shader* BoundShader = nullptr;
+    const Material* BoundMaterial = nullptr;
+    // Shaders whose scene uniforms are set for the current scene
+    std::vector<const Shader*> PreparedShaders;
+
+    // Fraction of the screen height covered by a model below which LOD i + 1 is used.
+    // A model has to get Hysteresis further past a threshold before it switches back.
+    const float LODScreenSizes[Mesh::MaxLODs - 1] = { 0.3f, 0.15f, 0.07f, 0.03f };
+    const float LODHysteresis = 0.15f;
+
+    // Of the immediate draws
+    LODHistory ImmediateLODs;
+    // Command buffers draw in their own order, so each has its own history
+    std::unordered_map<const CommandBuffer*, LODHistory> CommandBufferLODs;
+    std::unordered_set<const CommandBuffer*> SubmittedCommandBuffers;
+    std::vector<CommandBufferReplay> CommandBufferReplays;
+
+    // Opaques are drawn depth-only first so the lit pass shades every pixel once
+    bool DepthPrePass = true;
+
+    bool OcclusionCulling = true;
+    Ref<HiZBuffer> HiZ;
+    // Latest CPU copy of the pyramid, used by the immediate draws of this scene
+    const HiZReadback* OcclusionReadback = nullptr;
+
+    Ref<ShadowMap> Shadows;
+    ShadowCascade Cascades[ShadowSettings::MaxCascades];
+    glm::vec3 ShadowLightDirection = glm::vec3(0.0f);
+    // Cascades cover this much more than their slice, so a cached one stays valid while the camera moves
+    const float CascadeMargin = 0.1f;
+    // Below the texture table pages
+    const uint32_t ShadowMapSlot = 15;
+    uint64_t FrameIndex = 0;
+
+    // The scene is drawn into SceneFramebuffer at ResolutionScale times the window size,
+    // resolved into ResolveFramebuffer when multisampled and stretched over the window in EndScene
+    Ref<Framebuffer> SceneFramebuffer;
+    Ref<Framebuffer> ResolveFramebuffer;
+    uint32_t ViewportWidth = 0, ViewportHeight = 0;
+    uint32_t MSAASamples = 4;
+    float ResolutionScale = 1.0f;
+
+    bool DynamicResolution = false;
+    float TargetFrameTime = 1.0f / 60.0f;
+    float AverageFrameTime = 1.0f / 60.0f;
+    // Frames to wait after a change, so the new scale shows up in the average first
+    uint32_t ResolutionCooldown = 0;
+    std::chrono::steady_clock::time_point LastSceneTime;
+    const float MinResolutionScale = 0.5f;
+    const float ResolutionScaleStep = 0.05f;
+
+    Renderer3D::Statistics Stats;
   };
 
   static Renderer3DStorage s_Data;
 
-  void Renderer3D::Init()
+  static void InvalidateFramebuffers()
   {
-    s_Data.QuadVertexArray = VertexArray::Create();
+    if (s_Data.ViewportWidth == 0 || s_Data.ViewportHeight == 0)
+      return;
 
-    s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(VertexData3D));
-    BufferLayout layout = {
-      { ShaderDataType::Float3, "a_Position" },
-      { ShaderDataType::Float2, "a_TexCoord" },
-      { ShaderDataType::Float3, "a_Normal" }
-    };
-    s_Data.QuadVertexBuffer->SetLayout(layout);
-    s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
+    FramebufferSpecification spec;
+    spec.Width = std::max((uint32_t)(s_Data.ViewportWidth * s_Data.ResolutionScale), 1u);
+    spec.Height = std::max((uint32_t)(s_Data.ViewportHeight * s_Data.ResolutionScale), 1u);
+    spec.Attachments = { FramebufferTextureFormat::RGBA8, FramebufferTextureFormat::Depth };
+    spec.Samples = s_Data.MSAASamples;
 
-    s_Data.QuadIndexBuffer = IndexBuffer::Create(s_Data.MaxIndices);
-    s_Data.QuadVertexArray->SetIndexBuffer(s_Data.QuadIndexBuffer);
+    if (!s_Data.SceneFramebuffer || s_Data.SceneFramebuffer->GetSpecification().Samples != spec.Samples)
+      s_Data.SceneFramebuffer = Framebuffer::Create(spec);
+    else
+      s_Data.SceneFramebuffer->Resize(spec.Width, spec.Height);
 
-    s_Data.WhiteTexture = Texture2D::Create(1, 1);
-    uint32_t whiteTextureData = 0xffffffff;
-    s_Data.WhiteTexture->SetData(&whiteTextureData, sizeof(uint32_t));
+    if (spec.Samples > 1)
+    {
+      spec.Samples = 1;
+      if (!s_Data.ResolveFramebuffer)
+        s_Data.ResolveFramebuffer = Framebuffer::Create(spec);
+      else
+        s_Data.ResolveFramebuffer->Resize(spec.Width, spec.Height);
+    }
+    else
+      s_Data.ResolveFramebuffer = nullptr;
+  }
 
-    s_Data.ColorTexture = Texture2D::Create(1, 1);
+  // Single-sampled copy of what has been drawn so far
+  static const Ref<Framebuffer>& ResolveScene()
+  {
+    if (!s_Data.ResolveFramebuffer)
+      return s_Data.SceneFramebuffer;
 
-    s_Data.QuadShader = Shader::Create("Sandbox/assets/shaders/FlatColor.glsl");
-    s_Data.CubeMapShader = Shader::Create("Sandbox/assets/shaders/CubeMap.glsl");
-    s_Data.LightingShader = Shader::Create("Sandbox/assets/shaders/Lighting.glsl");
+    s_Data.SceneFramebuffer->Resolve(s_Data.ResolveFramebuffer);
+    return s_Data.ResolveFramebuffer;
   }
 
-  void Renderer3D::Shutdown()
+  static void UpdateResolutionScale()
   {
+    auto now = std::chrono::steady_clock::now();
+    float frameTime = std::chrono::duration<float>(now - s_Data.LastSceneTime).count();
+    s_Data.LastSceneTime = now;
+
+    // Ignore hitches such as loading screens or a paused window
+    if (!s_Data.DynamicResolution || frameTime > 0.25f)
+      return;
+
+    s_Data.AverageFrameTime += (frameTime - s_Data.AverageFrameTime) * 0.1f;
+    if (s_Data.ResolutionCooldown > 0)
+    {
+      s_Data.ResolutionCooldown--;
+      return;
+    }
+
+    float scale = s_Data.ResolutionScale;
+    if (s_Data.AverageFrameTime > s_Data.TargetFrameTime * 1.05f)
+      scale = std::max(scale - s_Data.ResolutionScaleStep, s_Data.MinResolutionScale);
+    else if (s_Data.AverageFrameTime < s_Data.TargetFrameTime * 0.85f)
+      scale = std::min(scale + s_Data.ResolutionScaleStep, 1.0f);
+
+    if (scale != s_Data.ResolutionScale)
+    {
+      s_Data.ResolutionScale = scale;
+      s_Data.ResolutionCooldown = 30;
+      InvalidateFramebuffers();
+    }
   }
 
-  void Renderer3D::BeginScene(const Renderer3DSceneData& sceneData)
+  // lastLOD is what the same instance used in the last scene, for hysteresis, and is updated
+  static uint32_t SelectLOD(const Model3D& model, const glm::mat4& transform, uint8_t& lastLOD)
   {
-    s_Data.QuadShader->Bind();
-    s_Data.QuadShader->SetMat4("u_ViewProjection", sceneData.Camera->GetViewProjectionMatrix());
-    s_Data.CubeMapShader->Bind();
-    s_Data.CubeMapShader->SetMat4("u_ViewProjection", sceneData.Camera->GetViewProjectionMatrix());
-    s_Data.LightingShader->Bind();
-    s_Data.LightingShader->SetMat4("u_ViewProjection", sceneData.Camera->GetViewProjectionMatrix());
-    s_Data.LightingShader->SetFloat3("u_CameraPosition", sceneData.Camera->GetPosition());
-    s_Data.LightingShader->SetFloat3("u_DirLight.direction", sceneData.DirLight->GetDirection());
-    s_Data.LightingShader->SetFloat3("u_DirLight.ambient", sceneData.DirLight->GetAmbient());
-    s_Data.LightingShader->SetFloat3("u_DirLight.diffuse", sceneData.DirLight->GetDiffuse());
-    s_Data.LightingShader->SetFloat3("u_DirLight.specular", sceneData.DirLight->GetSpecular());
+    uint32_t lodCount = model.GetLODCount();
+    if (lodCount == 1)
+      return 0;
+
+    const glm::vec3& boundsMin = model.GetBoundsMin();
+    const glm::vec3& boundsMax = model.GetBoundsMax();
+    float scale = std::max(glm::length(glm::vec3(transform[0])), std::max(glm::length(glm::vec3(transform[1])), glm::length(glm::vec3(transform[2]))));
+    float radius = glm::length(boundsMax - boundsMin) * 0.5f * scale;
+    glm::vec3 center = glm::vec3(transform * glm::vec4((boundsMin + boundsMax) * 0.5f, 1.0f));
+
+    // Projected bounding sphere diameter over the screen height
+    const auto& camera = s_Data.SceneData.Camera;
+    float distance = glm::distance(center, camera->GetPosition());
+    float screenSize = distance > radius ? radius * camera->GetProjectionMatrix()[1][1] / distance : 1.0f;
+
+    uint32_t lod = std::min<uint32_t>(lastLOD, lodCount - 1);
+    while (lod + 1 < lodCount && screenSize < s_Data.LODScreenSizes[lod] * (1.0f - s_Data.LODHysteresis))
+      lod++;
+    while (lod > 0 && screenSize > s_Data.LODScreenSizes[lod - 1] * (1.0f + s_Data.LODHysteresis))
+      lod--;
+
+    lastLOD = (uint8_t)lod;
+    return lod;
   }
 
-  void Renderer3D::EndScene()
+  static uint32_t SelectLOD(LODHistory& lodHistory, const Ref<Model3D>& model, const glm::mat4& transform)
   {
+    uint32_t instance = lodHistory.InstanceCursors[model.get()]++;
+    auto& history = lodHistory.InstanceLODs[model.get()];
+    if (history.size() <= instance)
+      history.resize(instance + 1, 0);
+
+    return SelectLOD(*model, transform, history[instance]);
   }
 
-  void Renderer3D::SkyBox(Ref<CubeMap> cubeMap, const glm::vec3& position, const glm::vec3& size)
+  static uint32_t SelectLOD(const Ref<Model3D>& model, const glm::mat4& transform)
   {
-    s_Data.CubeMapShader->Bind();
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), size);
-    s_Data.CubeMapShader->SetMat4("u_Transform", transform);
+    return SelectLOD(s_Data.ImmediateLODs, model, transform);
+  }
 
-    cubeMap->Bind(0);
-    s_Data.CubeMapShader->SetInt("u_Skybox", 0);
+  // Forgets the LODs of models that were not drawn since the last call
+  static void TrimLODHistory(LODHistory& lodHistory)
+  {
+    for (auto it = lodHistory.InstanceLODs.begin(); it != lodHistory.InstanceLODs.end(); )
+    {
+      if (lodHistory.InstanceCursors.find(it->first) == lodHistory.InstanceCursors.end())
+        it = lodHistory.InstanceLODs.erase(it);
+      else
+        ++it;
+    }
+    lodHistory.InstanceCursors.clear();
+  }
 
-    float vertexData[] = {
-      // -x
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f, -0.5f,  0.5f, 1.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f,  0.5f, -0.5f, 0.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-
-      // +x
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-       0.5f,  0.5f, -0.5f, 1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-       0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-
-      // -y
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  0.0f, -1.0f,  0.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 0.0f,  0.0f, -1.0f,  0.0f,
-       0.5f, -0.5f,  0.5f, 1.0f, 1.0f,  0.0f, -1.0f,  0.0f,
-      -0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  0.0f, -1.0f,  0.0f,
-
-      // +y
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  0.0f,  1.0f,  0.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,  0.0f,  1.0f,  0.0f,
-      -0.5f,  0.5f, -0.5f, 1.0f, 1.0f,  0.0f,  1.0f,  0.0f,
-       0.5f,  0.5f, -0.5f, 0.0f, 1.0f,  0.0f,  1.0f,  0.0f,
-
-      // -z
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-       0.5f,  0.5f, -0.5f, 1.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-      -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-
-      // +z
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-      -0.5f, -0.5f,  0.5f, 1.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-       0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-    };
+  // World space box around transformed local bounds
+  static void TransformBounds(const glm::vec3& localMin, const glm::vec3& localMax, const glm::mat4& transform, glm::vec3& boundsMin, glm::vec3& boundsMax)
+  {
+    glm::vec3 center = glm::vec3(transform * glm::vec4((localMin + localMax) * 0.5f, 1.0f));
+    glm::vec3 halfSize = (localMax - localMin) * 0.5f;
+    glm::vec3 extent = glm::abs(glm::vec3(transform[0])) * halfSize.x + glm::abs(glm::vec3(transform[1])) * halfSize.y + glm::abs(glm::vec3(transform[2])) * halfSize.z;
+
+    boundsMin = center - extent;
+    boundsMax = center + extent;
+  }
+
+  // Squared distance from the camera to the center of the model's bounds
+  static float GetCameraDistance(const Ref<Model3D>& model, const glm::mat4& transform)
+  {
+    glm::vec3 center = glm::vec3(transform * glm::vec4((model->GetBoundsMin() + model->GetBoundsMax()) * 0.5f, 1.0f));
+    glm::vec3 offset = center - s_Data.SceneData.Camera->GetPosition();
+    return glm::dot(offset, offset);
+  }
+
+  static bool IsOccluded(const Ref<Model3D>& model, const glm::mat4& transform)
+  {
+    if (!s_Data.OcclusionReadback)
+      return false;
+
+    glm::vec3 boundsMin, boundsMax;
+    TransformBounds(model->GetBoundsMin(), model->GetBoundsMax(), transform, boundsMin, boundsMax);
+    return HiZBuffer::IsOccluded(*s_Data.OcclusionReadback, boundsMin, boundsMax);
+  }
 
-    s_Data.QuadVertexBuffer->SetData(vertexData, sizeof(vertexData));
+  static_assert(TextureTable::FirstPageUnit > 15, "Texture table pages overlap the shadow map unit");
 
-    uint32_t indices[36];
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < 36; i += 6)
+  static void DrawMesh(const Mesh& mesh, uint32_t lod)
+  {
+    AE_CORE_ASSERT(mesh.MeshVertexArray, "Mesh has not been uploaded!");
+    lod = std::min(lod, (uint32_t)mesh.LODs.size() - 1);
+    const MeshLOD& range = mesh.LODs[lod];
+
+    mesh.MeshVertexArray->Bind();
+    RenderCommand::DrawIndexed(mesh.MeshVertexArray, range.IndexCount, range.IndexOffset);
+
+    s_Data.Stats.DrawCalls++;
+    s_Data.Stats.LODTriangleCount[lod] += range.IndexCount / 3;
+  }
+
+  // Unused command slots must stay zero for drivers without indirect count support
+  static void ResetStaticMeshBatchCommands(const Ref<StaticMeshBatch>& batch)
+  {
+    uint32_t zero = 0;
+    batch->GetCommandBuffer()->Clear();
+    batch->GetDrawCountBuffer()->SetData(&zero, sizeof(uint32_t), StaticMeshBatch::FirstPhaseCounter * sizeof(uint32_t));
+  }
+
+  // Runs one phase of the cull shader over the bound batch. LODs always follow the camera.
+  static void CullStaticMeshBatch(const Ref<StaticMeshBatch>& batch, const glm::mat4& cullViewProjection, uint32_t phase, bool occlusionCulling)
+  {
+    const auto& camera = s_Data.SceneData.Camera;
+    Frustum frustum(cullViewProjection);
+
+    s_Data.StaticMeshCullShader->Bind();
+    s_Data.StaticMeshCullShader->SetInt("u_InstanceCount", (int)batch->GetInstanceCount());
+    for (int i = 0; i < 6; i++)
+      s_Data.StaticMeshCullShader->SetFloat4("u_FrustumPlanes[" + std::to_string(i) + "]", frustum.Planes[i]);
+    s_Data.StaticMeshCullShader->SetFloat3("u_CameraPosition", camera->GetPosition());
+    s_Data.StaticMeshCullShader->SetFloat("u_ProjectionScale", camera->GetProjectionMatrix()[1][1]);
+    s_Data.StaticMeshCullShader->SetFloat4("u_LODScreenSizes", { s_Data.LODScreenSizes[0], s_Data.LODScreenSizes[1], s_Data.LODScreenSizes[2], s_Data.LODScreenSizes[3] });
+    s_Data.StaticMeshCullShader->SetMat4("u_ViewProjection", cullViewProjection);
+    s_Data.StaticMeshCullShader->SetInt("u_OcclusionCulling", occlusionCulling ? 1 : 0);
+    s_Data.StaticMeshCullShader->SetInt("u_Phase", (int)phase);
+
+    RenderCommand::DispatchCompute((batch->GetInstanceCount() + 63) / 64);
+    // For the indirect draw and the next phase, and for the counter resets and readback
+    RenderCommand::Barrier(StorageBarrier | IndirectCommandBarrier | BufferUpdateBarrier);
+  }
+
+  static void DrawStaticMeshBatchPhase(const Ref<StaticMeshBatch>& batch, const Ref<Shader>& shader, uint32_t phase)
+  {
+    uint32_t instanceCount = batch->GetInstanceCount();
+    uint32_t counter = phase == 0 ? StaticMeshBatch::FirstPhaseCounter : StaticMeshBatch::SecondPhaseCounter;
+
+    shader->Bind();
+    shader->SetInt("u_DrawOffset", (int)(phase * instanceCount));
+    batch->GetVertexArray()->Bind();
+    RenderCommand::DrawIndexedIndirect(batch->GetVertexArray(), batch->GetCommandBuffer(), batch->GetDrawCountBuffer(), instanceCount,
+      phase * instanceCount * StaticMeshBatch::DrawCommandSize, counter * sizeof(uint32_t));
+    s_Data.Stats.DrawCalls++;
+  }
+
+  // Bounding sphere of the part of the view frustum between two view distances
+  static void GetFrustumSliceBounds(float sliceNear, float sliceFar, glm::vec3& center, float& radius)
+  {
+    const auto& camera = s_Data.SceneData.Camera;
+    glm::mat4 inverseViewProjection = glm::inverse(camera->GetViewProjectionMatrix());
+    float nearClip = camera->GetNearClip();
+    float farClip = camera->GetFarClip();
+
+    glm::vec3 corners[8];
+    for (int i = 0; i < 4; i++)
     {
-      indices[i + 0] = offset + 0;
-      indices[i + 1] = offset + 1;
-      indices[i + 2] = offset + 2;
+      glm::vec2 ndc = { (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f };
+      glm::vec4 nearCorner = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+      glm::vec4 farCorner = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+      glm::vec3 edgeStart = glm::vec3(nearCorner) / nearCorner.w;
+      glm::vec3 edgeEnd = glm::vec3(farCorner) / farCorner.w;
 
-      indices[i + 3] = offset + 2;
-      indices[i + 4] = offset + 3;
-      indices[i + 5] = offset + 0;
+      // View depth changes linearly along each frustum edge
+      corners[i * 2 + 0] = glm::mix(edgeStart, edgeEnd, (sliceNear - nearClip) / (farClip - nearClip));
+      corners[i * 2 + 1] = glm::mix(edgeStart, edgeEnd, (sliceFar - nearClip) / (farClip - nearClip));
+    }
 
-      offset += 4;
+    center = glm::vec3(0.0f);
+    for (const auto& corner : corners)
+      center += corner;
+    center /= 8.0f;
+
+    radius = 0.0f;
+    for (const auto& corner : corners)
+      radius = std::max(radius, glm::length(corner - center));
+    // A sphere does not change size as the camera turns; rounding keeps float noise out too
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+  }
+
+  static void RenderShadowCaster(const Ref<Model3D>& model, const glm::mat4& transform, uint32_t lod)
+  {
+    s_Data.DepthShader->SetMat4("u_Transform", transform);
+    for (const auto& mesh : model->GetMesh())
+    {
+      const MeshLOD& range = mesh.LODs[std::min(lod, (uint32_t)mesh.LODs.size() - 1)];
+      mesh.MeshVertexArray->Bind();
+      RenderCommand::DrawIndexed(mesh.MeshVertexArray, range.IndexCount, range.IndexOffset);
+      s_Data.Stats.DrawCalls++;
+    }
+    s_Data.Stats.ShadowCasters++;
+  }
+
+  static void RenderShadowCascade(uint32_t index)
+  {
+    const ShadowCascade& cascade = s_Data.Cascades[index];
+    Frustum frustum(cascade.ViewProjection);
+
+    s_Data.Shadows->BeginLayer(index);
+
+    s_Data.DepthShader->Bind();
+    s_Data.DepthShader->SetMat4("u_ViewProjection", cascade.ViewProjection);
+    for (const auto& command : s_Data.ModelQueue)
+    {
+      glm::vec3 boundsMin, boundsMax;
+      TransformBounds(command.Model->GetBoundsMin(), command.Model->GetBoundsMax(), command.Transform, boundsMin, boundsMax);
+      if (frustum.IntersectsAABB(boundsMin, boundsMax))
+        RenderShadowCaster(command.Model, command.Transform, command.LOD);
+    }
+
+    // Frustum culled only; the Hi-Z pyramid is from the camera's point of view
+    s_Data.StaticMeshDepthShader->Bind();
+    s_Data.StaticMeshDepthShader->SetMat4("u_ViewProjection", cascade.ViewProjection);
+    for (const auto& batch : s_Data.StaticMeshBatchQueue)
+    {
+      ResetStaticMeshBatchCommands(batch);
+      batch->Bind();
+      CullStaticMeshBatch(batch, cascade.ViewProjection, 0, false);
+      DrawStaticMeshBatchPhase(batch, s_Data.StaticMeshDepthShader, 0);
     }
-    s_Data.QuadIndexBuffer->SetData(indices, 36);
 
-    RenderCommand::DrawIndexed(s_Data.QuadVertexArray, 36);
+    s_Data.Shadows->EndLayer();
+    s_Data.Stats.ShadowCascadesRendered++;
   }
 
-  void Renderer3D::DrawCube(const glm::vec3& position, const glm::vec3& size, const glm::vec4& color)
+  // Fits a cascade around each slice of the view frustum and re-renders the ones that are due
+  static void RenderShadowMaps()
   {
-    // s_Data.QuadShader->Bind();
-    // s_Data.QuadShader->SetFloat4("u_Color", color);
-    s_Data.LightingShader->Bind();
-    s_Data.WhiteTexture->Bind(0);
+    const ShadowSettings& settings = s_Data.SceneData.Shadows;
+    const auto& camera = s_Data.SceneData.Camera;
+    uint32_t cascadeCount = std::min(settings.CascadeCount, ShadowSettings::MaxCascades);
 
-    uint32_t colorTextureData = 0;
-    for (int i = 0; i < 4; i++)
+    if (!s_Data.Shadows || s_Data.Shadows->GetResolution() != settings.Resolution)
     {
-      colorTextureData *= 256;
-      colorTextureData += (int)(color[3-i] * 255);
+      s_Data.Shadows = ShadowMap::Create(settings.Resolution, ShadowSettings::MaxCascades);
+      for (auto& cascade : s_Data.Cascades)
+        cascade.Valid = false;
     }
-    s_Data.ColorTexture->SetData(&colorTextureData, sizeof(uint32_t));
-    s_Data.ColorTexture->Bind(1);
 
-    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), size);
-    // s_Data.QuadShader->SetMat4("u_Transform", transform);
-    s_Data.LightingShader->SetMat4("u_Transform", transform);
-
-    s_Data.LightingShader->SetInt("u_Material.diffuse", 1);
-    s_Data.LightingShader->SetInt("u_Material.specular", 0);
-    s_Data.LightingShader->SetFloat("u_Material.shininess", 32.0f);
-
-    float vertexData[] = {
-      // -x
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f, -0.5f,  0.5f, 1.0f, 0.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-      -0.5f,  0.5f, -0.5f, 0.0f, 1.0f, -1.0f,  0.0f,  0.0f,
-
-      // +x
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-       0.5f,  0.5f, -0.5f, 1.0f, 0.0f,  1.0f,  0.0f,  0.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-       0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  1.0f,  0.0f,  0.0f,
-
-      // -y
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  0.0f, -1.0f,  0.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 0.0f,  0.0f, -1.0f,  0.0f,
-       0.5f, -0.5f,  0.5f, 1.0f, 1.0f,  0.0f, -1.0f,  0.0f,
-      -0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  0.0f, -1.0f,  0.0f,
-
-      // +y
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  0.0f,  1.0f,  0.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,  0.0f,  1.0f,  0.0f,
-      -0.5f,  0.5f, -0.5f, 1.0f, 1.0f,  0.0f,  1.0f,  0.0f,
-       0.5f,  0.5f, -0.5f, 0.0f, 1.0f,  0.0f,  1.0f,  0.0f,
-
-      // -z
-      -0.5f, -0.5f, -0.5f, 0.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-       0.5f, -0.5f, -0.5f, 1.0f, 0.0f,  0.0f,  0.0f, -1.0f,
-       0.5f,  0.5f, -0.5f, 1.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-      -0.5f,  0.5f, -0.5f, 0.0f, 1.0f,  0.0f,  0.0f, -1.0f,
-
-      // +z
-       0.5f,  0.5f,  0.5f, 0.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-      -0.5f,  0.5f,  0.5f, 1.0f, 0.0f,  0.0f,  0.0f,  1.0f,
-      -0.5f, -0.5f,  0.5f, 1.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-       0.5f, -0.5f,  0.5f, 0.0f, 1.0f,  0.0f,  0.0f,  1.0f,
-    };
+    glm::vec3 lightDirection = glm::normalize(s_Data.SceneData.DirLight->GetDirection());
+    bool lightChanged = glm::dot(lightDirection, s_Data.ShadowLightDirection) < 0.99999f;
+    s_Data.ShadowLightDirection = lightDirection;
+
+    // Light space only depends on the direction, so snapped cascades keep their texel grid
+    glm::vec3 up = std::abs(lightDirection.y) > 0.99f ? glm::vec3(1.0f, 0.0f, 0.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), lightDirection, up);
 
-    s_Data.QuadVertexBuffer->SetData(vertexData, sizeof(vertexData));
+    float nearClip = camera->GetNearClip();
+    float farClip = std::min(camera->GetFarClip(), settings.MaxDistance);
 
-    uint32_t indices[36];
-    uint32_t offset = 0;
-    for (uint32_t i = 0; i < 36; i += 6)
+    float sliceNear = nearClip;
+    for (uint32_t i = 0; i < cascadeCount; i++)
     {
-      indices[i + 0] = offset + 0;
-      indices[i + 1] = offset + 1;
-      indices[i + 2] = offset + 2;
+      // Practical split scheme: blend of logarithmic and uniform splits
+      float fraction = (float)(i + 1) / (float)cascadeCount;
+      float logSplit = nearClip * std::pow(farClip / nearClip, fraction);
+      float uniformSplit = nearClip + (farClip - nearClip) * fraction;
+      float sliceFar = glm::mix(uniformSplit, logSplit, settings.SplitLambda);
 
-      indices[i + 3] = offset + 2;
-      indices[i + 4] = offset + 3;
-      indices[i + 5] = offset + 0;
+      glm::vec3 sliceCenter;
+      float sliceRadius;
+      GetFrustumSliceBounds(sliceNear, sliceFar, sliceCenter, sliceRadius);
+      sliceNear = sliceFar;
 
-      offset += 4;
+      ShadowCascade& cascade = s_Data.Cascades[i];
+      glm::vec3 center = glm::vec3(lightView * glm::vec4(sliceCenter, 1.0f));
+      float radius = sliceRadius * (1.0f + s_Data.CascadeMargin);
+
+      // A cached cascade is kept until it is due, unless its slice has drifted out of the margin
+      uint32_t interval = std::max(settings.UpdateIntervals[i], 1u);
+      bool due = (s_Data.FrameIndex + i) % interval == 0;
+      bool drifted = glm::length(glm::vec2(center) - glm::vec2(cascade.Center)) > sliceRadius * s_Data.CascadeMargin;
+      if (cascade.Valid && !due && !drifted && !lightChanged && cascade.Radius == radius)
+        continue;
+
+      // Snap to whole texels so static shadow edges do not shimmer as the camera moves
+      float texelSize = 2.0f * radius / (float)settings.Resolution;
+      center.x = std::floor(center.x / texelSize) * texelSize;
+      center.y = std::floor(center.y / texelSize) * texelSize;
+
+      // Light space looks down -z; the near plane is pulled back to catch casters outside the slice
+      glm::mat4 projection = glm::ortho(center.x - radius, center.x + radius, center.y - radius, center.y + radius,
+        -center.z - radius - settings.CasterDistance, -center.z + radius);
+
+      cascade.ViewProjection = projection * lightView;
+      cascade.Center = center;
+      cascade.Radius = radius;
+      cascade.TexelSize = texelSize;
+      cascade.Valid = true;
+
+      RenderShadowCascade(i);
     }
-    s_Data.QuadIndexBuffer->SetData(indices, 36);
+  }
+
+  // Camera, light and shadow uniforms of the lit shaders, set once per scene and shader
+  static void SetSceneUniforms(const Ref<Shader>& shader)
+  {
+    const auto& sceneData = s_Data.SceneData;
+    const ShadowSettings& settings = sceneData.Shadows;
+    uint32_t cascadeCount = settings.Enabled && s_Data.Shadows ? std::min(settings.CascadeCount, ShadowSettings::MaxCascades) : 0;
 
-    RenderCommand::DrawIndexed(s_Data.QuadVertexArray, 36);
+    shader->Bind();
+    shader->SetMat4("u_ViewProjection", sceneData.Camera->GetViewProjectionMatrix());
+    shader->SetFloat3("u_CameraPosition", sceneData.Camera->GetPosition());
+    shader->SetFloat3("u_DirLight.direction", sceneData.DirLight->GetDirection());
+    shader->SetFloat3("u_DirLight.ambient", sceneData.DirLight->GetAmbient());
+    shader->SetFloat3("u_DirLight.diffuse", sceneData.DirLight->GetDiffuse());
+    shader->SetFloat3("u_DirLight.specular", sceneData.DirLight->GetSpecular());
+
+    shader->SetInt("u_ShadowMap", s_Data.ShadowMapSlot);
+    shader->SetInt("u_CascadeCount", (int)cascadeCount);
+    shader->SetInt("u_PCFRadius", (int)settings.PCFRadius);
+    for (uint32_t i = 0; i < cascadeCount; i++)
+    {
+      shader->SetMat4("u_LightSpaceMatrices[" + std::to_string(i) + "]", s_Data.Cascades[i].ViewProjection);
+      shader->SetFloat("u_CascadeTexelSizes[" + std::to_string(i) + "]", s_Data.Cascades[i].TexelSize);
+    }
   }
 
-  void Renderer3D::DrawModel(Ref<Model3D> model, const glm::mat4& transform)
+  // Splits the queued models into mesh draws. They inherit the front to back order of the
+  // models; with a pre-pass there is no overdraw left to save, so they are grouped by shader
+  // and material instead.
+  static void BuildMeshQueue()
   {
-    s_Data.LightingShader->Bind();
-    s_Data.LightingShader->SetMat4("u_Transform", transform);
+    s_Data.MeshQueue.clear();
+    for (const auto& command : s_Data.ModelQueue)
+    {
+      for (const auto& mesh : command.Model->GetMesh())
+      {
+        const Material* material = command.MaterialOverride ? command.MaterialOverride.get() : mesh.MeshMaterial ? mesh.MeshMaterial.get() : MaterialLibrary::GetDefault().get();
+        const Shader* shader = material->GetShader() ? material->GetShader().get() : s_Data.LightingShader.get();
+        s_Data.MeshQueue.push_back({ &mesh, material, shader, &command.Transform, &command.Color, command.LOD, command.Distance });
+      }
+    }
 
-    s_Data.LightingShader->SetInt("u_Material.diffuse", 1);
-    s_Data.LightingShader->SetInt("u_Material.specular", 0);
-    s_Data.LightingShader->SetFloat("u_Material.shininess", 32.0f);
+    if (!s_Data.DepthPrePass)
+      return;
 
-    for (auto& mesh : model->GetMesh())
+    std::sort(s_Data.MeshQueue.begin(), s_Data.MeshQueue.end(), [](const MeshDrawCommand& a, const MeshDrawCommand& b)
     {
-      s_Data.WhiteTexture->Bind(0);
-      for (uint32_t i = 0; i < mesh.DiffuseTextures.size(); i++)
-        mesh.DiffuseTextures[i]->Bind(1);
-      for (uint32_t i = 0; i < mesh.SpecularTextures.size(); i++)
-        mesh.SpecularTextures[i]->Bind(0);
+      if (a.DrawShader != b.DrawShader)
+        return a.DrawShader < b.DrawShader;
+      if (a.DrawMaterial->GetIndex() != b.DrawMaterial->GetIndex())
+        return a.DrawMaterial->GetIndex() < b.DrawMaterial->GetIndex();
+      return a.Distance < b.Distance;
+    });
+  }
+
+  // Textures are found through the texture table, so a material is only an index
+  static void BindMaterial(const Ref<Shader>& shader, const Material* material)
+  {
+    if (material == s_Data.BoundMaterial)
+      return;
+    s_Data.BoundMaterial = material;
+
+    shader->SetInt("u_MaterialIndex", (int)material->GetIndex());
+    s_Data.Stats.MaterialBinds++;
+  }
+
+  static void FlushMeshes()
+  {
+    s_Data.BoundShader = nullptr;
+    s_Data.BoundMaterial = nullptr;
 
-      if (mesh.Vertices.size() > s_Data.MaxVertices)
+    Ref<Shader> shader;
+    for (const auto& command : s_Data.MeshQueue)
+    {
+      if (command.DrawShader != s_Data.BoundShader)
       {
-        uint32_t count = mesh.Vertices.size();
-        uint32_t numIter = 0;
-        while (count > s_Data.MaxVertices)
+        shader = command.DrawMaterial->GetShader() ? command.DrawMaterial->GetShader() : s_Data.LightingShader;
+        if (std::find(s_Data.PreparedShaders.begin(), s_Data.PreparedShaders.end(), shader.get()) == s_Data.PreparedShaders.end())
         {
-          std::vector<VertexData3D> data(mesh.Vertices.begin() + numIter * s_Data.MaxVertices, mesh.Vertices.begin() + (numIter + 1) * s_Data.MaxVertices);
-          std::vector<uint32_t> index(mesh.Indices.begin() + numIter * s_Data.MaxIndices, mesh.Indices.begin() + (numIter + 1) * s_Data.MaxIndices);
-          numIter++;
-          count -= s_Data.MaxVertices;
-          s_Data.QuadVertexBuffer->SetData(&data[0], s_Data.MaxVertices * sizeof(VertexData3D));
-          s_Data.QuadIndexBuffer->SetData(&index[0], s_Data.MaxIndices);
-          RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.MaxIndices);
+          SetSceneUniforms(shader);
+          s_Data.PreparedShaders.push_back(shader.get());
         }
 
-        std::vector<VertexData3D> data(mesh.Vertices.begin() + numIter * s_Data.MaxVertices, mesh.Vertices.end());
-        std::vector<uint32_t> index(mesh.Indices.begin() + numIter * s_Data.MaxIndices, mesh.Indices.end());
-        s_Data.QuadVertexBuffer->SetData(&data[0], count * sizeof(VertexData3D));
-        s_Data.QuadIndexBuffer->SetData(&index[0], count);
-        RenderCommand::DrawIndexed(s_Data.QuadVertexArray, count);
+        shader->Bind();
+        s_Data.BoundShader = shader.get();
+        // The material index is a uniform of the shader that was just bound
+        s_Data.BoundMaterial = nullptr;
       }
 
-      else
+      BindMaterial(shader, command.DrawMaterial);
+      shader->SetMat4("u_Transform", *command.Transform);
+      shader->SetFloat4("u_Color", *command.Color);
+      DrawMesh(*command.DrawMesh, command.LOD);
+    }
+  }
+
+  // Culls the batch in two phases and draws it with the given shader
+  static void FlushStaticMeshBatch(const Ref<StaticMeshBatch>& batch, const Ref<Shader>& shader)
+  {
+    const glm::mat4& viewProjection = s_Data.SceneData.Camera->GetViewProjectionMatrix();
+
+    ResetStaticMeshBatchCommands(batch);
+    batch->Bind();
+
+    // Phase 0: everything that was visible last frame
+    CullStaticMeshBatch(batch, viewProjection, 0, s_Data.OcclusionCulling);
+    DrawStaticMeshBatchPhase(batch, shader, 0);
+
+    if (!s_Data.OcclusionCulling)
+      return;
+
+    // Phase 1: test everything against the depth so far and draw what phase 0 missed
+    s_Data.HiZ->Build(ResolveScene(), viewProjection);
+    s_Data.HiZ->Bind(0);
+
+    CullStaticMeshBatch(batch, viewProjection, 1, true);
+    DrawStaticMeshBatchPhase(batch, shader, 1);
+  }
+
+  // Draws the commands left by the pre-pass again, without culling
+  static void RedrawStaticMeshBatch(const Ref<StaticMeshBatch>& batch, const Ref<Shader>& shader)
+  {
+    batch->Bind();
+    DrawStaticMeshBatchPhase(batch, shader, 0);
+    if (s_Data.OcclusionCulling)
+      DrawStaticMeshBatchPhase(batch, shader, 1);
+  }
+
+  // Lays down the depth of every opaque, so the lit pass only shades visible fragments
+  static void RenderDepthPrePass()
+  {
+    RenderCommand::SetColorWrite(false);
+
+    // The shadow pass shares the depth shaders and leaves them with a cascade's light matrix
+    const glm::mat4& viewProjection = s_Data.SceneData.Camera->GetViewProjectionMatrix();
+    s_Data.StaticMeshDepthShader->Bind();
+    s_Data.StaticMeshDepthShader->SetMat4("u_ViewProjection", viewProjection);
+    s_Data.DepthShader->Bind();
+    s_Data.DepthShader->SetMat4("u_ViewProjection", viewProjection);
+    for (const auto& command : s_Data.ModelQueue)
+    {
+      s_Data.DepthShader->SetMat4("u_Transform", command.Transform);
+      for (const auto& mesh : command.Model->GetMesh())
       {
-        s_Data.QuadVertexBuffer->SetData(&mesh.Vertices[0], mesh.Vertices.size() * sizeof(VertexData3D));
-        s_Data.QuadIndexBuffer->SetData(&mesh.Indices[0], mesh.Indices.size());
-        RenderCommand::DrawIndexed(s_Data.QuadVertexArray, mesh.Indices.size());
+        const MeshLOD& range = mesh.LODs[std::min(command.LOD, (uint32_t)mesh.LODs.size() - 1)];
+        mesh.MeshVertexArray->Bind();
+        RenderCommand::DrawIndexed(mesh.MeshVertexArray, range.IndexCount, range.IndexOffset);
+        s_Data.Stats.DrawCalls++;
       }
     }
+
+    for (const auto& batch : s_Data.StaticMeshBatchQueue)
+      FlushStaticMeshBatch(batch, s_Data.StaticMeshDepthShader);
+
+    RenderCommand::SetColorWrite(true);
   }
 
-  void Renderer3D::DrawModel(Ref<Model3D> model, const glm::mat4& transform, const glm::vec4& color)
+  // Drawn last at the far plane, so it only shades pixels nothing else covered
+  static void FlushSkyBox(const SkyBoxDrawCommand& command)
   {
-    s_Data.LightingShader->Bind();
-    s_Data.LightingShader->SetMat4("u_Transform", transform);
+    s_Data.CubeMapShader->Bind();
+    s_Data.CubeMapShader->SetMat4("u_Transform", command.Transform);
 
-    s_Data.LightingShader->SetInt("u_Material.diffuse", 1);
-    s_Data.LightingShader->SetInt("u_Material.specular", 0);
-    s_Data.LightingShader->SetFloat("u_Material.shininess", 32.0f);
+    command.Texture->Bind(0);
+    s_Data.CubeMapShader->SetInt("u_Skybox", 0);
+
+    RenderCommand::SetDepthFunction(DepthFunction::LessEqual);
+    RenderCommand::SetDepthWrite(false);
+
+    s_Data.SkyBoxVertexArray->Bind();
+    RenderCommand::DrawIndexed(s_Data.SkyBoxVertexArray);
+    s_Data.Stats.DrawCalls++;
+
+    RenderCommand::SetDepthFunction(DepthFunction::Less);
+    RenderCommand::SetDepthWrite(true);
+  }
 
-    for (auto& mesh : model->GetMesh())
+  void Renderer3D::Init()
+  {
+    MaterialLibrary::Init();
+    Primitives::Init();
+
+    float skyBoxVertices[] = {
+      -0.5f, -0.5f, -0.5f,
+       0.5f, -0.5f, -0.5f,
+       0.5f,  0.5f, -0.5f,
+      -0.5f,  0.5f, -0.5f,
+      -0.5f, -0.5f,  0.5f,
+       0.5f, -0.5f,  0.5f,
+       0.5f,  0.5f,  0.5f,
+      -0.5f,  0.5f,  0.5f,
+    };
+    // Counter-clockwise seen from outside, like the other primitives
+    uint16_t skyBoxIndices[] = {
+      0, 2, 1, 2, 0, 3,
+      4, 5, 6, 6, 7, 4,
+      0, 4, 7, 7, 3, 0,
+      1, 2, 6, 6, 5, 1,
+      0, 1, 5, 5, 4, 0,
+      3, 7, 6, 6, 2, 3,
+    };
+
+    s_Data.SkyBoxVertexArray = VertexArray::Create();
+    Ref<VertexBuffer> skyBoxVertexBuffer = VertexBuffer::Create(skyBoxVertices, sizeof(skyBoxVertices));
+    skyBoxVertexBuffer->SetLayout({ { ShaderDataType::Float3, "a_Position" } });
+    s_Data.SkyBoxVertexArray->AddVertexBuffer(skyBoxVertexBuffer);
+    s_Data.SkyBoxVertexArray->SetIndexBuffer(IndexBuffer::Create(skyBoxIndices, sizeof(skyBoxIndices) / sizeof(uint16_t)));
+
+    s_Data.CubeMapShader = Shader::Create("Sandbox/assets/shaders/CubeMap.glsl");
+    // The lit shaders sample material textures the way the texture table stores them
+    std::vector<std::string> litDefines;
+    if (MaterialLibrary::GetTextureTable()->IsBindless())
+      litDefines.push_back("BINDLESS_TEXTURES");
+    s_Data.LightingShader = Shader::Create("Sandbox/assets/shaders/Lighting.glsl", litDefines);
+    s_Data.StaticMeshShader = Shader::Create("Sandbox/assets/shaders/StaticMesh.glsl", litDefines);
+    s_Data.StaticMeshCullShader = Shader::Create("Sandbox/assets/shaders/StaticMeshCull.glsl");
+    s_Data.DepthShader = Shader::Create("Sandbox/assets/shaders/Depth.glsl");
+    s_Data.StaticMeshDepthShader = Shader::Create("Sandbox/assets/shaders/StaticMeshDepth.glsl");
+
+    s_Data.HiZ = HiZBuffer::Create();
+  }
+
+  void Renderer3D::Shutdown()
+  {
+    Primitives::Shutdown();
+    MaterialLibrary::Shutdown();
+  }
+
+  void Renderer3D::OnWindowResize(uint32_t width, uint32_t height)
+  {
+    s_Data.ViewportWidth = width;
+    s_Data.ViewportHeight = height;
+    InvalidateFramebuffers();
+  }
+
+  void Renderer3D::BeginScene(const Renderer3DSceneData& sceneData)
+  {
+    AE_CORE_ASSERT(s_Data.SceneFramebuffer, "Renderer3D::OnWindowResize has not been called!");
+    s_Data.SceneData = sceneData;
+    s_Data.FrameIndex++;
+
+    UpdateResolutionScale();
+
+    s_Data.ModelQueue.clear();
+    s_Data.StaticMeshBatchQueue.clear();
+    s_Data.SkyBoxQueue.clear();
+    s_Data.ParticleQueue.clear();
+    s_Data.PreparedShaders.clear();
+
+    // Forget LOD history of models and command buffers that were not drawn in the previous scene
+    TrimLODHistory(s_Data.ImmediateLODs);
+    for (auto it = s_Data.CommandBufferLODs.begin(); it != s_Data.CommandBufferLODs.end(); )
     {
-      s_Data.WhiteTexture->Bind(0);
+      if (s_Data.SubmittedCommandBuffers.find(it->first) == s_Data.SubmittedCommandBuffers.end())
+        it = s_Data.CommandBufferLODs.erase(it);
+      else
+        ++it;
+    }
+    s_Data.SubmittedCommandBuffers.clear();
+
+    s_Data.OcclusionReadback = s_Data.OcclusionCulling ? s_Data.HiZ->GetReadback() : nullptr;
+
+    s_Data.CubeMapShader->Bind();
+    s_Data.CubeMapShader->SetMat4("u_ViewProjection", sceneData.Camera->GetViewProjectionMatrix());
+  }
 
-      uint32_t colorTextureData = 0;
-      for (int i = 0; i < 4; i++)
+  void Renderer3D::EndScene()
+  {
+    MaterialLibrary::Bind();
+
+    for (const auto& batch : s_Data.StaticMeshBatchQueue)
+    {
+      batch->AdvanceFrame();
+      s_Data.Stats.OccludedObjects += batch->GetOccludedCount();
+    }
+
+    if (s_Data.SceneData.Shadows.Enabled)
+      RenderShadowMaps();
+
+    // Hidden models still cast shadows, so they are only dropped after the shadow pass
+    auto occluded = std::remove_if(s_Data.ModelQueue.begin(), s_Data.ModelQueue.end(), [](const ModelDrawCommand& command)
+    {
+      return IsOccluded(command.Model, command.Transform);
+    });
+    s_Data.Stats.OccludedObjects += (uint32_t)(s_Data.ModelQueue.end() - occluded);
+    s_Data.ModelQueue.erase(occluded, s_Data.ModelQueue.end());
+
+    // Front to back, so early depth testing rejects as much as possible
+    std::sort(s_Data.ModelQueue.begin(), s_Data.ModelQueue.end(), [](const ModelDrawCommand& a, const ModelDrawCommand& b) { return a.Distance < b.Distance; });
+    BuildMeshQueue();
+
+    s_Data.SceneFramebuffer->Bind();
+    RenderCommand::Clear();
+
+    if (s_Data.DepthPrePass)
+    {
+      RenderDepthPrePass();
+      RenderCommand::SetDepthFunction(DepthFunction::Equal);
+      RenderCommand::SetDepthWrite(false);
+    }
+
+    if (s_Data.Shadows)
+      s_Data.Shadows->Bind(s_Data.ShadowMapSlot);
+
+    FlushMeshes();
+    if (!s_Data.StaticMeshBatchQueue.empty())
+      SetSceneUniforms(s_Data.StaticMeshShader);
+    for (const auto& batch : s_Data.StaticMeshBatchQueue)
+    {
+      if (s_Data.DepthPrePass)
+        RedrawStaticMeshBatch(batch, s_Data.StaticMeshShader);
+      else
+        FlushStaticMeshBatch(batch, s_Data.StaticMeshShader);
+    }
+
+    if (s_Data.DepthPrePass)
+    {
+      RenderCommand::SetDepthFunction(DepthFunction::Less);
+      RenderCommand::SetDepthWrite(true);
+    }
+
+    for (const auto& command : s_Data.SkyBoxQueue)
+      FlushSkyBox(command);
+
+    // Blended over the scene and unsorted, so they must not hide each other through depth
+    if (!s_Data.ParticleQueue.empty())
+    {
+      RenderCommand::SetDepthWrite(false);
+      for (const auto& particles : s_Data.ParticleQueue)
       {
-        colorTextureData *= 256;
-        colorTextureData += (int)(color[3-i] * 255);
+        particles->Draw(*s_Data.SceneData.Camera);
+        s_Data.Stats.DrawCalls += particles->GetEmitterCount();
       }
-      s_Data.ColorTexture->SetData(&colorTextureData, sizeof(uint32_t));
-      s_Data.ColorTexture->Bind(1);
+      RenderCommand::SetDepthWrite(true);
+    }
+
+    const Ref<Framebuffer>& output = ResolveScene();
+
+    // The immediate draws of later frames test against this scene's depth
+    if (s_Data.OcclusionCulling)
+    {
+      s_Data.HiZ->Build(output, s_Data.SceneData.Camera->GetViewProjectionMatrix());
+      s_Data.HiZ->RequestReadback();
+    }
+
+    s_Data.SceneFramebuffer->Unbind();
+    RenderCommand::SetViewport(0, 0, s_Data.ViewportWidth, s_Data.ViewportHeight);
+    output->BlitToScreen(0, 0, s_Data.ViewportWidth, s_Data.ViewportHeight);
+  }
+
+  void Renderer3D::SkyBox(Ref<CubeMap> cubeMap, const glm::vec3& position, const glm::vec3& size)
+  {
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), size);
+    s_Data.SkyBoxQueue.push_back({ cubeMap, transform });
+  }
 
-      for (uint32_t i = 0; i < mesh.SpecularTextures.size(); i++)
-        mesh.SpecularTextures[i]->Bind(0);
+  void Renderer3D::DrawCube(const glm::vec3& position, const glm::vec3& size, const glm::vec4& color)
+  {
+    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::scale(glm::mat4(1.0f), size);
+    DrawPrimitive(Primitive::Cube, transform, color);
+  }
 
-      if (mesh.Vertices.size() > s_Data.MaxVertices)
+  void Renderer3D::DrawPrimitive(Primitive primitive, const glm::mat4& transform, const glm::vec4& color)
+  {
+    DrawModel(Primitives::Get(primitive), transform, color);
+  }
+
+  void Renderer3D::DrawModel(Ref<Model3D> model, const glm::mat4& transform)
+  {
+    // Selected at submission so the LOD history follows the order models are drawn in
+    uint32_t lod = SelectLOD(model, transform);
+    s_Data.ModelQueue.push_back({ model, transform, nullptr, glm::vec4(1.0f), lod, GetCameraDistance(model, transform) });
+  }
+
+  void Renderer3D::DrawModel(Ref<Model3D> model, const glm::mat4& transform, const glm::vec4& color)
+  {
+    uint32_t lod = SelectLOD(model, transform);
+    // The color is a uniform of the draw, so colors that change every frame add no materials
+    s_Data.ModelQueue.push_back({ model, transform, MaterialLibrary::GetDefault(), color, lod, GetCameraDistance(model, transform) });
+  }
+
+  void Renderer3D::DrawModel(Ref<Model3D> model, const glm::mat4& transform, const Ref<Material>& material)
+  {
+    uint32_t lod = SelectLOD(model, transform);
+    s_Data.ModelQueue.push_back({ model, transform, MaterialLibrary::Register(material), glm::vec4(1.0f), lod, GetCameraDistance(model, transform) });
+  }
+
+  // Turns the draws of a command buffer into model draws. Only reads shared renderer state,
+  // so buffers are replayed in parallel.
+  static void ReplayCommandBuffer(const CommandBuffer& buffer, CommandBufferReplay& replay, LODHistory& lodHistory)
+  {
+    replay.Draws.clear();
+    replay.Draws.reserve(buffer.GetDrawCount());
+
+    static const glm::mat4 identity = glm::mat4(1.0f);
+    const glm::mat4* transform = &identity;
+    const ReplayMaterial* material = nullptr;
+    for (const auto& command : buffer.GetCommands())
+    {
+      switch (command.Type)
       {
-        uint32_t count = mesh.Vertices.size();
-        uint32_t numIter = 0;
-        while (count > s_Data.MaxVertices)
+        case CommandBuffer::CommandType::SetTransform:
+          transform = &buffer.GetTransforms()[command.Index];
+          break;
+        case CommandBuffer::CommandType::BindMaterial:
+          material = &replay.Materials[command.Index];
+          break;
+        case CommandBuffer::CommandType::Draw:
         {
-          std::vector<VertexData3D> data(mesh.Vertices.begin() + numIter * s_Data.MaxVertices, mesh.Vertices.begin() + (numIter + 1) * s_Data.MaxVertices);
-          std::vector<uint32_t> index(mesh.Indices.begin() + numIter * s_Data.MaxIndices, mesh.Indices.begin() + (numIter + 1) * s_Data.MaxIndices);
-          numIter++;
-          count -= s_Data.MaxVertices;
-          s_Data.QuadVertexBuffer->SetData(&data[0], s_Data.MaxVertices * sizeof(VertexData3D));
-          s_Data.QuadIndexBuffer->SetData(&index[0], s_Data.MaxIndices);
-          RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.MaxIndices);
+          const Ref<Model3D>& model = buffer.GetModels()[command.Index];
+          uint32_t lod = SelectLOD(lodHistory, model, *transform);
+          replay.Draws.push_back({ model, *transform, material ? material->BoundMaterial : nullptr, material ? material->Color : glm::vec4(1.0f),
+            lod, GetCameraDistance(model, *transform) });
+          break;
         }
+      }
+    }
+
+    TrimLODHistory(lodHistory);
+  }
 
-        std::vector<VertexData3D> data(mesh.Vertices.begin() + numIter * s_Data.MaxVertices, mesh.Vertices.end());
-        std::vector<uint32_t> index(mesh.Indices.begin() + numIter * s_Data.MaxIndices, mesh.Indices.end());
-        s_Data.QuadVertexBuffer->SetData(&data[0], count * sizeof(VertexData3D));
-        s_Data.QuadIndexBuffer->SetData(&index[0], count);
-        RenderCommand::DrawIndexed(s_Data.QuadVertexArray, count);
+  void Renderer3D::Submit(CommandBuffer* const* buffers, uint32_t count)
+  {
+    // A buffer replayed twice would race itself on its LOD history and reset the cursors, so
+    // each one is taken once per scene
+    std::vector<CommandBuffer*> unique;
+    unique.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+      if (!s_Data.SubmittedCommandBuffers.insert(buffers[i]).second)
+      {
+        AE_CORE_WARN("CommandBuffer submitted more than once in a scene, the repeat is dropped");
+        continue;
       }
+      unique.push_back(buffers[i]);
+    }
+    count = (uint32_t)unique.size();
 
-      else
+    if (s_Data.CommandBufferReplays.size() < count)
+      s_Data.CommandBufferReplays.resize(count);
+
+    // Materials are registered and the LOD histories looked up here, since neither is thread safe
+    std::vector<LODHistory*> lodHistories(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+      auto& materials = s_Data.CommandBufferReplays[i].Materials;
+      materials.clear();
+      for (const auto& binding : unique[i]->GetMaterials())
       {
-        s_Data.QuadVertexBuffer->SetData(&mesh.Vertices[0], mesh.Vertices.size() * sizeof(VertexData3D));
-        s_Data.QuadIndexBuffer->SetData(&mesh.Indices[0], mesh.Indices.size());
-        RenderCommand::DrawIndexed(s_Data.QuadVertexArray, mesh.Indices.size());
+        if (binding.UseColor)
+          materials.push_back({ MaterialLibrary::GetDefault(), binding.Color });
+        else
+          materials.push_back({ binding.BoundMaterial ? MaterialLibrary::Register(binding.BoundMaterial) : nullptr, glm::vec4(1.0f) });
       }
+
+      lodHistories[i] = &s_Data.CommandBufferLODs[unique[i]];
+    }
+
+    JobSystem::ParallelFor(count, [&unique, &lodHistories](uint32_t i)
+    {
+      ReplayCommandBuffer(*unique[i], s_Data.CommandBufferReplays[i], *lodHistories[i]);
+    });
+
+    for (uint32_t i = 0; i < count; i++)
+    {
+      auto& draws = s_Data.CommandBufferReplays[i].Draws;
+      s_Data.ModelQueue.insert(s_Data.ModelQueue.end(), std::make_move_iterator(draws.begin()), std::make_move_iterator(draws.end()));
+      draws.clear();
+      s_Data.CommandBufferReplays[i].Materials.clear();
     }
   }
 
+  void Renderer3D::Submit(CommandBuffer& buffer)
+  {
+    CommandBuffer* buffers[] = { &buffer };
+    Submit(buffers, 1);
+  }
+
+  void Renderer3D::DrawStaticMeshBatch(const Ref<StaticMeshBatch>& batch)
+  {
+    AE_CORE_ASSERT(batch->IsBuilt(), "StaticMeshBatch has not been built!");
+    if (batch->GetInstanceCount() == 0)
+      return;
+
+    s_Data.StaticMeshBatchQueue.push_back(batch);
+  }
+
+  void Renderer3D::DrawParticles(const Ref<ParticleSystem>& particles)
+  {
+    s_Data.ParticleQueue.push_back(particles);
+  }
+
+  void Renderer3D::SetDepthPrePass(bool enabled)
+  {
+    s_Data.DepthPrePass = enabled;
+  }
+
+  bool Renderer3D::GetDepthPrePass()
+  {
+    return s_Data.DepthPrePass;
+  }
+
+  void Renderer3D::SetOcclusionCulling(bool enabled)
+  {
+    s_Data.OcclusionCulling = enabled;
+  }
+
+  bool Renderer3D::GetOcclusionCulling()
+  {
+    return s_Data.OcclusionCulling;
+  }
+
+  void Renderer3D::SetResolutionScale(float scale)
+  {
+    s_Data.ResolutionScale = glm::clamp(scale, 0.25f, 1.0f);
+    InvalidateFramebuffers();
+  }
+
+  float Renderer3D::GetResolutionScale()
+  {
+    return s_Data.ResolutionScale;
+  }
+
+  void Renderer3D::SetDynamicResolution(bool enabled, float targetFrameTime)
+  {
+    s_Data.DynamicResolution = enabled;
+    s_Data.TargetFrameTime = targetFrameTime;
+    s_Data.AverageFrameTime = targetFrameTime;
+    s_Data.ResolutionCooldown = 0;
+  }
+
+  bool Renderer3D::GetDynamicResolution()
+  {
+    return s_Data.DynamicResolution;
+  }
+
+  void Renderer3D::SetMSAASamples(uint32_t samples)
+  {
+    s_Data.MSAASamples = std::max(samples, 1u);
+    InvalidateFramebuffers();
+  }
+
+  const Ref<Framebuffer>& Renderer3D::GetOutputFramebuffer()
+  {
+    return s_Data.ResolveFramebuffer ? s_Data.ResolveFramebuffer : s_Data.SceneFramebuffer;
+  }
+
+  void Renderer3D::ResetStats()
+  {
+    s_Data.Stats = Statistics();
+  }
+
+  Renderer3D::Statistics Renderer3D::GetStats()
+  {
+    return s_Data.Stats;
+  }
+
 }
@@ -4,13 +4,40 @@
 #include "Light.h"
 #include "Texture.h"
 #include "Model3D.h"
+#include "Material.h"
+#include "Primitives.h"
+#include "StaticMeshBatch.h"
+#include "Framebuffer.h"
+#include "CommandBuffer.h"
+#include "ParticleSystem.h"
 
 namespace Ancora {
 
+  struct ShadowSettings
+  {
+    static constexpr uint32_t MaxCascades = 4;
+
+    bool Enabled = true;
+    uint32_t CascadeCount = 4;
+    uint32_t Resolution = 2048;
+    // Shadows end this far from the camera, or at the far plane if that is closer
+    float MaxDistance = 150.0f;
+    // Blend between logarithmic (1) and uniform (0) cascade splits
+    float SplitLambda = 0.75f;
+    // Casters this far behind a cascade towards the light still cast into it
+    float CasterDistance = 100.0f;
+    // Cascade i is re-rendered every UpdateIntervals[i] frames, or sooner when the camera or
+    // light moved too far. Moving objects lag behind by up to that many frames in far cascades.
+    uint32_t UpdateIntervals[MaxCascades] = { 1, 2, 4, 8 };
+    // PCF kernel is (2 * PCFRadius + 1)^2 hardware-filtered taps, 0 for a single tap
+    uint32_t PCFRadius = 1;
+  };
+
   struct Renderer3DSceneData
   {
     Ref<PerspectiveCamera> Camera;
     Ref<DirectionalLight> DirLight;
+    ShadowSettings Shadows;
   };
 
   class Renderer3D
@@ -18,14 +45,75 @@ namespace Ancora {
   public:
     static void Init();
     static void Shutdown();
+    static void OnWindowResize(uint32_t width, uint32_t height);
 
+    // Draws are queued between BeginScene and EndScene and rendered in EndScene,
+    // after the shadow cascades they cast into.
     static void BeginScene(const Renderer3DSceneData& sceneData);
     static void EndScene();
 
     static void SkyBox(Ref<CubeMap> cubeMap, const glm::vec3& position, const glm::vec3& size);
     static void DrawCube(const glm::vec3& position, const glm::vec3& size, const glm::vec4& color);
+    static void DrawPrimitive(Primitive primitive, const glm::mat4& transform, const glm::vec4& color);
     static void DrawModel(Ref<Model3D> model, const glm::mat4& transform);
+    // Draws every mesh with the default material, tinted with that color
     static void DrawModel(Ref<Model3D> model, const glm::mat4& transform, const glm::vec4& color);
+    // Draws every mesh with the material, which is registered if it is not yet
+    static void DrawModel(Ref<Model3D> model, const glm::mat4& transform, const Ref<Material>& material);
+    // Queues the draws of command buffers recorded on any thread. LODs and camera distances are
+    // worked out for each buffer in parallel, and the draws are queued in the order of the
+    // buffers, so the result does not depend on which job finished first. Each buffer keeps
+    // its own LOD history while it is submitted every scene. A buffer is taken once per scene;
+    // later submissions of it are dropped.
+    static void Submit(CommandBuffer* const* buffers, uint32_t count);
+    static void Submit(CommandBuffer& buffer);
+    // Culls and draws the whole batch on the GPU with one indirect call
+    static void DrawStaticMeshBatch(const Ref<StaticMeshBatch>& batch);
+    // Drawn after everything opaque and the sky boxes, depth tested but not written. The
+    // system is simulated by its owner with ParticleSystem::OnUpdate.
+    static void DrawParticles(const Ref<ParticleSystem>& particles);
+
+    // Depth-only pass over the opaques before the lit pass, which then shades with GL_EQUAL. On by default.
+    static void SetDepthPrePass(bool enabled);
+    static bool GetDepthPrePass();
+
+    // Hi-Z occlusion culling against the depth of earlier draws, on by default
+    static void SetOcclusionCulling(bool enabled);
+    static bool GetOcclusionCulling();
+
+    // Internal resolution of the scene relative to the window, 0.25 to 1
+    static void SetResolutionScale(float scale);
+    static float GetResolutionScale();
+    // Lowers the resolution scale while frames take longer than targetFrameTime and raises it again once there is headroom
+    static void SetDynamicResolution(bool enabled, float targetFrameTime = 1.0f / 60.0f);
+    static bool GetDynamicResolution();
+    static void SetMSAASamples(uint32_t samples);
+
+    // Single-sampled result of the last scene, at the internal resolution
+    static const Ref<Framebuffer>& GetOutputFramebuffer();
+
+    struct Statistics
+    {
+      uint32_t DrawCalls = 0;
+      // Material changes in the lit pass; draws that share a material are drawn back to back
+      uint32_t MaterialBinds = 0;
+      // Objects skipped by occlusion culling. The GPU-driven part is a few frames late.
+      uint32_t OccludedObjects = 0;
+      uint32_t ShadowCascadesRendered = 0;
+      uint32_t ShadowCasters = 0;
+      uint32_t LODTriangleCount[Mesh::MaxLODs] = {};
+
+      uint32_t GetTotalTriangleCount() const
+      {
+        uint32_t total = 0;
+        for (uint32_t count : LODTriangleCount)
+          total += count;
+        return total;
+      }
+    };
+
+    static void ResetStats();
+    static Statistics GetStats();
   };
 
 }
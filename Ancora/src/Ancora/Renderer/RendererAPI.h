@@ -3,9 +3,30 @@
 #include <glm/glm.hpp>
 
 #include "VertexArray.h"
+#include "StorageBuffer.h"
 
 namespace Ancora {
 
+  enum class DepthFunction
+  {
+    Less = 0, LessEqual, Equal
+  };
+
+  // What a barrier makes the shader writes before it visible to. Combined with |.
+  enum BarrierBits : uint32_t
+  {
+    // Shader storage reads and writes
+    StorageBarrier = 1 << 0,
+    // Indirect draw commands and counts
+    IndirectCommandBarrier = 1 << 1,
+    // StorageBuffer SetData, GetData and Clear
+    BufferUpdateBarrier = 1 << 2,
+    // Texture sampling
+    TextureFetchBarrier = 1 << 3,
+    // Image loads and stores
+    ImageAccessBarrier = 1 << 4
+  };
+
   class RendererAPI
   {
   public:
@@ -13,13 +34,53 @@ namespace Ancora {
     {
       None = 0, OpenGL = 1
     };
+
+    struct StateStatistics
+    {
+      uint32_t StateChanges = 0;
+      // Changes to state that was already set, which never reached the driver
+      uint32_t FilteredStateChanges = 0;
+    };
+
+    struct Capabilities
+    {
+      // Compute shaders, shader storage and indirect draws
+      bool Compute = false;
+      // Rasterizes on the CPU (llvmpipe and the like), where compute work is better done by the
+      // engine itself with SIMD than by the driver's shader emulation
+      bool SoftwareRenderer = false;
+    };
   public:
     virtual void Init() = 0;
+    // Valid after Init()
+    virtual const Capabilities& GetCapabilities() const = 0;
     virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
     virtual void SetClearColor(const glm::vec4& color) = 0;
     virtual void Clear() = 0;
 
-    virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
+    virtual void SetDepthFunction(DepthFunction function) = 0;
+    virtual void SetDepthWrite(bool enabled) = 0;
+    virtual void SetColorWrite(bool enabled) = 0;
+
+    // baseVertex is added to every index, e.g. to draw vertices written to a StreamingBuffer
+    virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t indexOffset = 0, uint32_t baseVertex = 0) = 0;
+    // Draws up to maxDrawCount commands from commandBuffer; the actual count is read on the GPU from drawCountBuffer.
+    // Offsets are in bytes.
+    virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commandBuffer, const Ref<StorageBuffer>& drawCountBuffer, uint32_t maxDrawCount, uint32_t commandOffset = 0, uint32_t drawCountOffset = 0) = 0;
+
+    // Results are only visible to what a later Barrier() names
+    virtual void DispatchCompute(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1) = 0;
+    // Makes earlier shader writes visible to the later commands in bits, a set of BarrierBits
+    virtual void Barrier(uint32_t bits) = 0;
+
+    // Redundant state changes are filtered out. Validation checks each filtered change against
+    // the actual state, which is slow.
+    virtual void SetStateValidation(bool enabled) = 0;
+    virtual bool GetStateValidation() const = 0;
+    // Call after code outside the renderer changed the state without restoring it
+    virtual void InvalidateState() = 0;
+    virtual void ResetStateStats() = 0;
+    virtual StateStatistics GetStateStats() const = 0;
 
     inline static API GetAPI() { return s_API; }
   private:
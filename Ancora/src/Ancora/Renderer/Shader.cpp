@@ -6,12 +6,12 @@
 
 namespace Ancora {
 
-  Ref<Shader> Shader::Create(const std::string& filepath)
+  Ref<Shader> Shader::Create(const std::string& filepath, const std::vector<std::string>& defines)
   {
     switch (Renderer::GetAPI())
     {
       case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
-      case RendererAPI::API::OpenGL:   return std::make_shared<OpenGLShader>(filepath);
+      case RendererAPI::API::OpenGL:   return std::make_shared<OpenGLShader>(filepath, defines);
     }
 
     AE_CORE_ASSERT(false, "Unknown RendererAPI!");
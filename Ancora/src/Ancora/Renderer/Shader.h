@@ -4,6 +4,10 @@
 
 namespace Ancora {
 
+  // Shader files hold stages after "#type <stage>" lines and may #include "file" relative to
+  // themselves. Lines before the first stage are not compiled; "#permutation NAME" there declares
+  // a define that scripts/CompileShaders.py validates the file with and without.
+  // Shaders created from a file reload themselves when it or one of its includes changes.
   class Shader
   {
   public:
@@ -24,7 +28,12 @@ namespace Ancora {
 
     virtual const std::string& GetName() const = 0;
 
-    static Ref<Shader> Create(const std::string& filepath);
+    // Recompiles a shader created from a file, keeping this object. Uniforms need to be set
+    // again afterwards. Returns false and keeps the current program if compilation fails.
+    virtual bool Reload() = 0;
+
+    // Each define is added as "#define <define>" to every stage, selecting one permutation of the file
+    static Ref<Shader> Create(const std::string& filepath, const std::vector<std::string>& defines = {});
     static Ref<Shader> Create(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
   };
 
@@ -0,0 +1,22 @@
+#include "aepch.h"
+#include "ShadowMap.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLShadowMap.h"
+
+namespace Ancora {
+
+  Ref<ShadowMap> ShadowMap::Create(uint32_t resolution, uint32_t layerCount)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLShadowMap>(resolution, layerCount);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
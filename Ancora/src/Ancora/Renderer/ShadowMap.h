@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+namespace Ancora {
+
+  // Array of square depth layers, one per shadow cascade. Sampled with depth comparison.
+  class ShadowMap
+  {
+  public:
+    virtual ~ShadowMap() = default;
+
+    // Makes the layer the depth target, sets the viewport to it and clears it
+    virtual void BeginLayer(uint32_t layer) = 0;
+    virtual void EndLayer() = 0;
+
+    virtual void Bind(uint32_t slot = 0) const = 0;
+
+    virtual uint32_t GetResolution() const = 0;
+    virtual uint32_t GetLayerCount() const = 0;
+
+    static Ref<ShadowMap> Create(uint32_t resolution, uint32_t layerCount);
+  };
+
+}
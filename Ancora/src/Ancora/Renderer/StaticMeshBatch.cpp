@@ -0,0 +1,172 @@
+#include "aepch.h"
+#include "StaticMeshBatch.h"
+
+namespace Ancora {
+
+  static_assert(sizeof(glm::vec4) == 16 && sizeof(glm::mat4) == 64, "StaticMeshBatch relies on tightly packed glm types");
+  static_assert(StaticMeshBatch::DrawCommandSize == 20, "DrawElementsIndirectCommand is five 32-bit values");
+
+  uint32_t StaticMeshBatch::AddMesh(const Mesh& mesh)
+  {
+    AE_CORE_ASSERT(!IsBuilt(), "StaticMeshBatch has already been built!");
+
+    MeshInfo info = {};
+    info.BaseVertex = (int32_t)m_Vertices.size();
+
+    glm::vec3 boundsMin = mesh.Vertices.empty() ? glm::vec3(0.0f) : mesh.Vertices[0].Position;
+    glm::vec3 boundsMax = boundsMin;
+    for (const auto& vertex : mesh.Vertices)
+    {
+      boundsMin = glm::min(boundsMin, vertex.Position);
+      boundsMax = glm::max(boundsMax, vertex.Position);
+    }
+    info.BoundingSphere = glm::vec4((boundsMin + boundsMax) * 0.5f, glm::length(boundsMax - boundsMin) * 0.5f);
+
+    // Indices stay relative to the mesh; BaseVertex offsets them into the arena
+    uint32_t firstIndex = (uint32_t)m_Indices.size();
+    if (mesh.LODs.empty())
+    {
+      info.LODCount = 1;
+      info.FirstIndex[0] = firstIndex;
+      info.IndexCount[0] = (uint32_t)mesh.Indices.size();
+    }
+    else
+    {
+      info.LODCount = std::min((uint32_t)mesh.LODs.size(), Mesh::MaxLODs);
+      for (uint32_t i = 0; i < info.LODCount; i++)
+      {
+        info.FirstIndex[i] = firstIndex + mesh.LODs[i].IndexOffset;
+        info.IndexCount[i] = mesh.LODs[i].IndexCount;
+      }
+    }
+
+    m_Vertices.insert(m_Vertices.end(), mesh.Vertices.begin(), mesh.Vertices.end());
+    m_Indices.insert(m_Indices.end(), mesh.Indices.begin(), mesh.Indices.end());
+    m_MaxMeshVertexCount = std::max(m_MaxMeshVertexCount, (uint32_t)mesh.Vertices.size());
+
+    m_Meshes.push_back(info);
+    return (uint32_t)m_Meshes.size() - 1;
+  }
+
+  uint32_t StaticMeshBatch::AddMaterial(const glm::vec4& color, float shininess)
+  {
+    MaterialParameters parameters;
+    parameters.Color = color;
+    parameters.Shininess = shininess;
+
+    Ref<Material> material = CreateRef<Material>();
+    material->SetParameters(parameters);
+    return AddMaterial(material);
+  }
+
+  uint32_t StaticMeshBatch::AddMaterial(const Ref<Material>& material)
+  {
+    AE_CORE_ASSERT(!IsBuilt(), "StaticMeshBatch has already been built!");
+    return MaterialLibrary::Register(material)->GetIndex();
+  }
+
+  void StaticMeshBatch::AddInstance(uint32_t meshID, const glm::mat4& transform, uint32_t materialID)
+  {
+    AE_CORE_ASSERT(!IsBuilt(), "StaticMeshBatch has already been built!");
+    AE_CORE_ASSERT(meshID < m_Meshes.size(), "Invalid mesh ID!");
+
+    InstanceData instance = {};
+    instance.Transform = transform;
+    instance.MeshID = meshID;
+    instance.MaterialID = materialID;
+    m_Instances.push_back(instance);
+  }
+
+  void StaticMeshBatch::AddModel(const Ref<Model3D>& model, const glm::mat4& transform, uint32_t materialID)
+  {
+    const auto& meshes = model->GetMesh();
+
+    auto it = m_ModelMeshIDs.find(model.get());
+    if (it == m_ModelMeshIDs.end())
+    {
+      uint32_t firstMeshID = (uint32_t)m_Meshes.size();
+      for (const auto& mesh : meshes)
+        AddMesh(mesh);
+      it = m_ModelMeshIDs.emplace(model.get(), firstMeshID).first;
+    }
+
+    for (uint32_t i = 0; i < meshes.size(); i++)
+      AddInstance(it->second + i, transform, materialID);
+  }
+
+  void StaticMeshBatch::Build()
+  {
+    AE_CORE_ASSERT(!IsBuilt(), "StaticMeshBatch has already been built!");
+
+    for (const auto& instance : m_Instances)
+      AE_CORE_ASSERT(instance.MaterialID < MaterialLibrary::GetCount(), "Invalid material ID!");
+
+    m_VertexArray = VertexArray::Create();
+
+    Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create((float*)m_Vertices.data(), (uint32_t)(m_Vertices.size() * sizeof(VertexData3D)));
+    vertexBuffer->SetLayout(VertexData3D::GetLayout());
+    m_VertexArray->AddVertexBuffer(vertexBuffer);
+
+    // Thanks to BaseVertex only the largest single mesh decides the index width
+    Ref<IndexBuffer> indexBuffer;
+    if (m_MaxMeshVertexCount <= std::numeric_limits<uint16_t>::max() + 1)
+    {
+      std::vector<uint16_t> shortIndices(m_Indices.begin(), m_Indices.end());
+      indexBuffer = IndexBuffer::Create(shortIndices.data(), (uint32_t)shortIndices.size());
+    }
+    else
+      indexBuffer = IndexBuffer::Create(m_Indices.data(), (uint32_t)m_Indices.size());
+    m_VertexArray->SetIndexBuffer(indexBuffer);
+
+    m_InstanceCount = (uint32_t)m_Instances.size();
+    uint32_t slotCount = std::max(m_InstanceCount, 1u);
+
+    m_MeshBuffer = StorageBuffer::Create((uint32_t)(m_Meshes.size() * sizeof(MeshInfo)), m_Meshes.data());
+    m_InstanceBuffer = StorageBuffer::Create((uint32_t)(slotCount * sizeof(InstanceData)), m_Instances.empty() ? nullptr : m_Instances.data());
+    // One command per instance and phase at most; the cull shader compacts the visible ones to the front
+    m_CommandBuffer = StorageBuffer::Create(2 * slotCount * sizeof(DrawCommand));
+    for (auto& drawCountBuffer : m_DrawCountBuffers)
+    {
+      drawCountBuffer = StorageBuffer::Create(CounterCount * sizeof(uint32_t));
+      drawCountBuffer->Clear();
+    }
+    m_VisibleInstanceBuffer = StorageBuffer::Create(2 * slotCount * sizeof(uint32_t));
+    m_VisibilityBuffer = StorageBuffer::Create(slotCount * sizeof(uint32_t));
+    m_VisibilityBuffer->Clear();
+
+    AE_CORE_INFO("StaticMeshBatch: {0} meshes, {1} instances, {2} vertices, {3}-bit indices", m_Meshes.size(), m_InstanceCount, m_Vertices.size(), indexBuffer->GetIndexType() == IndexType::UInt16 ? 16 : 32);
+
+    std::vector<VertexData3D>().swap(m_Vertices);
+    std::vector<uint32_t>().swap(m_Indices);
+    std::vector<MeshInfo>().swap(m_Meshes);
+    std::vector<InstanceData>().swap(m_Instances);
+    m_ModelMeshIDs.clear();
+  }
+
+  void StaticMeshBatch::AdvanceFrame()
+  {
+    AE_CORE_ASSERT(IsBuilt(), "StaticMeshBatch has not been built!");
+
+    // Every command of the last frame is issued by now
+    m_DrawCountBuffers[m_FrameIndex]->Fence();
+    m_FrameIndex = (m_FrameIndex + 1) % (uint32_t)m_DrawCountBuffers.size();
+
+    // Keeps the last count while the GPU lags further behind than the counters reach
+    const auto& drawCountBuffer = m_DrawCountBuffers[m_FrameIndex];
+    drawCountBuffer->TryGetData(&m_OccludedCount, sizeof(uint32_t), OccludedCounter * sizeof(uint32_t));
+    drawCountBuffer->Clear();
+  }
+
+  void StaticMeshBatch::Bind() const
+  {
+    AE_CORE_ASSERT(IsBuilt(), "StaticMeshBatch has not been built!");
+
+    m_MeshBuffer->Bind(MeshBinding);
+    m_InstanceBuffer->Bind(InstanceBinding);
+    m_CommandBuffer->Bind(CommandBinding);
+    m_DrawCountBuffers[m_FrameIndex]->Bind(DrawCountBinding);
+    m_VisibleInstanceBuffer->Bind(VisibleInstanceBinding);
+    m_VisibilityBuffer->Bind(VisibilityBinding);
+  }
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "Ancora/Renderer/Model3D.h"
+#include "Ancora/Renderer/Material.h"
+#include "Ancora/Renderer/StorageBuffer.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Static geometry packed into one vertex/index arena and drawn with multi-draw
+  // indirect calls. Culling and LOD selection run in a compute shader, which
+  // writes the draw commands directly; nothing is read back on the CPU except
+  // statistics a few frames late.
+  // Fill it with meshes, materials and instances, call Build() once, then hand
+  // it to Renderer3D::DrawStaticMeshBatch every frame. Material IDs index the
+  // MaterialLibrary, so one batch can use any number of textured materials.
+  class StaticMeshBatch
+  {
+  public:
+    // Shader storage bindings shared with StaticMesh.glsl and StaticMeshCull.glsl
+    enum Binding : uint32_t
+    {
+      MeshBinding = 0,
+      InstanceBinding = 1,
+      CommandBinding = 2,
+      DrawCountBinding = 3,
+      VisibleInstanceBinding = 4,
+      MaterialBinding = MaterialLibrary::MaterialBinding,
+      VisibilityBinding = 6,
+      MaterialTextureBinding = MaterialLibrary::MaterialTextureBinding
+    };
+
+    // Per-frame counters written by the cull shader, in DrawCountBinding
+    enum Counter : uint32_t
+    {
+      FirstPhaseCounter = 0,
+      SecondPhaseCounter = 1,
+      OccludedCounter = 2,
+      CounterCount = 4
+    };
+
+    // Returns the ID to pass to AddInstance. All LODs of the mesh are kept.
+    uint32_t AddMesh(const Mesh& mesh);
+    // Registers the material and returns its ID. ID 0 is the library's default material.
+    uint32_t AddMaterial(const glm::vec4& color, float shininess = 32.0f);
+    uint32_t AddMaterial(const Ref<Material>& material);
+    void AddInstance(uint32_t meshID, const glm::mat4& transform, uint32_t materialID = 0);
+    // Adds every mesh of the model as an instance. Meshes are only stored once per model, as they
+    // are at the time, so later reloads of the model do not reach the batch.
+    void AddModel(const Ref<Model3D>& model, const glm::mat4& transform, uint32_t materialID = 0);
+
+    // Uploads everything to the GPU and frees the CPU copies. Nothing can be added afterwards.
+    void Build();
+    bool IsBuilt() const { return m_VertexArray != nullptr; }
+
+    // Fences the current set of counters, switches to the next one and reads it back if the GPU
+    // is done with it, without waiting. Call once per frame before drawing.
+    void AdvanceFrame();
+    // Binds every storage buffer to its slot
+    void Bind() const;
+
+    uint32_t GetInstanceCount() const { return m_InstanceCount; }
+    // Occluded instances of an earlier frame, the latest one read back
+    uint32_t GetOccludedCount() const { return m_OccludedCount; }
+    const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
+    // Two halves of GetInstanceCount() commands each, one per culling phase
+    const Ref<StorageBuffer>& GetCommandBuffer() const { return m_CommandBuffer; }
+    const Ref<StorageBuffer>& GetDrawCountBuffer() const { return m_DrawCountBuffers[m_FrameIndex]; }
+
+    static const uint32_t DrawCommandSize = 5 * sizeof(uint32_t);
+  private:
+    // The structs below mirror the std430 layouts in the shaders
+    struct MeshInfo
+    {
+      glm::vec4 BoundingSphere;
+      uint32_t LODCount;
+      int32_t BaseVertex;
+      uint32_t FirstIndex[Mesh::MaxLODs];
+      uint32_t IndexCount[Mesh::MaxLODs];
+    };
+
+    struct InstanceData
+    {
+      glm::mat4 Transform;
+      uint32_t MeshID;
+      uint32_t MaterialID;
+      uint32_t Padding[2];
+    };
+
+    // Matches DrawElementsIndirectCommand
+    struct DrawCommand
+    {
+      uint32_t Count;
+      uint32_t InstanceCount;
+      uint32_t FirstIndex;
+      int32_t BaseVertex;
+      uint32_t BaseInstance;
+    };
+
+    std::vector<VertexData3D> m_Vertices;
+    std::vector<uint32_t> m_Indices;
+    uint32_t m_MaxMeshVertexCount = 0;
+    std::vector<MeshInfo> m_Meshes;
+    std::vector<InstanceData> m_Instances;
+    std::unordered_map<const Model3D*, uint32_t> m_ModelMeshIDs;
+    uint32_t m_InstanceCount = 0;
+    uint32_t m_OccludedCount = 0;
+    uint32_t m_FrameIndex = 0;
+
+    Ref<VertexArray> m_VertexArray;
+    Ref<StorageBuffer> m_MeshBuffer;
+    Ref<StorageBuffer> m_InstanceBuffer;
+    Ref<StorageBuffer> m_CommandBuffer;
+    // Ring of counters so reading them back does not wait on the GPU
+    std::array<Ref<StorageBuffer>, 3> m_DrawCountBuffers;
+    Ref<StorageBuffer> m_VisibleInstanceBuffer;
+    // Whether each instance was visible last frame, for two-phase occlusion culling
+    Ref<StorageBuffer> m_VisibilityBuffer;
+  };
+
+}
@@ -0,0 +1,22 @@
+#include "aepch.h"
+#include "StorageBuffer.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLStorageBuffer.h"
+
+namespace Ancora {
+
+  Ref<StorageBuffer> StorageBuffer::Create(uint32_t size, const void* data)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLStorageBuffer>(size, data);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
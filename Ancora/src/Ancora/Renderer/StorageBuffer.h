@@ -0,0 +1,30 @@
+#pragma once
+
+namespace Ancora {
+
+  // Shader storage buffer. Also usable as the source of indirect draw arguments.
+  class StorageBuffer
+  {
+  public:
+    virtual ~StorageBuffer() {}
+
+    virtual void Bind(uint32_t binding) const = 0;
+
+    virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) = 0;
+    // Blocks until the GPU is done writing the buffer, so only read data that is a few frames old
+    virtual void GetData(void* data, uint32_t size, uint32_t offset = 0) const = 0;
+    // Marks the commands issued so far as the ones TryGetData waits for
+    virtual void Fence() = 0;
+    // Reads the buffer without blocking once the GPU has passed the last Fence(). Returns false
+    // and leaves data untouched while it has not, or when there is no fence to wait for.
+    virtual bool TryGetData(void* data, uint32_t size, uint32_t offset = 0) = 0;
+    // Fills the whole buffer with zeros on the GPU
+    virtual void Clear() = 0;
+
+    virtual uint32_t GetSize() const = 0;
+    virtual uint32_t GetRendererID() const = 0;
+
+    static Ref<StorageBuffer> Create(uint32_t size, const void* data = nullptr);
+  };
+
+}
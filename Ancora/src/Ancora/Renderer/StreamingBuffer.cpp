@@ -0,0 +1,22 @@
+#include "aepch.h"
+#include "StreamingBuffer.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLStreamingBuffer.h"
+
+namespace Ancora {
+
+  Ref<StreamingBuffer> StreamingBuffer::Create(uint32_t regionSize, uint32_t regionCount)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLStreamingBuffer>(regionSize, regionCount);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+namespace Ancora {
+
+  // Ring buffer for data that is written by the CPU and drawn once, e.g. batched vertices. It
+  // stays mapped for its whole life and is split into regions; moving on to the next region
+  // fences the one left behind, and the CPU only waits when it catches up with the GPU.
+  class StreamingBuffer
+  {
+  public:
+    struct Allocation
+    {
+      void* Data;
+      // In bytes from the start of the buffer
+      uint32_t Offset;
+    };
+
+    struct Statistics
+    {
+      uint32_t AllocatedBytes = 0;
+      // Times the CPU had to wait for the GPU to finish with a region
+      uint32_t Stalls = 0;
+    };
+
+    virtual ~StreamingBuffer() {}
+
+    // Space for size bytes at an offset that is a multiple of alignment. Write it before drawing
+    // from it; it is reused once the region has gone around the ring.
+    virtual Allocation Allocate(uint32_t size, uint32_t alignment = 4) = 0;
+
+    virtual uint32_t GetSize() const = 0;
+    virtual uint32_t GetRegionSize() const = 0;
+    virtual uint32_t GetRendererID() const = 0;
+
+    virtual void ResetStats() = 0;
+    virtual const Statistics& GetStats() const = 0;
+
+    // A single allocation can be at most regionSize bytes
+    static Ref<StreamingBuffer> Create(uint32_t regionSize, uint32_t regionCount = 3);
+  };
+
+}
@@ -30,6 +30,18 @@ namespace Ancora {
     return nullptr;
   }
 
+  Ref<Texture2D> Texture2D::Create(const Image& image)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLTexture2D>(image);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
   Ref<CubeMap> CubeMap::Create(const std::array<std::string, 6>& cubePaths)
   {
     switch (Renderer::GetAPI())
@@ -42,4 +54,16 @@ namespace Ancora {
     return nullptr;
   }
 
+  Ref<CubeMap> CubeMap::Create(const std::string& path)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLCubeMap>(path);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
 }
@@ -3,6 +3,7 @@
 #include <string>
 
 #include "Ancora/Core/Core.h"
+#include "Ancora/Renderer/Image.h"
 
 namespace Ancora {
 
@@ -14,17 +15,25 @@ namespace Ancora {
     virtual uint32_t GetWidth() const = 0;
     virtual uint32_t GetHeight() const = 0;
     virtual std::string GetName() const = 0;
+    virtual uint32_t GetRendererID() const = 0;
 
     virtual void SetData(void* data, uint32_t size) = 0;
 
     virtual void Bind(uint32_t slot = 0) const = 0;
   };
 
+  // Textures created from a file reload themselves when it changes
   class Texture2D : public Texture
   {
   public:
+    // Reads the file again into this texture. Returns false and keeps the current image if the
+    // file cannot be read or its size or format changed, since the storage is immutable.
+    virtual bool Reload() = 0;
+
     static Ref<Texture2D> Create(uint32_t width, uint32_t height);
     static Ref<Texture2D> Create(const std::string& path);
+    // Uploads an image decoded ahead of time, e.g. on a worker thread. Must be called on the main thread.
+    static Ref<Texture2D> Create(const Image& image);
   };
 
   class CubeMap
@@ -36,7 +45,11 @@ namespace Ancora {
 
     virtual void Bind(uint32_t slot = 0) const = 0;
 
+    // Faces in the order +x, -x, +y, -y, +z, -z, decoded in parallel. Mips are generated.
     static Ref<CubeMap> Create(const std::array<std::string, 6>& cubePaths);
+    // A KTX or DDS cube map, with the mips stored in it (prefiltered ones, say) or generated if
+    // it has none, or an equirectangular .hdr panorama, converted to faces of a quarter of its width
+    static Ref<CubeMap> Create(const std::string& path);
   };
 
 }
@@ -0,0 +1,22 @@
+#include "aepch.h"
+#include "TextureTable.h"
+
+#include "Renderer.h"
+
+#include "Platform/OpenGL/OpenGLTextureTable.h"
+
+namespace Ancora {
+
+  Ref<TextureTable> TextureTable::Create(bool allowBindless)
+  {
+    switch (Renderer::GetAPI())
+    {
+      case RendererAPI::API::None:     AE_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
+      case RendererAPI::API::OpenGL:   return CreateRef<OpenGLTextureTable>(allowBindless);
+    }
+
+    AE_CORE_ASSERT(false, "Unknown RendererAPI!");
+    return nullptr;
+  }
+
+}
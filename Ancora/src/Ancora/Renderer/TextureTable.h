@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Ancora/Renderer/Texture.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Every texture the shaders sample through materials, addressed by a reference instead of a
+  // texture unit, so nothing is bound per draw. References are resident bindless handles when
+  // the driver supports GL_ARB_bindless_texture. Otherwise textures are copied into layers of
+  // texture arrays ("pages") that hold textures of one size and format, and a reference is a
+  // page and layer.
+  class TextureTable
+  {
+  public:
+    // Texture units of the pages, bound by Bind(). Page 0 holds a white texel.
+    static const uint32_t FirstPageUnit = 16;
+    static const uint32_t MaxPages = 8;
+
+    virtual ~TextureTable() = default;
+
+    // Adding the same texture again returns the same reference. Of later changes to the texture
+    // only reloads of its file are picked up.
+    virtual glm::uvec2 Add(const Ref<Texture2D>& texture) = 0;
+    virtual void Bind() const = 0;
+
+    virtual bool IsBindless() const = 0;
+
+    // Falls back to pages when bindless textures are not allowed or not supported
+    static Ref<TextureTable> Create(bool allowBindless = true);
+  };
+
+}
@@ -0,0 +1,229 @@
+#include "aepch.h"
+#include "ChunkStreamer.h"
+
+#include "Ancora/Core/JobSystem.h"
+#include "Ancora/Renderer/Renderer3D.h"
+
+#include <thread>
+
+namespace Ancora {
+
+  ChunkStreamer::ChunkStreamer(const ChunkStreamerSpecification& specification)
+    : m_Specification(specification)
+  {
+    AE_CORE_ASSERT(specification.ChunkLength > 0.0f, "Chunk length must be positive!");
+    AE_CORE_ASSERT(specification.Generate, "ChunkStreamer needs a generator!");
+
+    std::vector<Ref<Material>> materials;
+    for (const auto& layer : m_Specification.Layers)
+      materials.push_back(layer.LayerMaterial ? MaterialLibrary::Register(layer.LayerMaterial) : nullptr);
+
+    // Every chunk in range, plus two so chunks still being generated after they went out of
+    // range do not hold up new ones
+    uint32_t slotCount = m_Specification.ChunksBehind + 1 + m_Specification.ChunksAhead + 2;
+    for (uint32_t i = 0; i < slotCount; i++)
+    {
+      Scope<Slot> slot = CreateScope<Slot>();
+      slot->Model = CreateRef<Model3D>();
+      slot->Model->SetName("Chunk");
+
+      for (uint32_t j = 0; j < m_Specification.Layers.size(); j++)
+      {
+        const ChunkLayer& layer = m_Specification.Layers[j];
+        Mesh mesh;
+        mesh.Vertices.reserve(layer.MaxVertices);
+        mesh.Indices.reserve(layer.MaxIndices);
+        mesh.LODs.push_back({ 0, 0, 0.0f });
+        mesh.MeshMaterial = materials[j];
+
+        mesh.MeshVertexArray = VertexArray::Create();
+        Ref<VertexBuffer> vertexBuffer = VertexBuffer::Create(layer.MaxVertices * (uint32_t)sizeof(VertexData3D));
+        vertexBuffer->SetLayout(VertexData3D::GetLayout());
+        mesh.MeshVertexArray->AddVertexBuffer(vertexBuffer);
+        IndexType indexType = layer.MaxVertices <= std::numeric_limits<uint16_t>::max() + 1 ? IndexType::UInt16 : IndexType::UInt32;
+        mesh.MeshVertexArray->SetIndexBuffer(IndexBuffer::Create(layer.MaxIndices, indexType));
+
+        slot->Model->AddMesh(std::move(mesh));
+      }
+      m_Slots.push_back(std::move(slot));
+    }
+  }
+
+  ChunkStreamer::~ChunkStreamer()
+  {
+    // The jobs write into the slots
+    for (const auto& slot : m_Slots)
+    {
+      while (slot->State == SlotState::Generating && !slot->Done.load(std::memory_order_acquire))
+        std::this_thread::yield();
+    }
+  }
+
+  void ChunkStreamer::Update(float distance)
+  {
+    int64_t current = (int64_t)std::floor(distance / m_Specification.ChunkLength);
+    int64_t first = current - (int64_t)m_Specification.ChunksBehind;
+    int64_t last = current + (int64_t)m_Specification.ChunksAhead;
+
+    for (auto& slot : m_Slots)
+    {
+      if (slot->State == SlotState::Generating && slot->Done.load(std::memory_order_acquire))
+      {
+        slot->State = slot->Evicted ? SlotState::Free : SlotState::Generated;
+        slot->Evicted = false;
+      }
+
+      if (slot->State == SlotState::Free || (slot->Chunk >= first && slot->Chunk <= last))
+        continue;
+
+      if (slot->State == SlotState::Generating)
+      {
+        slot->Evicted = true;
+        continue;
+      }
+
+      slot->State = SlotState::Free;
+      m_Stats.EvictedChunks++;
+    }
+
+    // The chunks right ahead of the viewer first, then the rest ahead, then those behind
+    auto request = [this](int64_t chunk)
+    {
+      Slot* freeSlot = nullptr;
+      for (auto& slot : m_Slots)
+      {
+        if (slot->State != SlotState::Free && !slot->Evicted && slot->Chunk == chunk)
+          return true;
+        if (slot->State == SlotState::Free && !freeSlot)
+          freeSlot = slot.get();
+      }
+
+      if (!freeSlot)
+        return false;
+
+      Generate(*freeSlot, chunk);
+      return true;
+    };
+
+    bool slotsLeft = true;
+    for (int64_t chunk = current; chunk <= last && slotsLeft; chunk++)
+      slotsLeft = request(chunk);
+    for (int64_t chunk = current - 1; chunk >= first && slotsLeft; chunk--)
+      slotsLeft = request(chunk);
+
+    // Uploads the nearest chunks within the budget
+    std::vector<Slot*> pending;
+    for (auto& slot : m_Slots)
+    {
+      if (slot->State == SlotState::Generated)
+        pending.push_back(slot.get());
+    }
+    std::sort(pending.begin(), pending.end(), [current](const Slot* a, const Slot* b)
+    {
+      return std::abs(a->Chunk - current) < std::abs(b->Chunk - current);
+    });
+
+    m_Stats.UploadedBytes = 0;
+    for (Slot* slot : pending)
+    {
+      uint32_t size = GetUploadSize(*slot);
+      if (m_Stats.UploadedBytes > 0 && m_Stats.UploadedBytes + size > m_Specification.UploadBudget)
+        break;
+
+      Upload(*slot);
+      m_Stats.UploadedBytes += size;
+    }
+
+    m_Stats.ResidentChunks = m_Stats.GeneratingChunks = m_Stats.PendingUploads = 0;
+    for (const auto& slot : m_Slots)
+    {
+      m_Stats.ResidentChunks += slot->State == SlotState::Resident;
+      m_Stats.GeneratingChunks += slot->State == SlotState::Generating;
+      m_Stats.PendingUploads += slot->State == SlotState::Generated;
+    }
+  }
+
+  void ChunkStreamer::Submit() const
+  {
+    for (const auto& slot : m_Slots)
+    {
+      if (slot->State == SlotState::Resident)
+        Renderer3D::DrawModel(slot->Model, glm::mat4(1.0f));
+    }
+  }
+
+  bool ChunkStreamer::IsResident(int64_t chunk) const
+  {
+    for (const auto& slot : m_Slots)
+    {
+      if (slot->State == SlotState::Resident && slot->Chunk == chunk)
+        return true;
+    }
+    return false;
+  }
+
+  void ChunkStreamer::Generate(Slot& slot, int64_t chunk)
+  {
+    slot.Chunk = chunk;
+    slot.State = SlotState::Generating;
+    slot.Done.store(false, std::memory_order_relaxed);
+
+    Slot* target = &slot;
+    JobSystem::Execute([this, target]()
+    {
+      auto& layers = target->Model->GetMeshes();
+      for (auto& mesh : layers)
+      {
+        mesh.Vertices.clear();
+        mesh.Indices.clear();
+      }
+
+      m_Specification.Generate(target->Chunk, layers);
+      // The chunk is not drawn until it is uploaded, so its bounds can change here
+      target->Model->CalculateBounds();
+      target->Done.store(true, std::memory_order_release);
+    });
+  }
+
+  uint32_t ChunkStreamer::GetUploadSize(const Slot& slot) const
+  {
+    uint32_t size = 0;
+    for (const auto& mesh : slot.Model->GetMesh())
+      size += (uint32_t)(mesh.Vertices.size() * sizeof(VertexData3D) + mesh.Indices.size() * IndexTypeSize(mesh.MeshVertexArray->GetIndexBuffer()->GetIndexType()));
+    return size;
+  }
+
+  void ChunkStreamer::Upload(Slot& slot)
+  {
+    auto& layers = slot.Model->GetMeshes();
+    for (uint32_t i = 0; i < layers.size(); i++)
+    {
+      Mesh& mesh = layers[i];
+      const ChunkLayer& layer = m_Specification.Layers[i];
+      mesh.LODs[0].IndexCount = 0;
+      if (mesh.Vertices.size() > layer.MaxVertices || mesh.Indices.size() > layer.MaxIndices)
+      {
+        AE_CORE_WARN("ChunkStreamer: layer {0} of chunk {1} does not fit its buffers and is not drawn", i, slot.Chunk);
+        continue;
+      }
+
+      // Bound first, so binding the index buffer does not attach it to another vertex array
+      mesh.MeshVertexArray->Bind();
+      mesh.MeshVertexArray->GetVertexBuffers()[0]->SetData(mesh.Vertices.data(), (uint32_t)(mesh.Vertices.size() * sizeof(VertexData3D)));
+
+      const Ref<IndexBuffer>& indexBuffer = mesh.MeshVertexArray->GetIndexBuffer();
+      if (indexBuffer->GetIndexType() == IndexType::UInt16)
+      {
+        m_ShortIndices.assign(mesh.Indices.begin(), mesh.Indices.end());
+        indexBuffer->SetData(m_ShortIndices.data(), (uint32_t)m_ShortIndices.size());
+      }
+      else
+        indexBuffer->SetData(mesh.Indices.data(), (uint32_t)mesh.Indices.size());
+
+      mesh.LODs[0].IndexCount = (uint32_t)mesh.Indices.size();
+    }
+
+    slot.State = SlotState::Resident;
+  }
+
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "Ancora/Renderer/Model3D.h"
+
+#include <atomic>
+#include <functional>
+
+namespace Ancora {
+
+  struct ChunkLayer
+  {
+    // Capacity of the layer's pooled GPU buffers. A chunk whose layer exceeds it is not drawn.
+    uint32_t MaxVertices = 0;
+    uint32_t MaxIndices = 0;
+    // Null draws with the default material
+    Ref<Material> LayerMaterial;
+  };
+
+  struct ChunkStreamerSpecification
+  {
+    // Chunks are numbered by distance along the track: chunk i covers [i, i + 1) * ChunkLength
+    float ChunkLength = 50.0f;
+    uint32_t ChunksAhead = 8;
+    uint32_t ChunksBehind = 2;
+    // One mesh per layer in every chunk, e.g. road surface, terrain and props
+    std::vector<ChunkLayer> Layers;
+    // Bytes of vertex and index data uploaded per frame at most. The nearest waiting chunk is
+    // uploaded even if it alone exceeds the budget.
+    uint32_t UploadBudget = 2 * 1024 * 1024;
+    // Fills the world space vertices and indices of every layer of a chunk. Runs on worker
+    // threads, so it may only write to the meshes it is given. They come in empty, but keep the
+    // capacity of the chunks they held before.
+    std::function<void(int64_t chunk, std::vector<Mesh>& layers)> Generate;
+  };
+
+  // Keeps the chunks of a track resident around a moving viewer, like the road ahead of the
+  // player. Chunks coming into range are generated on the JobSystem, uploaded a few per frame
+  // within a byte budget, and chunks falling behind are evicted back into a fixed pool of slots,
+  // whose CPU and GPU buffers the next chunks reuse. Memory stays flat however far the viewer goes.
+  class ChunkStreamer
+  {
+  public:
+    struct Statistics
+    {
+      uint32_t ResidentChunks = 0;
+      uint32_t GeneratingChunks = 0;
+      // Generated, waiting for upload budget
+      uint32_t PendingUploads = 0;
+      // In the last Update()
+      uint32_t UploadedBytes = 0;
+      uint32_t EvictedChunks = 0;
+    };
+
+    ChunkStreamer(const ChunkStreamerSpecification& specification);
+    // Waits for chunks still being generated
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    // Call once per frame with the viewer's distance along the track
+    void Update(float distance);
+    // Draws the resident chunks. Call between Renderer3D::BeginScene and EndScene.
+    void Submit() const;
+
+    bool IsResident(int64_t chunk) const;
+    const Statistics& GetStats() const { return m_Stats; }
+  private:
+    enum class SlotState
+    {
+      Free = 0, Generating, Generated, Resident
+    };
+
+    struct Slot
+    {
+      // Its meshes hold the chunk's CPU data and the pooled GPU buffers
+      Ref<Model3D> Model;
+      int64_t Chunk = 0;
+      SlotState State = SlotState::Free;
+      // Set by the generating job once it is done
+      std::atomic<bool> Done = false;
+      // The chunk went out of range while it was generated; freed once the job is done
+      bool Evicted = false;
+    };
+
+    void Generate(Slot& slot, int64_t chunk);
+    uint32_t GetUploadSize(const Slot& slot) const;
+    void Upload(Slot& slot);
+  private:
+    ChunkStreamerSpecification m_Specification;
+    std::vector<Scope<Slot>> m_Slots;
+    // Staging for 16-bit index buffers
+    std::vector<uint16_t> m_ShortIndices;
+    Statistics m_Stats;
+  };
+
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Ancora/Renderer/Model3D.h"
+#include "Ancora/Renderer/Material.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  struct TransformComponent
+  {
+    glm::mat4 Transform = glm::mat4(1.0f);
+  };
+
+  // Drawn by SceneRenderer at the entity's TransformComponent
+  struct ModelComponent
+  {
+    Ref<Model3D> Model;
+    // Used instead of the model's own materials if set
+    Ref<Material> MaterialOverride;
+  };
+
+}
@@ -0,0 +1,200 @@
+#include "aepch.h"
+#include "SceneGraph.h"
+
+namespace Ancora {
+
+  uint32_t SceneGraph::CreateNode(uint32_t parent, const glm::mat4& localTransform)
+  {
+    uint32_t node;
+    if (!m_FreeNodes.empty())
+    {
+      node = m_FreeNodes.back();
+      m_FreeNodes.pop_back();
+    }
+    else
+    {
+      node = (uint32_t)m_Slots.size();
+      m_Slots.push_back(InvalidNode);
+    }
+
+    uint32_t parentSlot = parent == InvalidNode ? InvalidNode : GetSlot(parent);
+    uint32_t depth = parent == InvalidNode ? 0 : m_Depths[parentSlot] + 1;
+    // Appending keeps parents first, but a shallower node breaks the depth order
+    if (!m_Depths.empty() && depth < m_Depths.back())
+      m_Sorted = false;
+
+    uint32_t slot = (uint32_t)m_Nodes.size();
+    m_Slots[node] = slot;
+    m_Nodes.push_back(node);
+    m_ParentSlots.push_back(parentSlot);
+    m_Depths.push_back(depth);
+    m_LocalTransforms.push_back(localTransform);
+    m_WorldTransforms.push_back(localTransform);
+    m_Dirty.push_back(0);
+    MarkDirty(slot);
+    return node;
+  }
+
+  void SceneGraph::DestroyNode(uint32_t node)
+  {
+    // Descendants have to come after the node
+    if (!m_Sorted)
+      Sort();
+
+    uint32_t root = GetSlot(node);
+    uint32_t count = (uint32_t)m_Nodes.size();
+    std::vector<uint32_t> newSlots(count, InvalidNode);
+    uint32_t write = root;
+    for (uint32_t slot = root; slot < count; slot++)
+    {
+      uint32_t parent = m_ParentSlots[slot];
+      bool destroyed = slot == root || (parent != InvalidNode && parent >= root && newSlots[parent] == InvalidNode);
+      if (destroyed)
+      {
+        m_Slots[m_Nodes[slot]] = InvalidNode;
+        m_FreeNodes.push_back(m_Nodes[slot]);
+        continue;
+      }
+
+      // Compacting keeps the order, so the arrays stay sorted
+      newSlots[slot] = write;
+      m_Slots[m_Nodes[slot]] = write;
+      m_Nodes[write] = m_Nodes[slot];
+      m_ParentSlots[write] = parent == InvalidNode || parent < root ? parent : newSlots[parent];
+      m_Depths[write] = m_Depths[slot];
+      m_LocalTransforms[write] = m_LocalTransforms[slot];
+      m_WorldTransforms[write] = m_WorldTransforms[slot];
+      m_Dirty[write] = m_Dirty[slot];
+      write++;
+    }
+
+    m_Nodes.resize(write);
+    m_ParentSlots.resize(write);
+    m_Depths.resize(write);
+    m_LocalTransforms.resize(write);
+    m_WorldTransforms.resize(write);
+    m_Dirty.resize(write);
+    m_FirstDirty = std::min(m_FirstDirty, root);
+  }
+
+  void SceneGraph::SetParent(uint32_t node, uint32_t parent)
+  {
+    AE_CORE_ASSERT(parent == InvalidNode || !IsAncestor(node, parent), "A node cannot be attached to itself or its descendants!");
+
+    uint32_t slot = GetSlot(node);
+    m_ParentSlots[slot] = parent == InvalidNode ? InvalidNode : GetSlot(parent);
+    m_Sorted = false;
+    MarkDirty(slot);
+  }
+
+  uint32_t SceneGraph::GetParent(uint32_t node) const
+  {
+    uint32_t parentSlot = m_ParentSlots[GetSlot(node)];
+    return parentSlot == InvalidNode ? InvalidNode : m_Nodes[parentSlot];
+  }
+
+  void SceneGraph::SetLocalTransform(uint32_t node, const glm::mat4& transform)
+  {
+    uint32_t slot = GetSlot(node);
+    m_LocalTransforms[slot] = transform;
+    MarkDirty(slot);
+  }
+
+  void SceneGraph::Update()
+  {
+    if (!m_Sorted)
+      Sort();
+
+    // Parents come first, so a dirty parent has marked its children by the time they are reached
+    uint32_t count = (uint32_t)m_Nodes.size();
+    m_UpdatedCount = 0;
+    for (uint32_t slot = m_FirstDirty; slot < count; slot++)
+    {
+      uint32_t parent = m_ParentSlots[slot];
+      if (parent != InvalidNode && m_Dirty[parent])
+        m_Dirty[slot] = 1;
+      if (!m_Dirty[slot])
+        continue;
+
+      m_WorldTransforms[slot] = parent == InvalidNode ? m_LocalTransforms[slot] : m_WorldTransforms[parent] * m_LocalTransforms[slot];
+      m_UpdatedCount++;
+    }
+
+    if (m_FirstDirty < count)
+      std::fill(m_Dirty.begin() + m_FirstDirty, m_Dirty.end(), (uint8_t)0);
+    m_FirstDirty = count;
+  }
+
+  uint32_t SceneGraph::GetSlot(uint32_t node) const
+  {
+    AE_CORE_ASSERT(node < m_Slots.size() && m_Slots[node] != InvalidNode, "Invalid scene graph node!");
+    return m_Slots[node];
+  }
+
+  bool SceneGraph::IsAncestor(uint32_t ancestor, uint32_t node) const
+  {
+    uint32_t ancestorSlot = GetSlot(ancestor);
+    for (uint32_t slot = GetSlot(node); slot != InvalidNode; slot = m_ParentSlots[slot])
+    {
+      if (slot == ancestorSlot)
+        return true;
+    }
+    return false;
+  }
+
+  void SceneGraph::Sort()
+  {
+    uint32_t count = (uint32_t)m_Nodes.size();
+
+    // Parents may come after their children here. Hierarchies are shallow, so walking up is cheap.
+    for (uint32_t slot = 0; slot < count; slot++)
+    {
+      uint32_t depth = 0;
+      for (uint32_t parent = m_ParentSlots[slot]; parent != InvalidNode; parent = m_ParentSlots[parent])
+        depth++;
+      m_Depths[slot] = depth;
+    }
+
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; i++)
+      order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) { return m_Depths[a] < m_Depths[b]; });
+
+    std::vector<uint32_t> newSlots(count);
+    for (uint32_t i = 0; i < count; i++)
+      newSlots[order[i]] = i;
+
+    std::vector<uint32_t> nodes(count), parentSlots(count), depths(count);
+    std::vector<glm::mat4> localTransforms(count), worldTransforms(count);
+    std::vector<uint8_t> dirty(count);
+    m_FirstDirty = count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+      uint32_t slot = order[i];
+      nodes[i] = m_Nodes[slot];
+      parentSlots[i] = m_ParentSlots[slot] == InvalidNode ? InvalidNode : newSlots[m_ParentSlots[slot]];
+      depths[i] = m_Depths[slot];
+      localTransforms[i] = m_LocalTransforms[slot];
+      worldTransforms[i] = m_WorldTransforms[slot];
+      dirty[i] = m_Dirty[slot];
+      m_Slots[nodes[i]] = i;
+      if (dirty[i])
+        m_FirstDirty = std::min(m_FirstDirty, i);
+    }
+
+    m_Nodes = std::move(nodes);
+    m_ParentSlots = std::move(parentSlots);
+    m_Depths = std::move(depths);
+    m_LocalTransforms = std::move(localTransforms);
+    m_WorldTransforms = std::move(worldTransforms);
+    m_Dirty = std::move(dirty);
+    m_Sorted = true;
+  }
+
+  void SceneGraph::MarkDirty(uint32_t slot)
+  {
+    m_Dirty[slot] = 1;
+    m_FirstDirty = std::min(m_FirstDirty, slot);
+  }
+
+}
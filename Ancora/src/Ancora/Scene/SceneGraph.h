@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+
+#include <glm/glm.hpp>
+
+namespace Ancora {
+
+  // Transform hierarchy stored as parallel arrays sorted by depth, so every parent comes before
+  // its children. Update() computes world matrices in one pass over the arrays, touching only
+  // nodes whose local transform changed and their descendants: moving a bike costs one multiply
+  // for the bike and one for each attached rider and wheel.
+  // Nodes are addressed by IDs that stay valid while the arrays are reordered.
+  class SceneGraph
+  {
+  public:
+    static constexpr uint32_t InvalidNode = 0xffffffff;
+
+    uint32_t CreateNode(uint32_t parent = InvalidNode, const glm::mat4& localTransform = glm::mat4(1.0f));
+    // Destroys the node and everything attached to it
+    void DestroyNode(uint32_t node);
+
+    // Keeps the local transform, so the node moves with its new parent
+    void SetParent(uint32_t node, uint32_t parent);
+    uint32_t GetParent(uint32_t node) const;
+
+    void SetLocalTransform(uint32_t node, const glm::mat4& transform);
+    const glm::mat4& GetLocalTransform(uint32_t node) const { return m_LocalTransforms[GetSlot(node)]; }
+    // As of the last Update()
+    const glm::mat4& GetWorldTransform(uint32_t node) const { return m_WorldTransforms[GetSlot(node)]; }
+
+    void Update();
+
+    uint32_t GetNodeCount() const { return (uint32_t)m_Nodes.size(); }
+    // World matrices computed by the last Update()
+    uint32_t GetUpdatedCount() const { return m_UpdatedCount; }
+  private:
+    uint32_t GetSlot(uint32_t node) const;
+    bool IsAncestor(uint32_t ancestor, uint32_t node) const;
+    // Restores the depth order after nodes were added, moved or destroyed
+    void Sort();
+    void MarkDirty(uint32_t slot);
+  private:
+    // Indexed by slot, in depth order
+    std::vector<uint32_t> m_Nodes;
+    std::vector<uint32_t> m_ParentSlots;
+    std::vector<uint32_t> m_Depths;
+    std::vector<glm::mat4> m_LocalTransforms;
+    std::vector<glm::mat4> m_WorldTransforms;
+    std::vector<uint8_t> m_Dirty;
+
+    // Indexed by node ID, InvalidNode for free IDs
+    std::vector<uint32_t> m_Slots;
+    std::vector<uint32_t> m_FreeNodes;
+
+    // Slots before this one are clean
+    uint32_t m_FirstDirty = 0;
+    bool m_Sorted = true;
+    uint32_t m_UpdatedCount = 0;
+  };
+
+}
@@ -0,0 +1,56 @@
+#include "aepch.h"
+#include "SceneRenderer.h"
+
+#include "Components.h"
+#include "Ancora/Renderer/Renderer3D.h"
+
+namespace Ancora {
+
+  // One per chunk, kept across frames so their storage is reused and the renderer keeps their
+  // LOD history. Chunks keep their order while no entities move between archetypes.
+  static std::vector<Scope<CommandBuffer>> s_CommandBuffers;
+  static std::vector<CommandBuffer*> s_SubmittedBuffers;
+
+  void SceneRenderer::Submit(World& world)
+  {
+    uint32_t chunkCount = world.GetChunkCount<TransformComponent, ModelComponent>();
+    while (s_CommandBuffers.size() < chunkCount)
+      s_CommandBuffers.push_back(CreateScope<CommandBuffer>());
+    s_CommandBuffers.resize(chunkCount);
+
+    world.ParallelEachChunk<TransformComponent, ModelComponent>([](uint32_t chunk, uint32_t count, TransformComponent* transforms, ModelComponent* models)
+    {
+      CommandBuffer& buffer = *s_CommandBuffers[chunk];
+      buffer.Reset();
+
+      const Material* boundMaterial = nullptr;
+      for (uint32_t i = 0; i < count; i++)
+      {
+        const ModelComponent& model = models[i];
+        if (!model.Model)
+          continue;
+
+        // Neighbouring entities mostly share a material, so it is only bound on a change
+        if (model.MaterialOverride.get() != boundMaterial)
+        {
+          buffer.BindMaterial(model.MaterialOverride);
+          boundMaterial = model.MaterialOverride.get();
+        }
+        buffer.Draw(model.Model, transforms[i].Transform);
+      }
+    });
+
+    s_SubmittedBuffers.clear();
+    for (const auto& buffer : s_CommandBuffers)
+    {
+      if (buffer->GetDrawCount() > 0)
+        s_SubmittedBuffers.push_back(buffer.get());
+    }
+    Renderer3D::Submit(s_SubmittedBuffers.data(), (uint32_t)s_SubmittedBuffers.size());
+
+    // The renderer holds its own references, so models and materials are not kept alive here
+    for (const auto& buffer : s_CommandBuffers)
+      buffer->Reset();
+  }
+
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "World.h"
+
+namespace Ancora {
+
+  // Render extraction: records the entities with a TransformComponent and a ModelComponent into
+  // one command buffer per chunk, in parallel, and submits them all to Renderer3D at once.
+  class SceneRenderer
+  {
+  public:
+    // Call between Renderer3D::BeginScene and EndScene
+    static void Submit(World& world);
+  };
+
+}
@@ -0,0 +1,253 @@
+#include "aepch.h"
+#include "World.h"
+
+#include <mutex>
+
+namespace Ancora {
+
+  // Fixed storage, so GetInfo needs no lock: an entry never moves, and it is written before
+  // its ID is handed out
+  static std::array<ComponentInfo, ComponentRegistry::MaxComponents> s_ComponentInfos;
+  static uint32_t s_ComponentCount = 0;
+  // Types can be used for the first time inside jobs
+  static std::mutex s_RegisterMutex;
+
+  const ComponentInfo& ComponentRegistry::GetInfo(uint32_t id)
+  {
+    return s_ComponentInfos[id];
+  }
+
+  uint32_t ComponentRegistry::Register(const ComponentInfo& info)
+  {
+    std::lock_guard<std::mutex> lock(s_RegisterMutex);
+    AE_CORE_ASSERT(s_ComponentCount < MaxComponents, "Too many component types!");
+    s_ComponentInfos[s_ComponentCount] = info;
+    return s_ComponentCount++;
+  }
+
+  static uint32_t AlignUp(uint32_t value, uint32_t alignment)
+  {
+    return (value + alignment - 1) / alignment * alignment;
+  }
+
+  Archetype::Archetype(uint64_t mask)
+    : m_Mask(mask)
+  {
+    m_ComponentIndices.fill(NoComponent);
+    uint32_t entitySize = sizeof(Entity);
+    for (uint32_t id = 0; id < ComponentRegistry::MaxComponents; id++)
+    {
+      if (!(mask & (1ull << id)))
+        continue;
+
+      m_ComponentIndices[id] = (uint8_t)m_Components.size();
+      m_Components.push_back(id);
+      entitySize += ComponentRegistry::GetInfo(id).Size;
+    }
+
+    // As many entities as fit with every array aligned
+    m_Capacity = ChunkSize / entitySize;
+    m_Offsets.resize(m_Components.size());
+    while (true)
+    {
+      uint32_t offset = m_Capacity * sizeof(Entity);
+      for (uint32_t i = 0; i < m_Components.size(); i++)
+      {
+        const ComponentInfo& info = ComponentRegistry::GetInfo(m_Components[i]);
+        m_Offsets[i] = AlignUp(offset, info.Alignment);
+        offset = m_Offsets[i] + m_Capacity * info.Size;
+      }
+
+      if (offset <= ChunkSize || m_Capacity == 1)
+        break;
+      m_Capacity--;
+    }
+    AE_CORE_ASSERT(m_Capacity > 0 && entitySize <= ChunkSize, "Components of an entity do not fit into a chunk!");
+  }
+
+  Archetype::~Archetype()
+  {
+    for (auto& chunk : m_Chunks)
+    {
+      for (uint32_t i = 0; i < m_Components.size(); i++)
+      {
+        const ComponentInfo& info = ComponentRegistry::GetInfo(m_Components[i]);
+        for (uint32_t row = 0; row < chunk.Count; row++)
+          info.Destroy(chunk.Data.get() + m_Offsets[i] + row * info.Size);
+      }
+    }
+  }
+
+  uint32_t Archetype::GetEntityCount() const
+  {
+    return m_Chunks.empty() ? 0 : (uint32_t)(m_Chunks.size() - 1) * m_Capacity + m_Chunks.back().Count;
+  }
+
+  void* Archetype::GetComponent(uint32_t chunk, uint32_t row, uint32_t component) const
+  {
+    uint32_t index = m_ComponentIndices[component];
+    return m_Chunks[chunk].Data.get() + m_Offsets[index] + row * ComponentRegistry::GetInfo(component).Size;
+  }
+
+  std::pair<uint32_t, uint32_t> Archetype::AddRow(Entity entity)
+  {
+    if (m_Chunks.empty() || m_Chunks.back().Count == m_Capacity)
+    {
+      // new[] aligns to at least 16 bytes, the largest component alignment allowed
+      Chunk chunk;
+      chunk.Data.reset(new uint8_t[ChunkSize]);
+      m_Chunks.push_back(std::move(chunk));
+    }
+
+    uint32_t chunk = (uint32_t)m_Chunks.size() - 1;
+    uint32_t row = m_Chunks[chunk].Count++;
+    GetEntities(m_Chunks[chunk])[row] = entity;
+    return { chunk, row };
+  }
+
+  Entity Archetype::RemoveRow(uint32_t chunk, uint32_t row)
+  {
+    uint32_t lastChunk = (uint32_t)m_Chunks.size() - 1;
+    uint32_t lastRow = m_Chunks[lastChunk].Count - 1;
+
+    Entity moved = GetEntities(m_Chunks[lastChunk])[lastRow];
+    if (chunk != lastChunk || row != lastRow)
+    {
+      GetEntities(m_Chunks[chunk])[row] = moved;
+      for (uint32_t id : m_Components)
+      {
+        const ComponentInfo& info = ComponentRegistry::GetInfo(id);
+        void* last = GetComponent(lastChunk, lastRow, id);
+        info.MoveConstruct(GetComponent(chunk, row, id), last);
+        info.Destroy(last);
+      }
+    }
+
+    if (--m_Chunks[lastChunk].Count == 0)
+      m_Chunks.pop_back();
+    return moved;
+  }
+
+  World::~World()
+  {
+    // Archetypes destroy the components they hold
+    m_Archetypes.clear();
+  }
+
+  Entity World::CreateEntity()
+  {
+    uint32_t index;
+    if (!m_FreeEntities.empty())
+    {
+      index = m_FreeEntities.back();
+      m_FreeEntities.pop_back();
+    }
+    else
+    {
+      index = (uint32_t)m_Entities.size();
+      m_Entities.emplace_back();
+    }
+
+    Entity entity = { index, m_Entities[index].Generation };
+    Archetype* archetype = GetArchetype(0);
+    auto [chunk, row] = archetype->AddRow(entity);
+    m_Entities[index].Location = archetype;
+    m_Entities[index].Chunk = chunk;
+    m_Entities[index].Row = row;
+    m_EntityCount++;
+    return entity;
+  }
+
+  void World::DestroyEntity(Entity entity)
+  {
+    const EntityRecord& record = GetRecord(entity);
+    Archetype* archetype = record.Location;
+    for (uint32_t id : archetype->GetComponentIDs())
+      ComponentRegistry::GetInfo(id).Destroy(archetype->GetComponent(record.Chunk, record.Row, id));
+
+    Entity moved = archetype->RemoveRow(record.Chunk, record.Row);
+    if (moved != entity)
+    {
+      m_Entities[moved.Index].Chunk = record.Chunk;
+      m_Entities[moved.Index].Row = record.Row;
+    }
+
+    EntityRecord& freed = m_Entities[entity.Index];
+    freed.Location = nullptr;
+    freed.Generation++;
+    m_FreeEntities.push_back(entity.Index);
+    m_EntityCount--;
+  }
+
+  bool World::IsAlive(Entity entity) const
+  {
+    return entity.Index < m_Entities.size() && m_Entities[entity.Index].Location && m_Entities[entity.Index].Generation == entity.Generation;
+  }
+
+  void* World::AddComponent(Entity entity, uint32_t component)
+  {
+    MoveEntity(entity, GetArchetype(GetRecord(entity).Location->GetMask() | (1ull << component)));
+    const EntityRecord& record = GetRecord(entity);
+    return record.Location->GetComponent(record.Chunk, record.Row, component);
+  }
+
+  void World::RemoveComponent(Entity entity, uint32_t component)
+  {
+    AE_CORE_ASSERT(HasComponent(entity, component), "Entity does not have the component!");
+    MoveEntity(entity, GetArchetype(GetRecord(entity).Location->GetMask() & ~(1ull << component)));
+  }
+
+  void* World::GetComponent(Entity entity, uint32_t component)
+  {
+    AE_CORE_ASSERT(HasComponent(entity, component), "Entity does not have the component!");
+    const EntityRecord& record = GetRecord(entity);
+    return record.Location->GetComponent(record.Chunk, record.Row, component);
+  }
+
+  bool World::HasComponent(Entity entity, uint32_t component) const
+  {
+    return GetRecord(entity).Location->GetMask() & (1ull << component);
+  }
+
+  Archetype* World::GetArchetype(uint64_t mask)
+  {
+    auto& archetype = m_Archetypes[mask];
+    if (!archetype)
+      archetype = CreateScope<Archetype>(mask);
+    return archetype.get();
+  }
+
+  void World::MoveEntity(Entity entity, Archetype* target)
+  {
+    EntityRecord& record = m_Entities[entity.Index];
+    Archetype* source = record.Location;
+    auto [chunk, row] = target->AddRow(entity);
+
+    for (uint32_t id : source->GetComponentIDs())
+    {
+      const ComponentInfo& info = ComponentRegistry::GetInfo(id);
+      void* component = source->GetComponent(record.Chunk, record.Row, id);
+      if (target->GetMask() & (1ull << id))
+        info.MoveConstruct(target->GetComponent(chunk, row, id), component);
+      info.Destroy(component);
+    }
+
+    Entity moved = source->RemoveRow(record.Chunk, record.Row);
+    if (moved != entity)
+    {
+      m_Entities[moved.Index].Chunk = record.Chunk;
+      m_Entities[moved.Index].Row = record.Row;
+    }
+
+    record.Location = target;
+    record.Chunk = chunk;
+    record.Row = row;
+  }
+
+  const World::EntityRecord& World::GetRecord(Entity entity) const
+  {
+    AE_CORE_ASSERT(IsAlive(entity), "Entity has been destroyed!");
+    return m_Entities[entity.Index];
+  }
+
+}
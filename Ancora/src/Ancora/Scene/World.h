@@ -0,0 +1,236 @@
+#pragma once
+
+#include "Ancora/Core/Core.h"
+#include "Ancora/Core/JobSystem.h"
+
+#include <new>
+#include <type_traits>
+
+namespace Ancora {
+
+  struct Entity
+  {
+    uint32_t Index = 0xffffffff;
+    // Tells a destroyed entity from the one that reuses its index
+    uint32_t Generation = 0;
+
+    bool operator==(const Entity& other) const { return Index == other.Index && Generation == other.Generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+  };
+
+  // Runtime description of a component type, so archetypes can move and destroy them untyped
+  struct ComponentInfo
+  {
+    uint32_t Size;
+    uint32_t Alignment;
+    void (*MoveConstruct)(void* destination, void* source);
+    void (*Destroy)(void* component);
+  };
+
+  class ComponentRegistry
+  {
+  public:
+    static constexpr uint32_t MaxComponents = 64;
+
+    // IDs are handed out on first use of each type, from any thread
+    template<typename T>
+    static uint32_t GetID()
+    {
+      static const uint32_t id = Register({ (uint32_t)sizeof(T), (uint32_t)alignof(T),
+        [](void* destination, void* source) { new (destination) T(std::move(*(T*)source)); },
+        [](void* component) { ((T*)component)->~T(); } });
+      return id;
+    }
+
+    static const ComponentInfo& GetInfo(uint32_t id);
+  private:
+    static uint32_t Register(const ComponentInfo& info);
+  };
+
+  // All entities with one exact set of components. They are stored in fixed-size chunks, each
+  // holding an array of entities followed by one array per component (SoA), so a query walks
+  // plain arrays. Every chunk but the last is full.
+  class Archetype
+  {
+  public:
+    static constexpr uint32_t ChunkSize = 16 * 1024;
+    static constexpr uint8_t NoComponent = 0xff;
+
+    struct Chunk
+    {
+      std::unique_ptr<uint8_t[]> Data;
+      uint32_t Count = 0;
+    };
+
+    Archetype(uint64_t mask);
+    ~Archetype();
+
+    uint64_t GetMask() const { return m_Mask; }
+    uint32_t GetCapacity() const { return m_Capacity; }
+    uint32_t GetEntityCount() const;
+    std::vector<Chunk>& GetChunks() { return m_Chunks; }
+
+    Entity* GetEntities(const Chunk& chunk) const { return (Entity*)chunk.Data.get(); }
+    void* GetComponents(const Chunk& chunk, uint32_t component) const { return chunk.Data.get() + m_Offsets[m_ComponentIndices[component]]; }
+    template<typename T>
+    T* GetComponents(const Chunk& chunk) const { return (T*)GetComponents(chunk, ComponentRegistry::GetID<T>()); }
+    // Address of one component of the entity at row of chunk
+    void* GetComponent(uint32_t chunk, uint32_t row, uint32_t component) const;
+
+    // Appends an entity with uninitialized components and returns its chunk and row
+    std::pair<uint32_t, uint32_t> AddRow(Entity entity);
+    // Fills the row with the last entity, whose new place is returned. The components of the row
+    // have to be destroyed or moved out already.
+    Entity RemoveRow(uint32_t chunk, uint32_t row);
+
+    const std::vector<uint32_t>& GetComponentIDs() const { return m_Components; }
+  private:
+    uint64_t m_Mask;
+    std::vector<uint32_t> m_Components;
+    // Start of each component's array within a chunk
+    std::vector<uint32_t> m_Offsets;
+    // Position in m_Components by component ID, NoComponent if absent
+    std::array<uint8_t, ComponentRegistry::MaxComponents> m_ComponentIndices;
+    uint32_t m_Capacity;
+    std::vector<Chunk> m_Chunks;
+  };
+
+  // Entities and their components, grouped into archetypes. Adding or removing a component moves
+  // the entity to another archetype; queries visit the archetypes that have all requested
+  // components, chunk by chunk.
+  class World
+  {
+  public:
+    World() = default;
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    Entity CreateEntity();
+    void DestroyEntity(Entity entity);
+    bool IsAlive(Entity entity) const;
+    uint32_t GetEntityCount() const { return m_EntityCount; }
+
+    template<typename T, typename... Args>
+    T& AddComponent(Entity entity, Args&&... args)
+    {
+      static_assert(alignof(T) <= 16, "Components are stored with 16 byte alignment");
+      uint32_t id = ComponentRegistry::GetID<T>();
+      AE_CORE_ASSERT(!HasComponent(entity, id), "Entity already has the component!");
+      return *new (AddComponent(entity, id)) T(std::forward<Args>(args)...);
+    }
+
+    template<typename T>
+    void RemoveComponent(Entity entity) { RemoveComponent(entity, ComponentRegistry::GetID<T>()); }
+
+    template<typename T>
+    T& GetComponent(Entity entity) { return *(T*)GetComponent(entity, ComponentRegistry::GetID<T>()); }
+
+    template<typename T>
+    bool HasComponent(Entity entity) const { return HasComponent(entity, ComponentRegistry::GetID<T>()); }
+
+    // Calls function(count, Ts*...) for every chunk with all of Ts, with the component arrays of the chunk
+    template<typename... Ts, typename Function>
+    void EachChunk(Function&& function)
+    {
+      uint64_t mask = GetMask<Ts...>();
+      for (auto& [archetypeMask, archetype] : m_Archetypes)
+      {
+        if ((archetypeMask & mask) != mask)
+          continue;
+
+        for (auto& chunk : archetype->GetChunks())
+          function(chunk.Count, archetype->template GetComponents<Ts>(chunk)...);
+      }
+    }
+
+    // Calls function(Ts&...) for every entity with all of Ts
+    template<typename... Ts, typename Function>
+    void Each(Function&& function)
+    {
+      EachChunk<Ts...>([&function](uint32_t count, Ts*... components)
+      {
+        for (uint32_t i = 0; i < count; i++)
+          function(components[i]...);
+      });
+    }
+
+    // Number of chunks EachChunk() visits
+    template<typename... Ts>
+    uint32_t GetChunkCount() const
+    {
+      uint64_t mask = GetMask<Ts...>();
+      uint32_t count = 0;
+      for (const auto& [archetypeMask, archetype] : m_Archetypes)
+      {
+        if ((archetypeMask & mask) == mask)
+          count += (uint32_t)archetype->GetChunks().size();
+      }
+      return count;
+    }
+
+    // EachChunk() spread over the JobSystem, calling function(chunkIndex, count, Ts*...), with
+    // chunks numbered in the order EachChunk() visits them. Components must not be added or
+    // removed meanwhile, and function must only touch the components it is given.
+    template<typename... Ts, typename Function>
+    void ParallelEachChunk(Function&& function)
+    {
+      uint64_t mask = GetMask<Ts...>();
+      std::vector<std::pair<Archetype*, Archetype::Chunk*>> chunks;
+      for (auto& [archetypeMask, archetype] : m_Archetypes)
+      {
+        if ((archetypeMask & mask) != mask)
+          continue;
+
+        for (auto& chunk : archetype->GetChunks())
+          chunks.push_back({ archetype.get(), &chunk });
+      }
+
+      JobSystem::ParallelFor((uint32_t)chunks.size(), [&chunks, &function](uint32_t i)
+      {
+        const Archetype::Chunk& chunk = *chunks[i].second;
+        function(i, chunk.Count, chunks[i].first->template GetComponents<Ts>(chunk)...);
+      });
+    }
+
+    // Each() with the chunks spread over the JobSystem, under the rules of ParallelEachChunk()
+    template<typename... Ts, typename Function>
+    void ParallelEach(Function&& function)
+    {
+      ParallelEachChunk<Ts...>([&function](uint32_t, uint32_t count, Ts*... components)
+      {
+        for (uint32_t i = 0; i < count; i++)
+          function(components[i]...);
+      });
+    }
+  private:
+    struct EntityRecord
+    {
+      Archetype* Location = nullptr;
+      uint32_t Chunk = 0;
+      uint32_t Row = 0;
+      uint32_t Generation = 0;
+    };
+
+    template<typename... Ts>
+    static uint64_t GetMask() { return (0ull | ... | (1ull << ComponentRegistry::GetID<Ts>())); }
+
+    // Returns the storage of the new component, which the caller constructs
+    void* AddComponent(Entity entity, uint32_t component);
+    void RemoveComponent(Entity entity, uint32_t component);
+    void* GetComponent(Entity entity, uint32_t component);
+    bool HasComponent(Entity entity, uint32_t component) const;
+
+    Archetype* GetArchetype(uint64_t mask);
+    // Moves the components both archetypes have, destroys the rest
+    void MoveEntity(Entity entity, Archetype* target);
+    const EntityRecord& GetRecord(Entity entity) const;
+  private:
+    std::vector<EntityRecord> m_Entities;
+    std::vector<uint32_t> m_FreeEntities;
+    uint32_t m_EntityCount = 0;
+    std::unordered_map<uint64_t, Scope<Archetype>> m_Archetypes;
+  };
+
+}
@@ -1,7 +1,7 @@
 #include "aepch.h"
 #include "OpenGLBuffer.h"
 
-#include <glad/glad.h>
+#include "OpenGLStateCache.h"
 
 namespace Ancora {
 
@@ -9,59 +9,70 @@ namespace Ancora {
   OpenGLVertexBuffer::OpenGLVertexBuffer(uint32_t size)
   {
     glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW);
   }
 
   OpenGLVertexBuffer::OpenGLVertexBuffer(float* vertices, uint32_t size)
   {
     glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+    glNamedBufferData(m_RendererID, size, vertices, GL_STATIC_DRAW);
+  }
+
+  OpenGLVertexBuffer::OpenGLVertexBuffer(const Ref<StreamingBuffer>& buffer)
+    : m_RendererID(buffer->GetRendererID()), m_StreamingBuffer(buffer)
+  {
   }
 
   OpenGLVertexBuffer::~OpenGLVertexBuffer()
   {
-    glDeleteBuffers(1, &m_RendererID);
+    if (!m_StreamingBuffer)
+      OpenGLStateCache::DeleteBuffer(m_RendererID);
   }
 
   void OpenGLVertexBuffer::Bind() const
   {
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+    OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
   }
 
   void OpenGLVertexBuffer::Unbind() const
   {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0);
   }
 
   void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
   {
-    glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+    AE_CORE_ASSERT(!m_StreamingBuffer, "Streaming vertex buffers are written through StreamingBuffer::Allocate!");
+    glNamedBufferSubData(m_RendererID, 0, size, data);
   }
 
   // -------------------------- IndexBuffer ---------------------------
-  OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t count)
+  OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t count, IndexType type)
+    : m_Count(count), m_IndexType(type)
   {
     glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+    glNamedBufferData(m_RendererID, count * IndexTypeSize(type), nullptr, GL_DYNAMIC_DRAW);
   }
 
   OpenGLIndexBuffer::OpenGLIndexBuffer(uint32_t* indices, uint32_t count)
-   : m_Count(count)
+    : m_Count(count), m_IndexType(IndexType::UInt32)
   {
     glCreateBuffers(1, &m_RendererID);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+    glNamedBufferData(m_RendererID, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
+  }
+
+  OpenGLIndexBuffer::OpenGLIndexBuffer(uint16_t* indices, uint32_t count)
+    : m_Count(count), m_IndexType(IndexType::UInt16)
+  {
+    glCreateBuffers(1, &m_RendererID);
+    glNamedBufferData(m_RendererID, count * sizeof(uint16_t), indices, GL_STATIC_DRAW);
   }
 
   OpenGLIndexBuffer::~OpenGLIndexBuffer()
   {
-    glDeleteBuffers(1, &m_RendererID);
+    OpenGLStateCache::DeleteBuffer(m_RendererID);
   }
 
+  // The element buffer binding belongs to the bound vertex array, so it is not cached
   void OpenGLIndexBuffer::Bind() const
   {
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
@@ -69,13 +80,12 @@ namespace Ancora {
 
   void OpenGLIndexBuffer::Unbind() const
   {
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
   }
 
   void OpenGLIndexBuffer::SetData(const void* data, uint32_t count)
   {
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
-    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, count * sizeof(uint32_t), data);
+    glNamedBufferSubData(m_RendererID, 0, count * IndexTypeSize(m_IndexType), data);
   }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Ancora/Renderer/Buffer.h"
+#include "Ancora/Renderer/StreamingBuffer.h"
 
 namespace Ancora {
 
@@ -9,6 +10,7 @@ namespace Ancora {
   public:
     OpenGLVertexBuffer(uint32_t size);
     OpenGLVertexBuffer(float* vertices, uint32_t size);
+    OpenGLVertexBuffer(const Ref<StreamingBuffer>& buffer);
     virtual ~OpenGLVertexBuffer();
 
     virtual void Bind() const override;
@@ -21,24 +23,29 @@ namespace Ancora {
   private:
     uint32_t m_RendererID;
     BufferLayout m_Layout;
+    // Owns the storage when set
+    Ref<StreamingBuffer> m_StreamingBuffer;
   };
 
   class OpenGLIndexBuffer : public IndexBuffer
   {
   public:
-    OpenGLIndexBuffer(uint32_t count);
+    OpenGLIndexBuffer(uint32_t count, IndexType type);
     OpenGLIndexBuffer(uint32_t* indices, uint32_t count);
+    OpenGLIndexBuffer(uint16_t* indices, uint32_t count);
     virtual ~OpenGLIndexBuffer();
 
     virtual void Bind() const override;
     virtual void Unbind() const override;
 
-    virtual uint32_t GetCount() const { return m_Count; }
+    virtual uint32_t GetCount() const override { return m_Count; }
+    virtual IndexType GetIndexType() const override { return m_IndexType; }
 
-    virtual void SetData(const void* data, uint32_t size) override;
+    virtual void SetData(const void* data, uint32_t count) override;
   private:
     uint32_t m_RendererID;
     uint32_t m_Count;
+    IndexType m_IndexType;
   };
 
 }
@@ -0,0 +1,177 @@
+#include "aepch.h"
+#include "OpenGLFramebuffer.h"
+
+#include "OpenGLStateCache.h"
+
+namespace Ancora {
+
+  static const uint32_t s_MaxFramebufferSize = 8192;
+
+  static bool IsDepthFormat(FramebufferTextureFormat format)
+  {
+    switch (format)
+    {
+      case FramebufferTextureFormat::DEPTH24STENCIL8:
+      case FramebufferTextureFormat::DEPTH32F:
+        return true;
+    }
+
+    return false;
+  }
+
+  static GLenum FramebufferTextureFormatToOpenGLFormat(FramebufferTextureFormat format)
+  {
+    switch (format)
+    {
+      case FramebufferTextureFormat::RGBA8:           return GL_RGBA8;
+      case FramebufferTextureFormat::RGBA16F:         return GL_RGBA16F;
+      case FramebufferTextureFormat::DEPTH24STENCIL8: return GL_DEPTH24_STENCIL8;
+      case FramebufferTextureFormat::DEPTH32F:        return GL_DEPTH_COMPONENT32F;
+    }
+
+    AE_CORE_ASSERT(false, "Unknown FramebufferTextureFormat!");
+    return 0;
+  }
+
+  static uint32_t CreateAttachment(FramebufferTextureFormat format, const FramebufferSpecification& spec)
+  {
+    uint32_t id;
+    GLenum internalFormat = FramebufferTextureFormatToOpenGLFormat(format);
+
+    if (spec.Samples > 1)
+    {
+      glCreateTextures(GL_TEXTURE_2D_MULTISAMPLE, 1, &id);
+      glTextureStorage2DMultisample(id, spec.Samples, internalFormat, spec.Width, spec.Height, GL_FALSE);
+    }
+    else
+    {
+      glCreateTextures(GL_TEXTURE_2D, 1, &id);
+      glTextureStorage2D(id, 1, internalFormat, spec.Width, spec.Height);
+
+      glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, IsDepthFormat(format) ? GL_NEAREST : GL_LINEAR);
+      glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, IsDepthFormat(format) ? GL_NEAREST : GL_LINEAR);
+      glTextureParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTextureParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    return id;
+  }
+
+  OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferSpecification& spec)
+    : m_Specification(spec)
+  {
+    for (auto attachment : m_Specification.Attachments.Attachments)
+    {
+      if (IsDepthFormat(attachment.TextureFormat))
+        m_DepthAttachmentSpecification = attachment;
+      else
+        m_ColorAttachmentSpecifications.push_back(attachment);
+    }
+
+    Invalidate();
+  }
+
+  OpenGLFramebuffer::~OpenGLFramebuffer()
+  {
+    Release();
+  }
+
+  void OpenGLFramebuffer::Release()
+  {
+    if (!m_RendererID)
+      return;
+
+    OpenGLStateCache::DeleteFramebuffer(m_RendererID);
+    OpenGLStateCache::DeleteTextures((uint32_t)m_ColorAttachments.size(), m_ColorAttachments.data());
+    OpenGLStateCache::DeleteTextures(1, &m_DepthAttachment);
+
+    m_RendererID = 0;
+    m_ColorAttachments.clear();
+    m_DepthAttachment = 0;
+  }
+
+  void OpenGLFramebuffer::Invalidate()
+  {
+    Release();
+
+    glCreateFramebuffers(1, &m_RendererID);
+
+    std::vector<GLenum> drawBuffers;
+    for (uint32_t i = 0; i < m_ColorAttachmentSpecifications.size(); i++)
+    {
+      uint32_t id = CreateAttachment(m_ColorAttachmentSpecifications[i].TextureFormat, m_Specification);
+      glNamedFramebufferTexture(m_RendererID, GL_COLOR_ATTACHMENT0 + i, id, 0);
+      m_ColorAttachments.push_back(id);
+      drawBuffers.push_back(GL_COLOR_ATTACHMENT0 + i);
+    }
+
+    if (drawBuffers.empty())
+      glNamedFramebufferDrawBuffer(m_RendererID, GL_NONE);
+    else
+      glNamedFramebufferDrawBuffers(m_RendererID, (GLsizei)drawBuffers.size(), drawBuffers.data());
+
+    if (m_DepthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None)
+    {
+      m_DepthAttachment = CreateAttachment(m_DepthAttachmentSpecification.TextureFormat, m_Specification);
+      GLenum attachmentType = m_DepthAttachmentSpecification.TextureFormat == FramebufferTextureFormat::DEPTH24STENCIL8 ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+      glNamedFramebufferTexture(m_RendererID, attachmentType, m_DepthAttachment, 0);
+    }
+
+    AE_CORE_ASSERT(glCheckNamedFramebufferStatus(m_RendererID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
+  }
+
+  void OpenGLFramebuffer::Bind()
+  {
+    OpenGLStateCache::BindFramebuffer(m_RendererID);
+    OpenGLStateCache::Viewport(0, 0, m_Specification.Width, m_Specification.Height);
+  }
+
+  void OpenGLFramebuffer::Unbind()
+  {
+    OpenGLStateCache::BindFramebuffer(0);
+  }
+
+  void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
+  {
+    if (width == 0 || height == 0 || width > s_MaxFramebufferSize || height > s_MaxFramebufferSize)
+    {
+      AE_CORE_WARN("Attempted to resize framebuffer to {0}, {1}", width, height);
+      return;
+    }
+    if (width == m_Specification.Width && height == m_Specification.Height)
+      return;
+
+    m_Specification.Width = width;
+    m_Specification.Height = height;
+    Invalidate();
+  }
+
+  void OpenGLFramebuffer::Resolve(const Ref<Framebuffer>& target) const
+  {
+    const auto& targetSpec = target->GetSpecification();
+    AE_CORE_ASSERT(targetSpec.Width == m_Specification.Width && targetSpec.Height == m_Specification.Height, "Resolve target has a different size!");
+
+    GLbitfield mask = 0;
+    if (!m_ColorAttachments.empty())
+      mask |= GL_COLOR_BUFFER_BIT;
+    if (m_DepthAttachment && target->GetDepthAttachmentRendererID())
+      mask |= GL_DEPTH_BUFFER_BIT;
+
+    uint32_t targetID = std::static_pointer_cast<OpenGLFramebuffer>(target)->m_RendererID;
+    glBlitNamedFramebuffer(m_RendererID, targetID,
+      0, 0, m_Specification.Width, m_Specification.Height,
+      0, 0, targetSpec.Width, targetSpec.Height,
+      mask, GL_NEAREST);
+  }
+
+  void OpenGLFramebuffer::BlitToScreen(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const
+  {
+    AE_CORE_ASSERT(m_Specification.Samples == 1, "Resolve a multisampled framebuffer before scaling it!");
+
+    glBlitNamedFramebuffer(m_RendererID, 0,
+      0, 0, m_Specification.Width, m_Specification.Height,
+      x, y, x + width, y + height,
+      GL_COLOR_BUFFER_BIT, GL_LINEAR);
+  }
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Ancora/Renderer/Framebuffer.h"
+
+namespace Ancora {
+
+  class OpenGLFramebuffer : public Framebuffer
+  {
+  public:
+    OpenGLFramebuffer(const FramebufferSpecification& spec);
+    virtual ~OpenGLFramebuffer();
+
+    virtual void Bind() override;
+    virtual void Unbind() override;
+
+    virtual void Resize(uint32_t width, uint32_t height) override;
+
+    virtual void Resolve(const Ref<Framebuffer>& target) const override;
+    virtual void BlitToScreen(uint32_t x, uint32_t y, uint32_t width, uint32_t height) const override;
+
+    virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) const override { AE_CORE_ASSERT(index < m_ColorAttachments.size(), "Invalid color attachment!"); return m_ColorAttachments[index]; }
+    virtual uint32_t GetDepthAttachmentRendererID() const override { return m_DepthAttachment; }
+
+    virtual const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+  private:
+    void Invalidate();
+    void Release();
+  private:
+    uint32_t m_RendererID = 0;
+    FramebufferSpecification m_Specification;
+
+    std::vector<FramebufferTextureSpecification> m_ColorAttachmentSpecifications;
+    FramebufferTextureSpecification m_DepthAttachmentSpecification;
+
+    std::vector<uint32_t> m_ColorAttachments;
+    uint32_t m_DepthAttachment = 0;
+  };
+
+}
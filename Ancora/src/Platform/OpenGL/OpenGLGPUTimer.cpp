@@ -0,0 +1,64 @@
+#include "aepch.h"
+#include "OpenGLGPUTimer.h"
+
+namespace Ancora {
+
+  OpenGLGPUTimer::OpenGLGPUTimer()
+  {
+    glCreateQueries(GL_TIMESTAMP, QueryCount * 2, &m_Queries[0][0]);
+  }
+
+  OpenGLGPUTimer::~OpenGLGPUTimer()
+  {
+    glDeleteQueries(QueryCount * 2, &m_Queries[0][0]);
+  }
+
+  void OpenGLGPUTimer::Poll()
+  {
+    while (m_Pending[m_Oldest])
+    {
+      GLint available = 0;
+      glGetQueryObjectiv(m_Queries[m_Oldest][1], GL_QUERY_RESULT_AVAILABLE, &available);
+      if (!available)
+        return;
+
+      GLuint64 begin = 0, end = 0;
+      glGetQueryObjectui64v(m_Queries[m_Oldest][0], GL_QUERY_RESULT, &begin);
+      glGetQueryObjectui64v(m_Queries[m_Oldest][1], GL_QUERY_RESULT, &end);
+      m_Time = (float)(end - begin) / 1000000.0f;
+
+      m_Pending[m_Oldest] = false;
+      m_Oldest = (m_Oldest + 1) % QueryCount;
+    }
+  }
+
+  void OpenGLGPUTimer::Begin()
+  {
+    AE_CORE_ASSERT(!m_Measuring, "GPUTimer::Begin called twice!");
+
+    Poll();
+    if (m_Pending[m_Next])
+      return;
+
+    glQueryCounter(m_Queries[m_Next][0], GL_TIMESTAMP);
+    m_Measuring = true;
+  }
+
+  void OpenGLGPUTimer::End()
+  {
+    if (!m_Measuring)
+      return;
+
+    glQueryCounter(m_Queries[m_Next][1], GL_TIMESTAMP);
+    m_Pending[m_Next] = true;
+    m_Next = (m_Next + 1) % QueryCount;
+    m_Measuring = false;
+  }
+
+  float OpenGLGPUTimer::GetTime()
+  {
+    Poll();
+    return m_Time;
+  }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Ancora/Renderer/GPUTimer.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  // Timestamp query pairs rather than GL_TIME_ELAPSED, which cannot be nested
+  class OpenGLGPUTimer : public GPUTimer
+  {
+  public:
+    OpenGLGPUTimer();
+    virtual ~OpenGLGPUTimer();
+
+    virtual void Begin() override;
+    virtual void End() override;
+
+    virtual float GetTime() override;
+  private:
+    // Reads back the finished measurements, oldest first
+    void Poll();
+  private:
+    static constexpr uint32_t QueryCount = 4;
+
+    // Begin and end timestamp of each measurement
+    GLuint m_Queries[QueryCount][2];
+    bool m_Pending[QueryCount] = {};
+    // Next measurement to start and oldest one that has not been read back
+    uint32_t m_Next = 0;
+    uint32_t m_Oldest = 0;
+    bool m_Measuring = false;
+    float m_Time = 0.0f;
+  };
+
+}
@@ -0,0 +1,123 @@
+#include "aepch.h"
+#include "OpenGLHiZBuffer.h"
+#include "OpenGLStateCache.h"
+
+namespace Ancora {
+
+  // Coarsest level that is at most this wide is copied back for the CPU tests
+  static const uint32_t s_MaxReadbackWidth = 256;
+
+  OpenGLHiZBuffer::OpenGLHiZBuffer()
+  {
+    m_ReduceShader = Shader::Create("Sandbox/assets/shaders/HiZ.glsl");
+    glCreateBuffers(1, &m_ReadbackBuffer);
+  }
+
+  OpenGLHiZBuffer::~OpenGLHiZBuffer()
+  {
+    if (m_ReadbackFence)
+      glDeleteSync(m_ReadbackFence);
+    OpenGLStateCache::DeleteBuffer(m_ReadbackBuffer);
+    OpenGLStateCache::DeleteTextures(1, &m_PyramidTexture);
+  }
+
+  void OpenGLHiZBuffer::Invalidate(uint32_t width, uint32_t height)
+  {
+    if (m_PyramidTexture)
+      OpenGLStateCache::DeleteTextures(1, &m_PyramidTexture);
+
+    m_Width = width;
+    m_Height = height;
+    m_MipCount = 1;
+    while ((std::max(width, height) >> m_MipCount) > 0)
+      m_MipCount++;
+
+    glCreateTextures(GL_TEXTURE_2D, 1, &m_PyramidTexture);
+    glTextureStorage2D(m_PyramidTexture, m_MipCount, GL_R32F, width, height);
+    glTextureParameteri(m_PyramidTexture, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+    glTextureParameteri(m_PyramidTexture, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTextureParameteri(m_PyramidTexture, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_PyramidTexture, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  }
+
+  void OpenGLHiZBuffer::Build(const Ref<Framebuffer>& depthSource, const glm::mat4& viewProjection)
+  {
+    const auto& spec = depthSource->GetSpecification();
+    AE_CORE_ASSERT(spec.Samples == 1, "Resolve a multisampled framebuffer before building the Hi-Z pyramid!");
+    AE_CORE_ASSERT(depthSource->GetDepthAttachmentRendererID(), "Framebuffer has no depth attachment!");
+    if (spec.Width != m_Width || spec.Height != m_Height)
+      Invalidate(spec.Width, spec.Height);
+
+    m_ViewProjection = viewProjection;
+
+    // Level 0 is a plain copy of the depth, every level after that reduces the one before
+    m_ReduceShader->Bind();
+    for (uint32_t level = 0; level < m_MipCount; level++)
+    {
+      uint32_t width = std::max(m_Width >> level, 1u);
+      uint32_t height = std::max(m_Height >> level, 1u);
+
+      OpenGLStateCache::BindTextureUnit(0, level == 0 ? depthSource->GetDepthAttachmentRendererID() : m_PyramidTexture);
+      m_ReduceShader->SetInt("u_SourceLevel", level == 0 ? 0 : level - 1);
+      m_ReduceShader->SetInt("u_Reduce", level == 0 ? 0 : 1);
+      glBindImageTexture(0, m_PyramidTexture, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+
+      glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1);
+      glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_PIXEL_BUFFER_BARRIER_BIT);
+    }
+  }
+
+  void OpenGLHiZBuffer::Bind(uint32_t slot) const
+  {
+    OpenGLStateCache::BindTextureUnit(slot, m_PyramidTexture);
+  }
+
+  void OpenGLHiZBuffer::RequestReadback()
+  {
+    if (m_ReadbackFence || m_MipCount == 0)
+      return;
+
+    uint32_t level = 0;
+    while (level + 1 < m_MipCount && (m_Width >> level) > s_MaxReadbackWidth)
+      level++;
+
+    m_PendingReadback.Width = std::max(m_Width >> level, 1u);
+    m_PendingReadback.Height = std::max(m_Height >> level, 1u);
+    m_PendingReadback.ViewProjection = m_ViewProjection;
+
+    uint32_t size = m_PendingReadback.Width * m_PendingReadback.Height * sizeof(float);
+    if (size > m_ReadbackBufferSize)
+    {
+      glNamedBufferData(m_ReadbackBuffer, size, nullptr, GL_STREAM_READ);
+      m_ReadbackBufferSize = size;
+    }
+
+    OpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, m_ReadbackBuffer);
+    glGetTextureImage(m_PyramidTexture, level, GL_RED, GL_FLOAT, size, nullptr);
+    OpenGLStateCache::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    m_ReadbackFence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  const HiZReadback* OpenGLHiZBuffer::GetReadback()
+  {
+    if (m_ReadbackFence)
+    {
+      GLenum status = glClientWaitSync(m_ReadbackFence, 0, 0);
+      if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+      {
+        glDeleteSync(m_ReadbackFence);
+        m_ReadbackFence = nullptr;
+
+        m_Readback.Width = m_PendingReadback.Width;
+        m_Readback.Height = m_PendingReadback.Height;
+        m_Readback.ViewProjection = m_PendingReadback.ViewProjection;
+        m_Readback.Depth.resize(m_Readback.Width * m_Readback.Height);
+        glGetNamedBufferSubData(m_ReadbackBuffer, 0, m_Readback.Depth.size() * sizeof(float), m_Readback.Depth.data());
+      }
+    }
+
+    return m_Readback.Depth.empty() ? nullptr : &m_Readback;
+  }
+
+}
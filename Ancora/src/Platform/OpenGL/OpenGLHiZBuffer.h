@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Ancora/Renderer/HiZBuffer.h"
+#include "Ancora/Renderer/Shader.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  class OpenGLHiZBuffer : public HiZBuffer
+  {
+  public:
+    OpenGLHiZBuffer();
+    virtual ~OpenGLHiZBuffer();
+
+    virtual void Build(const Ref<Framebuffer>& depthSource, const glm::mat4& viewProjection) override;
+    virtual void Bind(uint32_t slot = 0) const override;
+
+    virtual uint32_t GetWidth() const override { return m_Width; }
+    virtual uint32_t GetHeight() const override { return m_Height; }
+    virtual uint32_t GetMipCount() const override { return m_MipCount; }
+    virtual const glm::mat4& GetViewProjection() const override { return m_ViewProjection; }
+
+    virtual void RequestReadback() override;
+    virtual const HiZReadback* GetReadback() override;
+  private:
+    void Invalidate(uint32_t width, uint32_t height);
+  private:
+    uint32_t m_Width = 0, m_Height = 0, m_MipCount = 0;
+    uint32_t m_PyramidTexture = 0;
+    glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+    Ref<Shader> m_ReduceShader;
+
+    uint32_t m_ReadbackBuffer = 0;
+    uint32_t m_ReadbackBufferSize = 0;
+    GLsync m_ReadbackFence = nullptr;
+    HiZReadback m_PendingReadback;
+    HiZReadback m_Readback;
+  };
+
+}
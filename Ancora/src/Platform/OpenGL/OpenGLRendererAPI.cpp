@@ -1,21 +1,56 @@
 #include "aepch.h"
 #include "OpenGLRendererAPI.h"
 
+#include "OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Ancora {
 
+  static GLenum IndexTypeToOpenGLType(IndexType type)
+  {
+    switch (type)
+    {
+      case IndexType::UInt16: return GL_UNSIGNED_SHORT;
+      case IndexType::UInt32: return GL_UNSIGNED_INT;
+    }
+
+    AE_CORE_ASSERT(false, "Unknown IndexType!");
+    return 0;
+  }
+
+  static GLenum DepthFunctionToOpenGLFunction(DepthFunction function)
+  {
+    switch (function)
+    {
+      case DepthFunction::Less:      return GL_LESS;
+      case DepthFunction::LessEqual: return GL_LEQUAL;
+      case DepthFunction::Equal:     return GL_EQUAL;
+    }
+
+    AE_CORE_ASSERT(false, "Unknown DepthFunction!");
+    return 0;
+  }
+
   void OpenGLRendererAPI::Init()
   {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    OpenGLStateCache::SetCapability(GL_BLEND, true);
+    OpenGLStateCache::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glEnable(GL_DEPTH_TEST);
+    OpenGLStateCache::SetCapability(GL_DEPTH_TEST, true);
+
+    // Filters across the edges of cube map faces, which shows at the small mips of a sky box
+    OpenGLStateCache::SetCapability(GL_TEXTURE_CUBE_MAP_SEAMLESS, true);
+
+    m_Capabilities.Compute = GLAD_GL_VERSION_4_3;
+    std::string renderer = (const char*)glGetString(GL_RENDERER);
+    for (const char* name : { "llvmpipe", "softpipe", "SwiftShader", "Software Rasterizer" })
+      m_Capabilities.SoftwareRenderer |= renderer.find(name) != std::string::npos;
   }
 
   void OpenGLRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
   {
-    glViewport(x, y, width, height);
+    OpenGLStateCache::Viewport(x, y, width, height);
   }
 
   void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
@@ -28,10 +63,92 @@ namespace Ancora {
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
   }
 
-  void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+  void OpenGLRendererAPI::SetDepthFunction(DepthFunction function)
+  {
+    OpenGLStateCache::DepthFunc(DepthFunctionToOpenGLFunction(function));
+  }
+
+  void OpenGLRendererAPI::SetDepthWrite(bool enabled)
+  {
+    OpenGLStateCache::DepthMask(enabled);
+  }
+
+  void OpenGLRendererAPI::SetColorWrite(bool enabled)
+  {
+    OpenGLStateCache::ColorMask(enabled);
+  }
+
+  void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t indexOffset, uint32_t baseVertex)
+  {
+    const auto& indexBuffer = vertexArray->GetIndexBuffer();
+    uint32_t count = indexCount ? indexCount : indexBuffer->GetCount();
+    const void* offset = (const void*)(uintptr_t)(indexOffset * IndexTypeSize(indexBuffer->GetIndexType()));
+    glDrawElementsBaseVertex(GL_TRIANGLES, count, IndexTypeToOpenGLType(indexBuffer->GetIndexType()), offset, baseVertex);
+  }
+
+  void OpenGLRendererAPI::DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commandBuffer, const Ref<StorageBuffer>& drawCountBuffer, uint32_t maxDrawCount, uint32_t commandOffset, uint32_t drawCountOffset)
+  {
+    GLenum type = IndexTypeToOpenGLType(vertexArray->GetIndexBuffer()->GetIndexType());
+    OpenGLStateCache::BindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer->GetRendererID());
+
+    if (GLAD_GL_VERSION_4_6)
+    {
+      OpenGLStateCache::BindBuffer(GL_PARAMETER_BUFFER, drawCountBuffer->GetRendererID());
+      glMultiDrawElementsIndirectCount(GL_TRIANGLES, type, (const void*)(uintptr_t)commandOffset, drawCountOffset, maxDrawCount, 0);
+    }
+    else
+    {
+      // Without indirect count every slot is submitted; unused ones must have a zero count
+      glMultiDrawElementsIndirect(GL_TRIANGLES, type, (const void*)(uintptr_t)commandOffset, maxDrawCount, 0);
+    }
+  }
+
+  void OpenGLRendererAPI::DispatchCompute(uint32_t groupsX, uint32_t groupsY, uint32_t groupsZ)
+  {
+    glDispatchCompute(groupsX, groupsY, groupsZ);
+  }
+
+  void OpenGLRendererAPI::Barrier(uint32_t bits)
+  {
+    GLbitfield barriers = 0;
+    if (bits & StorageBarrier)
+      barriers |= GL_SHADER_STORAGE_BARRIER_BIT;
+    if (bits & IndirectCommandBarrier)
+      barriers |= GL_COMMAND_BARRIER_BIT;
+    // Covers glBufferSubData, glGetBufferSubData and glClearBufferData
+    if (bits & BufferUpdateBarrier)
+      barriers |= GL_BUFFER_UPDATE_BARRIER_BIT;
+    if (bits & TextureFetchBarrier)
+      barriers |= GL_TEXTURE_FETCH_BARRIER_BIT;
+    if (bits & ImageAccessBarrier)
+      barriers |= GL_SHADER_IMAGE_ACCESS_BARRIER_BIT;
+    if (barriers)
+      glMemoryBarrier(barriers);
+  }
+
+  void OpenGLRendererAPI::SetStateValidation(bool enabled)
+  {
+    OpenGLStateCache::SetValidation(enabled);
+  }
+
+  bool OpenGLRendererAPI::GetStateValidation() const
+  {
+    return OpenGLStateCache::GetValidation();
+  }
+
+  void OpenGLRendererAPI::InvalidateState()
+  {
+    OpenGLStateCache::Invalidate();
+  }
+
+  void OpenGLRendererAPI::ResetStateStats()
+  {
+    OpenGLStateCache::ResetStats();
+  }
+
+  RendererAPI::StateStatistics OpenGLRendererAPI::GetStateStats() const
   {
-    uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
-    glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+    return OpenGLStateCache::GetStats();
   }
 
 }
@@ -8,12 +8,29 @@ namespace Ancora {
   {
   public:
     virtual void Init() override;
+    virtual const Capabilities& GetCapabilities() const override { return m_Capabilities; }
     virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
 
     virtual void SetClearColor(const glm::vec4& color) override;
     virtual void Clear() override;
 
-    virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
+    virtual void SetDepthFunction(DepthFunction function) override;
+    virtual void SetDepthWrite(bool enabled) override;
+    virtual void SetColorWrite(bool enabled) override;
+
+    virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t indexOffset = 0, uint32_t baseVertex = 0) override;
+    virtual void DrawIndexedIndirect(const Ref<VertexArray>& vertexArray, const Ref<StorageBuffer>& commandBuffer, const Ref<StorageBuffer>& drawCountBuffer, uint32_t maxDrawCount, uint32_t commandOffset = 0, uint32_t drawCountOffset = 0) override;
+
+    virtual void DispatchCompute(uint32_t groupsX, uint32_t groupsY = 1, uint32_t groupsZ = 1) override;
+    virtual void Barrier(uint32_t bits) override;
+
+    virtual void SetStateValidation(bool enabled) override;
+    virtual bool GetStateValidation() const override;
+    virtual void InvalidateState() override;
+    virtual void ResetStateStats() override;
+    virtual StateStatistics GetStateStats() const override;
+  private:
+    Capabilities m_Capabilities;
   };
 
 }
@@ -1,7 +1,13 @@
 #include "aepch.h"
 #include "OpenGLShader.h"
+#include "OpenGLStateCache.h"
+
+#include "Ancora/Core/FileWatcher.h"
 
 #include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <map>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -13,23 +19,68 @@ namespace Ancora {
       return GL_VERTEX_SHADER;
     if (type == "fragment" || type == "pixel")
       return GL_FRAGMENT_SHADER;
+    if (type == "compute")
+      return GL_COMPUTE_SHADER;
 
     AE_CORE_ASSERT(false, "Unknown shader type '{0}'", type);
     return 0;
   }
 
-  OpenGLShader::OpenGLShader(const std::string& filepath)
+  static const char* s_ProgramCacheDirectory = "Sandbox/assets/cache/shaders";
+  static const uint32_t s_ProgramCacheMagic = 0x41455342; // "AESB"
+  // Time spent compiling or loading programs since startup
+  static float s_TotalCompileTime = 0.0f;
+  // Programs loaded from the cache and programs compiled from source since startup
+  static uint32_t s_CachedPrograms = 0, s_CompiledPrograms = 0;
+
+  // FNV-1a
+  static uint64_t HashString(const std::string& string, uint64_t hash = 14695981039346656037ull)
   {
-    std::string source = ReadFile(filepath);
-    auto shaderSources = PreProcess(source);
-    Compile(shaderSources);
+    for (char c : string)
+    {
+      hash ^= (uint8_t)c;
+      hash *= 1099511628211ull;
+    }
+    return hash;
+  }
+
+  // Binaries are only valid for the driver that produced them. The sources are hashed after
+  // includes and defines are in, so every permutation is cached on its own.
+  static uint64_t GetProgramKey(const std::unordered_map<GLenum, std::string>& shaderSources)
+  {
+    std::map<GLenum, const std::string*> orderedSources;
+    for (auto& kv : shaderSources)
+      orderedSources[kv.first] = &kv.second;
+
+    uint64_t hash = HashString((const char*)glGetString(GL_VENDOR));
+    hash = HashString((const char*)glGetString(GL_RENDERER), hash);
+    hash = HashString((const char*)glGetString(GL_VERSION), hash);
+    for (auto& kv : orderedSources)
+      hash = HashString(std::to_string(kv.first) + *kv.second, hash);
+    return hash;
+  }
 
+  static std::string GetProgramCachePath(uint64_t key)
+  {
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", (unsigned long long)key);
+    return std::string(s_ProgramCacheDirectory) + "/" + name + ".bin";
+  }
+
+  OpenGLShader::OpenGLShader(const std::string& filepath, const std::vector<std::string>& defines)
+    : m_Filepath(filepath), m_Defines(defines)
+  {
     // Extract name from filepath
     auto lastSlash = filepath.find_last_of("/\\");
     lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
     auto lastDot = filepath.rfind('.');
     auto count = lastDot == std::string::npos ? filepath.size() - lastSlash : lastDot - lastSlash;
     m_Name = filepath.substr(lastSlash, count);
+
+    std::unordered_set<std::string> files;
+    m_RendererID = CompileFile(files);
+    AE_CORE_ASSERT(m_RendererID, "Shader '{0}' failed to compile!", m_Name);
+    WatchFiles(files);
   }
 
   OpenGLShader::OpenGLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc)
@@ -38,12 +89,64 @@ namespace Ancora {
     std::unordered_map<GLenum, std::string> sources;
     sources[GL_VERTEX_SHADER] = vertexSrc;
     sources[GL_FRAGMENT_SHADER] = fragmentSrc;
-    Compile(sources);
+    m_RendererID = Compile(sources);
+    AE_CORE_ASSERT(m_RendererID, "Shader '{0}' failed to compile!", m_Name);
   }
 
   OpenGLShader::~OpenGLShader()
   {
-    glDeleteProgram(m_RendererID);
+    for (uint32_t id : m_WatchIDs)
+      FileWatcher::Unwatch(id);
+    OpenGLStateCache::DeleteProgram(m_RendererID);
+  }
+
+  bool OpenGLShader::Reload()
+  {
+    if (m_Filepath.empty())
+      return false;
+
+    std::unordered_set<std::string> files;
+    uint32_t program = CompileFile(files);
+    // Includes may have been added or removed, and a broken file still has to be watched
+    WatchFiles(files);
+    if (!program)
+    {
+      AE_CORE_ERROR("Shader '{0}' failed to reload, keeping the previous version", m_Name);
+      return false;
+    }
+
+    OpenGLStateCache::DeleteProgram(m_RendererID);
+    m_RendererID = program;
+    AE_CORE_INFO("Reloaded shader '{0}'", m_Name);
+    return true;
+  }
+
+  uint32_t OpenGLShader::CompileFile(std::unordered_set<std::string>& files)
+  {
+    files.insert(m_Filepath);
+    std::string source = ReadFile(m_Filepath);
+    auto shaderSources = PreProcess(source);
+
+    auto lastSlash = m_Filepath.find_last_of("/\\");
+    std::string directory = lastSlash == std::string::npos ? "." : m_Filepath.substr(0, lastSlash);
+    for (auto& kv : shaderSources)
+    {
+      std::unordered_set<std::string> includedFiles;
+      kv.second = InsertDefines(ResolveIncludes(kv.second, directory, includedFiles), m_Defines);
+      files.insert(includedFiles.begin(), includedFiles.end());
+    }
+
+    return Compile(shaderSources);
+  }
+
+  void OpenGLShader::WatchFiles(const std::unordered_set<std::string>& files)
+  {
+    for (uint32_t id : m_WatchIDs)
+      FileWatcher::Unwatch(id);
+    m_WatchIDs.clear();
+
+    for (const auto& file : files)
+      m_WatchIDs.push_back(FileWatcher::Watch(file, [this]() { Reload(); }));
   }
 
   std::string OpenGLShader::ReadFile(const std::string& filepath)
@@ -89,12 +192,70 @@ namespace Ancora {
     return shaderSources;
   }
 
-  void OpenGLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
+  std::string OpenGLShader::ResolveIncludes(const std::string& source, const std::string& directory, std::unordered_set<std::string>& includedFiles)
   {
+    std::string result;
+    std::istringstream stream(source);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+      size_t begin = line.find_first_not_of(" \t");
+      if (begin == std::string::npos || line.compare(begin, 8, "#include") != 0)
+      {
+        result += line + '\n';
+        continue;
+      }
+
+      size_t open = line.find('"', begin);
+      size_t close = open == std::string::npos ? open : line.find('"', open + 1);
+      AE_CORE_ASSERT(close != std::string::npos, "Syntax error in #include!");
+
+      std::string path = directory + '/' + line.substr(open + 1, close - open - 1);
+      if (!includedFiles.insert(path).second)
+        continue;
+
+      auto lastSlash = path.find_last_of("/\\");
+      result += ResolveIncludes(ReadFile(path), path.substr(0, lastSlash), includedFiles);
+    }
+    return result;
+  }
+
+  std::string OpenGLShader::InsertDefines(const std::string& source, const std::vector<std::string>& defines)
+  {
+    if (defines.empty())
+      return source;
+
+    // Right after #version, which has to come first
+    size_t version = source.find("#version");
+    AE_CORE_ASSERT(version != std::string::npos, "Shader stage has no #version!");
+    size_t eol = source.find('\n', version);
+
+    std::string defineLines;
+    for (const auto& define : defines)
+      defineLines += "#define " + define + '\n';
+    return source.substr(0, eol + 1) + defineLines + source.substr(eol + 1);
+  }
+
+  uint32_t OpenGLShader::Compile(const std::unordered_map<GLenum, std::string>& shaderSources)
+  {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t key = GetProgramKey(shaderSources);
+    if (GLuint program = LoadProgramBinary(key))
+    {
+      float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+      s_TotalCompileTime += time;
+      s_CachedPrograms++;
+      AE_CORE_TRACE("Shader '{0}' loaded from cache in {1:.2f} ms ({2:.2f} ms total, {3} cached, {4} compiled)",
+        m_Name, time, s_TotalCompileTime, s_CachedPrograms, s_CompiledPrograms);
+      return program;
+    }
+
     GLuint program = glCreateProgram();
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     AE_CORE_ASSERT(shaderSources.size() <= 2, "Too many shaders to compile!");
-    std::array<GLenum, 2> glShaderIDs;
-    int glShaderIDIndex = 0;
+    AE_CORE_ASSERT(shaderSources.find(GL_COMPUTE_SHADER) == shaderSources.end() || shaderSources.size() == 1, "Compute shaders must be in a program of their own!");
+    std::vector<GLenum> glShaderIDs;
+    glShaderIDs.reserve(shaderSources.size());
     for (auto& kv : shaderSources)
     {
       GLenum shaderType = kv.first;
@@ -118,14 +279,17 @@ namespace Ancora {
       	glGetShaderInfoLog(shader, maxLength, &maxLength, &infoLog[0]);
 
       	glDeleteShader(shader);
+        for (auto id : glShaderIDs)
+          glDeleteShader(id);
+        glDeleteProgram(program);
 
         AE_CORE_ERROR("{0}", infoLog.data());
-        AE_CORE_ASSERT(false, "Shader compilation failure!");
-        break;
+        AE_CORE_ERROR("Shader '{0}' compilation failure!", m_Name);
+        return 0;
       }
 
       glAttachShader(program, shader);
-      glShaderIDs[glShaderIDIndex++] = shader;
+      glShaderIDs.push_back(shader);
     }
 
     glLinkProgram(program);
@@ -146,24 +310,102 @@ namespace Ancora {
         glDeleteShader(id);
 
       AE_CORE_ERROR("{0}", infoLog.data());
-      AE_CORE_ASSERT(false, "Shader link failure!");
-      return;
+      AE_CORE_ERROR("Shader '{0}' link failure!", m_Name);
+      return 0;
     }
 
     for (auto id : glShaderIDs)
+    {
       glDetachShader(program, id);
+      glDeleteShader(id);
+    }
 
-    m_RendererID = program;
+    SaveProgramBinary(program, key);
+
+    float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    s_TotalCompileTime += time;
+    s_CompiledPrograms++;
+    AE_CORE_TRACE("Shader '{0}' compiled in {1:.2f} ms ({2:.2f} ms total, {3} cached, {4} compiled)",
+      m_Name, time, s_TotalCompileTime, s_CachedPrograms, s_CompiledPrograms);
+    return program;
+  }
+
+  uint32_t OpenGLShader::LoadProgramBinary(uint64_t key)
+  {
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount == 0)
+      return 0;
+
+    std::ifstream in(GetProgramCachePath(key), std::ios::in | std::ios::binary);
+    if (!in)
+      return 0;
+
+    uint32_t magic = 0;
+    uint64_t fileKey = 0;
+    GLenum format = 0;
+    in.read((char*)&magic, sizeof(magic));
+    in.read((char*)&fileKey, sizeof(fileKey));
+    in.read((char*)&format, sizeof(format));
+    if (!in || magic != s_ProgramCacheMagic || fileKey != key)
+      return 0;
+
+    // The rest of the file is the binary; reading it this way never sets eofbit
+    std::vector<char> binary((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (binary.empty())
+      return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, format, binary.data(), (GLsizei)binary.size());
+
+    // Drivers reject binaries after updates or for reasons of their own; compile from source then
+    GLint isLinked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+    if (isLinked == GL_FALSE)
+    {
+      AE_CORE_WARN("Cached program of shader '{0}' was rejected by the driver", m_Name);
+      glDeleteProgram(program);
+      return 0;
+    }
+
+    return program;
+  }
+
+  void OpenGLShader::SaveProgramBinary(uint32_t program, uint64_t key) const
+  {
+    GLint formatCount = 0, length = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (formatCount == 0 || length == 0)
+      return;
+
+    GLenum format = 0;
+    std::vector<char> binary(length);
+    glGetProgramBinary(program, length, &length, &format, binary.data());
+
+    std::error_code error;
+    std::filesystem::create_directories(s_ProgramCacheDirectory, error);
+    std::ofstream out(GetProgramCachePath(key), std::ios::out | std::ios::binary | std::ios::trunc);
+    if (error || !out)
+    {
+      AE_CORE_WARN("Could not write the program cache of shader '{0}'", m_Name);
+      return;
+    }
+
+    out.write((const char*)&s_ProgramCacheMagic, sizeof(s_ProgramCacheMagic));
+    out.write((const char*)&key, sizeof(key));
+    out.write((const char*)&format, sizeof(format));
+    out.write(binary.data(), length);
   }
 
   void OpenGLShader::Bind() const
   {
-    glUseProgram(m_RendererID);
+    OpenGLStateCache::UseProgram(m_RendererID);
   }
 
   void OpenGLShader::Unbind() const
   {
-    glUseProgram(0);
+    OpenGLStateCache::UseProgram(0);
   }
 
   void OpenGLShader::SetInt(const std::string& name, int value)
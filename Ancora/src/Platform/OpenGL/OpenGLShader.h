@@ -10,7 +10,7 @@ namespace Ancora {
   class OpenGLShader : public Shader
   {
   public:
-    OpenGLShader(const std::string& filepath);
+    OpenGLShader(const std::string& filepath, const std::vector<std::string>& defines = {});
     OpenGLShader(const std::string& name, const std::string& vertexSrc, const std::string& fragmentSrc);
     virtual ~OpenGLShader();
 
@@ -29,6 +29,8 @@ namespace Ancora {
 
     virtual const std::string& GetName() const override { return m_Name; }
 
+    virtual bool Reload() override;
+
     void UploadUniformInt(const std::string& name, int value);
 
     void UploadUniformFloat(const std::string& name, float value);
@@ -41,10 +43,25 @@ namespace Ancora {
   private:
     std::string ReadFile(const std::string& filepath);
     std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
-    void Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+    // Replaces #include "file" lines with the file, relative to the including file. Each file is included once per stage.
+    std::string ResolveIncludes(const std::string& source, const std::string& directory, std::unordered_set<std::string>& includedFiles);
+    std::string InsertDefines(const std::string& source, const std::vector<std::string>& defines);
+    // Returns the program of the file, 0 if it does not compile. Adds every file it reads to files.
+    uint32_t CompileFile(std::unordered_set<std::string>& files);
+    // Returns the linked program, 0 on failure
+    uint32_t Compile(const std::unordered_map<GLenum, std::string>& shaderSources);
+    // Linked programs are cached on disk, keyed by the sources and the driver
+    uint32_t LoadProgramBinary(uint64_t key);
+    void SaveProgramBinary(uint32_t program, uint64_t key) const;
+    // Reloads the shader when any of the files changes
+    void WatchFiles(const std::unordered_set<std::string>& files);
   private:
     uint32_t m_RendererID;
     std::string m_Name;
+    // Empty for shaders created from source
+    std::string m_Filepath;
+    std::vector<std::string> m_Defines;
+    std::vector<uint32_t> m_WatchIDs;
   };
 
 }
@@ -0,0 +1,57 @@
+#include "aepch.h"
+#include "OpenGLShadowMap.h"
+
+#include "OpenGLStateCache.h"
+
+namespace Ancora {
+
+  OpenGLShadowMap::OpenGLShadowMap(uint32_t resolution, uint32_t layerCount)
+    : m_Resolution(resolution), m_LayerCount(layerCount)
+  {
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &m_RendererID);
+    glTextureStorage3D(m_RendererID, 1, GL_DEPTH_COMPONENT32F, resolution, resolution, layerCount);
+
+    // Linear filtering with comparison gives a free 2x2 PCF per tap
+    glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+
+    // Everything outside a cascade is lit
+    float borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+    glTextureParameterfv(m_RendererID, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+    glCreateFramebuffers(1, &m_FramebufferID);
+    glNamedFramebufferDrawBuffer(m_FramebufferID, GL_NONE);
+    glNamedFramebufferReadBuffer(m_FramebufferID, GL_NONE);
+  }
+
+  OpenGLShadowMap::~OpenGLShadowMap()
+  {
+    OpenGLStateCache::DeleteFramebuffer(m_FramebufferID);
+    OpenGLStateCache::DeleteTextures(1, &m_RendererID);
+  }
+
+  void OpenGLShadowMap::BeginLayer(uint32_t layer)
+  {
+    AE_CORE_ASSERT(layer < m_LayerCount, "Shadow map layer out of range!");
+
+    glNamedFramebufferTextureLayer(m_FramebufferID, GL_DEPTH_ATTACHMENT, m_RendererID, 0, layer);
+    OpenGLStateCache::BindFramebuffer(m_FramebufferID);
+    OpenGLStateCache::Viewport(0, 0, m_Resolution, m_Resolution);
+    glClear(GL_DEPTH_BUFFER_BIT);
+  }
+
+  void OpenGLShadowMap::EndLayer()
+  {
+    OpenGLStateCache::BindFramebuffer(0);
+  }
+
+  void OpenGLShadowMap::Bind(uint32_t slot) const
+  {
+    OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
+  }
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Ancora/Renderer/ShadowMap.h"
+
+namespace Ancora {
+
+  class OpenGLShadowMap : public ShadowMap
+  {
+  public:
+    OpenGLShadowMap(uint32_t resolution, uint32_t layerCount);
+    virtual ~OpenGLShadowMap();
+
+    virtual void BeginLayer(uint32_t layer) override;
+    virtual void EndLayer() override;
+
+    virtual void Bind(uint32_t slot = 0) const override;
+
+    virtual uint32_t GetResolution() const override { return m_Resolution; }
+    virtual uint32_t GetLayerCount() const override { return m_LayerCount; }
+  private:
+    uint32_t m_RendererID;
+    uint32_t m_FramebufferID;
+    uint32_t m_Resolution, m_LayerCount;
+  };
+
+}
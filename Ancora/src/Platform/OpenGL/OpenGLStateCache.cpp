@@ -0,0 +1,308 @@
+#include "aepch.h"
+#include "OpenGLStateCache.h"
+
+#include <map>
+#include <optional>
+
+namespace Ancora {
+
+  struct OpenGLStateCacheData
+  {
+    std::optional<uint32_t> Program;
+    std::optional<uint32_t> VertexArray;
+    std::optional<uint32_t> Framebuffer;
+    std::unordered_map<GLenum, std::optional<uint32_t>> Buffers;
+    std::map<std::pair<GLenum, uint32_t>, std::optional<uint32_t>> IndexedBuffers;
+    // By unit
+    std::vector<std::optional<uint32_t>> Textures;
+
+    std::unordered_map<GLenum, std::optional<bool>> Capabilities;
+    std::optional<std::pair<GLenum, GLenum>> BlendFunction;
+    std::optional<GLenum> DepthFunction;
+    std::optional<bool> DepthMask;
+    std::optional<bool> ColorMask;
+    std::optional<std::array<GLint, 4>> Viewport;
+
+    bool Validation = false;
+    RendererAPI::StateStatistics Stats;
+  };
+
+  static OpenGLStateCacheData s_Data;
+
+  static GLint GetInteger(GLenum name)
+  {
+    GLint value = 0;
+    glGetIntegerv(name, &value);
+    return value;
+  }
+
+  static GLenum GetBufferBinding(GLenum target)
+  {
+    switch (target)
+    {
+      case GL_ARRAY_BUFFER:          return GL_ARRAY_BUFFER_BINDING;
+      case GL_DRAW_INDIRECT_BUFFER:  return GL_DRAW_INDIRECT_BUFFER_BINDING;
+      case GL_PARAMETER_BUFFER:      return GL_PARAMETER_BUFFER_BINDING;
+      case GL_PIXEL_PACK_BUFFER:     return GL_PIXEL_PACK_BUFFER_BINDING;
+      case GL_PIXEL_UNPACK_BUFFER:   return GL_PIXEL_UNPACK_BUFFER_BINDING;
+      case GL_SHADER_STORAGE_BUFFER: return GL_SHADER_STORAGE_BUFFER_BINDING;
+      case GL_UNIFORM_BUFFER:        return GL_UNIFORM_BUFFER_BINDING;
+    }
+
+    AE_CORE_ASSERT(false, "Buffer target is not tracked!");
+    return 0;
+  }
+
+  static GLenum GetTextureBinding(GLenum target)
+  {
+    switch (target)
+    {
+      case GL_TEXTURE_2D:                   return GL_TEXTURE_BINDING_2D;
+      case GL_TEXTURE_2D_ARRAY:             return GL_TEXTURE_BINDING_2D_ARRAY;
+      case GL_TEXTURE_2D_MULTISAMPLE:       return GL_TEXTURE_BINDING_2D_MULTISAMPLE;
+      case GL_TEXTURE_3D:                   return GL_TEXTURE_BINDING_3D;
+      case GL_TEXTURE_CUBE_MAP:             return GL_TEXTURE_BINDING_CUBE_MAP;
+      case GL_TEXTURE_CUBE_MAP_ARRAY:       return GL_TEXTURE_BINDING_CUBE_MAP_ARRAY;
+    }
+
+    AE_CORE_ASSERT(false, "Unknown texture target!");
+    return 0;
+  }
+
+  // Returns whether the change has to be made. query reads the actual state for validation.
+  template<typename T, typename Query>
+  static bool Track(std::optional<T>& cached, const T& value, const char* name, Query query)
+  {
+    s_Data.Stats.StateChanges++;
+    if (cached && *cached == value)
+    {
+      if (!s_Data.Validation || query() == value)
+      {
+        s_Data.Stats.FilteredStateChanges++;
+        return false;
+      }
+      AE_CORE_ERROR("OpenGLStateCache: {0} was changed without going through the cache", name);
+    }
+
+    cached = value;
+    return true;
+  }
+
+  void OpenGLStateCache::UseProgram(uint32_t program)
+  {
+    if (Track(s_Data.Program, program, "program", []() { return (uint32_t)GetInteger(GL_CURRENT_PROGRAM); }))
+      glUseProgram(program);
+  }
+
+  void OpenGLStateCache::BindVertexArray(uint32_t vertexArray)
+  {
+    if (Track(s_Data.VertexArray, vertexArray, "vertex array", []() { return (uint32_t)GetInteger(GL_VERTEX_ARRAY_BINDING); }))
+      glBindVertexArray(vertexArray);
+  }
+
+  void OpenGLStateCache::BindBuffer(GLenum target, uint32_t buffer)
+  {
+    if (Track(s_Data.Buffers[target], buffer, "buffer binding", [target]() { return (uint32_t)GetInteger(GetBufferBinding(target)); }))
+      glBindBuffer(target, buffer);
+  }
+
+  void OpenGLStateCache::BindBufferBase(GLenum target, uint32_t index, uint32_t buffer)
+  {
+    auto query = [target, index]()
+    {
+      GLint value = 0;
+      glGetIntegeri_v(GetBufferBinding(target), index, &value);
+      return (uint32_t)value;
+    };
+
+    // Also sets the generic binding of the target
+    if (Track(s_Data.IndexedBuffers[{ target, index }], buffer, "indexed buffer binding", query))
+    {
+      glBindBufferBase(target, index, buffer);
+      s_Data.Buffers[target] = buffer;
+    }
+  }
+
+  void OpenGLStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+  {
+    if (unit >= s_Data.Textures.size())
+      s_Data.Textures.resize(unit + 1);
+
+    auto query = [unit, texture]()
+    {
+      // Unbinding clears every target of the unit, which cannot be read back in one query
+      if (texture == 0)
+        return texture;
+
+      GLint target = 0;
+      glGetTextureParameteriv(texture, GL_TEXTURE_TARGET, &target);
+      GLint activeTexture = GetInteger(GL_ACTIVE_TEXTURE);
+      glActiveTexture(GL_TEXTURE0 + unit);
+      uint32_t bound = (uint32_t)GetInteger(GetTextureBinding(target));
+      glActiveTexture(activeTexture);
+      return bound;
+    };
+
+    if (Track(s_Data.Textures[unit], texture, "texture binding", query))
+      glBindTextureUnit(unit, texture);
+  }
+
+  void OpenGLStateCache::BindFramebuffer(uint32_t framebuffer)
+  {
+    auto query = []()
+    {
+      // Only counts as bound if both are
+      uint32_t draw = (uint32_t)GetInteger(GL_DRAW_FRAMEBUFFER_BINDING);
+      return draw == (uint32_t)GetInteger(GL_READ_FRAMEBUFFER_BINDING) ? draw : 0xffffffff;
+    };
+
+    if (Track(s_Data.Framebuffer, framebuffer, "framebuffer", query))
+      glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+  }
+
+  void OpenGLStateCache::SetCapability(GLenum capability, bool enabled)
+  {
+    if (!Track(s_Data.Capabilities[capability], enabled, "capability", [capability]() { return glIsEnabled(capability) == GL_TRUE; }))
+      return;
+
+    if (enabled)
+      glEnable(capability);
+    else
+      glDisable(capability);
+  }
+
+  void OpenGLStateCache::BlendFunc(GLenum source, GLenum destination)
+  {
+    auto query = []() { return std::make_pair((GLenum)GetInteger(GL_BLEND_SRC_RGB), (GLenum)GetInteger(GL_BLEND_DST_RGB)); };
+    if (Track(s_Data.BlendFunction, std::make_pair(source, destination), "blend function", query))
+      glBlendFunc(source, destination);
+  }
+
+  void OpenGLStateCache::DepthFunc(GLenum function)
+  {
+    if (Track(s_Data.DepthFunction, function, "depth function", []() { return (GLenum)GetInteger(GL_DEPTH_FUNC); }))
+      glDepthFunc(function);
+  }
+
+  void OpenGLStateCache::DepthMask(bool enabled)
+  {
+    auto query = []()
+    {
+      GLboolean mask = GL_FALSE;
+      glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+      return mask == GL_TRUE;
+    };
+
+    if (Track(s_Data.DepthMask, enabled, "depth mask", query))
+      glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+  }
+
+  void OpenGLStateCache::ColorMask(bool enabled)
+  {
+    auto query = [enabled]()
+    {
+      GLboolean mask[4] = {};
+      glGetBooleanv(GL_COLOR_WRITEMASK, mask);
+      bool all = mask[0] && mask[1] && mask[2] && mask[3];
+      bool none = !mask[0] && !mask[1] && !mask[2] && !mask[3];
+      // A mix of both matches neither
+      return all || none ? all : !enabled;
+    };
+
+    GLboolean mask = enabled ? GL_TRUE : GL_FALSE;
+    if (Track(s_Data.ColorMask, enabled, "color mask", query))
+      glColorMask(mask, mask, mask, mask);
+  }
+
+  void OpenGLStateCache::Viewport(int x, int y, int width, int height)
+  {
+    auto query = []()
+    {
+      std::array<GLint, 4> viewport;
+      glGetIntegerv(GL_VIEWPORT, viewport.data());
+      return viewport;
+    };
+
+    if (Track(s_Data.Viewport, std::array<GLint, 4>{ x, y, width, height }, "viewport", query))
+      glViewport(x, y, width, height);
+  }
+
+  void OpenGLStateCache::DeleteProgram(uint32_t program)
+  {
+    if (s_Data.Program == program)
+      s_Data.Program.reset();
+    glDeleteProgram(program);
+  }
+
+  void OpenGLStateCache::DeleteVertexArray(uint32_t vertexArray)
+  {
+    if (s_Data.VertexArray == vertexArray)
+      s_Data.VertexArray.reset();
+    glDeleteVertexArrays(1, &vertexArray);
+  }
+
+  void OpenGLStateCache::DeleteBuffer(uint32_t buffer)
+  {
+    for (auto& [target, bound] : s_Data.Buffers)
+    {
+      if (bound == buffer)
+        bound.reset();
+    }
+    for (auto& [binding, bound] : s_Data.IndexedBuffers)
+    {
+      if (bound == buffer)
+        bound.reset();
+    }
+    glDeleteBuffers(1, &buffer);
+  }
+
+  void OpenGLStateCache::DeleteTextures(uint32_t count, const uint32_t* textures)
+  {
+    for (uint32_t i = 0; i < count; i++)
+    {
+      for (auto& bound : s_Data.Textures)
+      {
+        if (bound == textures[i])
+          bound.reset();
+      }
+    }
+    glDeleteTextures(count, textures);
+  }
+
+  void OpenGLStateCache::DeleteFramebuffer(uint32_t framebuffer)
+  {
+    if (s_Data.Framebuffer == framebuffer)
+      s_Data.Framebuffer.reset();
+    glDeleteFramebuffers(1, &framebuffer);
+  }
+
+  void OpenGLStateCache::Invalidate()
+  {
+    bool validation = s_Data.Validation;
+    RendererAPI::StateStatistics stats = s_Data.Stats;
+    s_Data = OpenGLStateCacheData();
+    s_Data.Validation = validation;
+    s_Data.Stats = stats;
+  }
+
+  void OpenGLStateCache::SetValidation(bool enabled)
+  {
+    s_Data.Validation = enabled;
+  }
+
+  bool OpenGLStateCache::GetValidation()
+  {
+    return s_Data.Validation;
+  }
+
+  void OpenGLStateCache::ResetStats()
+  {
+    s_Data.Stats = RendererAPI::StateStatistics();
+  }
+
+  RendererAPI::StateStatistics OpenGLStateCache::GetStats()
+  {
+    return s_Data.Stats;
+  }
+
+}
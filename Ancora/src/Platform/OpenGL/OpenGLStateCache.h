@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Ancora/Renderer/RendererAPI.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  // Mirror of the GL state the engine sets, so setting what is already set never reaches the
+  // driver. Engine code changes this state only through here; code that calls GL directly has to
+  // restore what it changes or call Invalidate(). State starts out unknown, so the first change
+  // always goes through.
+  class OpenGLStateCache
+  {
+  public:
+    static void UseProgram(uint32_t program);
+    static void BindVertexArray(uint32_t vertexArray);
+    // For targets with a single binding point. GL_ELEMENT_ARRAY_BUFFER is part of the vertex
+    // array and not tracked.
+    static void BindBuffer(GLenum target, uint32_t buffer);
+    static void BindBufferBase(GLenum target, uint32_t index, uint32_t buffer);
+    static void BindTextureUnit(uint32_t unit, uint32_t texture);
+    // Binds both the draw and the read framebuffer
+    static void BindFramebuffer(uint32_t framebuffer);
+
+    static void SetCapability(GLenum capability, bool enabled);
+    static void BlendFunc(GLenum source, GLenum destination);
+    static void DepthFunc(GLenum function);
+    static void DepthMask(bool enabled);
+    static void ColorMask(bool enabled);
+    static void Viewport(int x, int y, int width, int height);
+
+    // Deleting an object unbinds it, and its name can then be reused by a new object
+    static void DeleteProgram(uint32_t program);
+    static void DeleteVertexArray(uint32_t vertexArray);
+    static void DeleteBuffer(uint32_t buffer);
+    static void DeleteTextures(uint32_t count, const uint32_t* textures);
+    static void DeleteFramebuffer(uint32_t framebuffer);
+
+    // Forgets all state, so every next change goes through
+    static void Invalidate();
+
+    // Checks every filtered change against glGet*, logs an error and makes the change anyway
+    // when the cache was wrong. Stalls the pipeline, so only for debugging.
+    static void SetValidation(bool enabled);
+    static bool GetValidation();
+
+    static void ResetStats();
+    static RendererAPI::StateStatistics GetStats();
+  };
+
+}
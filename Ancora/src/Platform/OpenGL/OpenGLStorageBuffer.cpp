@@ -0,0 +1,67 @@
+#include "aepch.h"
+#include "OpenGLStorageBuffer.h"
+
+#include "OpenGLStateCache.h"
+
+namespace Ancora {
+
+  OpenGLStorageBuffer::OpenGLStorageBuffer(uint32_t size, const void* data)
+    : m_Size(size)
+  {
+    glCreateBuffers(1, &m_RendererID);
+    glNamedBufferData(m_RendererID, size, data, data ? GL_STATIC_DRAW : GL_DYNAMIC_DRAW);
+  }
+
+  OpenGLStorageBuffer::~OpenGLStorageBuffer()
+  {
+    if (m_Fence)
+      glDeleteSync(m_Fence);
+    OpenGLStateCache::DeleteBuffer(m_RendererID);
+  }
+
+  void OpenGLStorageBuffer::Bind(uint32_t binding) const
+  {
+    OpenGLStateCache::BindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, m_RendererID);
+  }
+
+  void OpenGLStorageBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+  {
+    AE_CORE_ASSERT(offset + size <= m_Size, "StorageBuffer write out of range!");
+    glNamedBufferSubData(m_RendererID, offset, size, data);
+  }
+
+  void OpenGLStorageBuffer::GetData(void* data, uint32_t size, uint32_t offset) const
+  {
+    AE_CORE_ASSERT(offset + size <= m_Size, "StorageBuffer read out of range!");
+    glGetNamedBufferSubData(m_RendererID, offset, size, data);
+  }
+
+  void OpenGLStorageBuffer::Fence()
+  {
+    if (m_Fence)
+      glDeleteSync(m_Fence);
+    m_Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+
+  bool OpenGLStorageBuffer::TryGetData(void* data, uint32_t size, uint32_t offset)
+  {
+    if (!m_Fence)
+      return false;
+
+    // Flushes as well, so the fence is reached without waiting for the next swap
+    GLenum status = glClientWaitSync(m_Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+      return false;
+
+    glDeleteSync(m_Fence);
+    m_Fence = nullptr;
+    GetData(data, size, offset);
+    return true;
+  }
+
+  void OpenGLStorageBuffer::Clear()
+  {
+    glClearNamedBufferData(m_RendererID, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+  }
+
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Ancora/Renderer/StorageBuffer.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  class OpenGLStorageBuffer : public StorageBuffer
+  {
+  public:
+    OpenGLStorageBuffer(uint32_t size, const void* data);
+    virtual ~OpenGLStorageBuffer();
+
+    virtual void Bind(uint32_t binding) const override;
+
+    virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+    virtual void GetData(void* data, uint32_t size, uint32_t offset = 0) const override;
+    virtual void Fence() override;
+    virtual bool TryGetData(void* data, uint32_t size, uint32_t offset = 0) override;
+    virtual void Clear() override;
+
+    virtual uint32_t GetSize() const override { return m_Size; }
+    virtual uint32_t GetRendererID() const override { return m_RendererID; }
+  private:
+    uint32_t m_RendererID;
+    uint32_t m_Size;
+    GLsync m_Fence = nullptr;
+  };
+
+}
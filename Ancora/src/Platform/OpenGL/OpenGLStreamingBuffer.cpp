@@ -0,0 +1,73 @@
+#include "aepch.h"
+#include "OpenGLStreamingBuffer.h"
+#include "OpenGLStateCache.h"
+
+namespace Ancora {
+
+  OpenGLStreamingBuffer::OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount)
+    : m_RegionSize(regionSize), m_Fences(regionCount, nullptr)
+  {
+    AE_CORE_ASSERT(regionCount > 1, "StreamingBuffer needs at least two regions!");
+
+    // Coherent, so writes need no flush and are seen by draws issued after them
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glCreateBuffers(1, &m_RendererID);
+    glNamedBufferStorage(m_RendererID, GetSize(), nullptr, flags);
+    m_Data = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, GetSize(), flags);
+    AE_CORE_ASSERT(m_Data, "StreamingBuffer could not be mapped!");
+  }
+
+  OpenGLStreamingBuffer::~OpenGLStreamingBuffer()
+  {
+    for (GLsync fence : m_Fences)
+    {
+      if (fence)
+        glDeleteSync(fence);
+    }
+
+    glUnmapNamedBuffer(m_RendererID);
+    OpenGLStateCache::DeleteBuffer(m_RendererID);
+  }
+
+  StreamingBuffer::Allocation OpenGLStreamingBuffer::Allocate(uint32_t size, uint32_t alignment)
+  {
+    AE_CORE_ASSERT(size <= m_RegionSize, "StreamingBuffer allocation is larger than a region!");
+
+    // Aligned in the whole buffer, so offsets can be turned into vertex indices
+    uint32_t regionStart = m_Region * m_RegionSize;
+    uint32_t offset = (regionStart + m_Head + alignment - 1) / alignment * alignment;
+    if (offset + size > regionStart + m_RegionSize)
+    {
+      NextRegion();
+      regionStart = m_Region * m_RegionSize;
+      offset = (regionStart + alignment - 1) / alignment * alignment;
+      AE_CORE_ASSERT(offset + size <= regionStart + m_RegionSize, "StreamingBuffer allocation does not fit a region once aligned!");
+    }
+
+    m_Head = offset + size - regionStart;
+    m_Stats.AllocatedBytes += size;
+    return { m_Data + offset, offset };
+  }
+
+  void OpenGLStreamingBuffer::NextRegion()
+  {
+    // Everything drawn from the region so far has been issued, since it was written before
+    m_Fences[m_Region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    m_Region = (m_Region + 1) % (uint32_t)m_Fences.size();
+    m_Head = 0;
+
+    GLsync& fence = m_Fences[m_Region];
+    if (!fence)
+      return;
+
+    if (glClientWaitSync(fence, 0, 0) == GL_TIMEOUT_EXPIRED)
+    {
+      m_Stats.Stalls++;
+      // Flushing makes sure the fence is submitted, otherwise the wait could never end
+      while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED);
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+
+}
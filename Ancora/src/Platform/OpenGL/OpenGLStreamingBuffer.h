@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Ancora/Renderer/StreamingBuffer.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  class OpenGLStreamingBuffer : public StreamingBuffer
+  {
+  public:
+    OpenGLStreamingBuffer(uint32_t regionSize, uint32_t regionCount);
+    virtual ~OpenGLStreamingBuffer();
+
+    virtual Allocation Allocate(uint32_t size, uint32_t alignment = 4) override;
+
+    virtual uint32_t GetSize() const override { return m_RegionSize * (uint32_t)m_Fences.size(); }
+    virtual uint32_t GetRegionSize() const override { return m_RegionSize; }
+    virtual uint32_t GetRendererID() const override { return m_RendererID; }
+
+    virtual void ResetStats() override { m_Stats = Statistics(); }
+    virtual const Statistics& GetStats() const override { return m_Stats; }
+  private:
+    // Fences the current region and waits until the GPU is done with the next one
+    void NextRegion();
+  private:
+    uint32_t m_RendererID;
+    uint8_t* m_Data;
+    uint32_t m_RegionSize;
+    uint32_t m_Region = 0;
+    // Write position within the current region
+    uint32_t m_Head = 0;
+    // Set when a region is left, null for regions the GPU has nothing queued from
+    std::vector<GLsync> m_Fences;
+    Statistics m_Stats;
+  };
+
+}
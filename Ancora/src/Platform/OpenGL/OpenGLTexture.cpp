@@ -1,7 +1,15 @@
 #include "aepch.h"
 #include "OpenGLTexture.h"
+#include "OpenGLStateCache.h"
 
-#include <stb_image.h>
+#include "Ancora/Core/FileWatcher.h"
+#include "Ancora/Core/JobSystem.h"
+#include "Ancora/Renderer/Image.h"
+
+#include <filesystem>
+#include <fstream>
+
+#include <glm/gtc/constants.hpp>
 
 namespace Ancora {
 
@@ -22,22 +30,30 @@ namespace Ancora {
   }
 
   OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
-    : m_Path(path)
   {
-    int width, height, channels;
-    stbi_set_flip_vertically_on_load(1);
-    stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
-    AE_CORE_ASSERT(data, "Failed to load image!");
-    m_Width = width;
-    m_Height = height;
+    Ref<Image> image = Image::Load(path);
+    AE_CORE_ASSERT(image, "Failed to load image!");
+    Init(*image);
+  }
+
+  OpenGLTexture2D::OpenGLTexture2D(const Image& image)
+  {
+    Init(image);
+  }
+
+  void OpenGLTexture2D::Init(const Image& image)
+  {
+    m_Path = image.GetPath();
+    m_Width = image.GetWidth();
+    m_Height = image.GetHeight();
 
     GLenum internalFormat = 0, dataFormat = 0;
-    if (channels == 4)
+    if (image.GetChannels() == 4)
     {
       internalFormat = GL_RGBA8;
       dataFormat = GL_RGBA;
     }
-    else if (channels == 3)
+    else if (image.GetChannels() == 3)
     {
       internalFormat = GL_RGB8;
       dataFormat = GL_RGB;
@@ -57,14 +73,41 @@ namespace Ancora {
     glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
     glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
-    glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, data);
+    glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, dataFormat, GL_UNSIGNED_BYTE, image.GetData());
 
-    stbi_image_free(data);
+    m_WatchID = FileWatcher::Watch(m_Path, [this]() { Reload(); });
   }
 
   OpenGLTexture2D::~OpenGLTexture2D()
   {
-    glDeleteTextures(1, &m_RendererID);
+    FileWatcher::Unwatch(m_WatchID);
+    OpenGLStateCache::DeleteTextures(1, &m_RendererID);
+  }
+
+  bool OpenGLTexture2D::Reload()
+  {
+    if (m_Path.empty())
+      return false;
+
+    Ref<Image> image = Image::Load(m_Path);
+    if (!image)
+    {
+      AE_CORE_ERROR("Texture '{0}' failed to reload, keeping the previous version", m_Path);
+      return false;
+    }
+
+    // Bindless handles and texture table pages refer to the current storage, so the image has to fit it
+    GLenum dataFormat = image->GetChannels() == 4 ? GL_RGBA : image->GetChannels() == 3 ? GL_RGB : 0;
+    if (image->GetWidth() != m_Width || image->GetHeight() != m_Height || dataFormat != m_DataFormat)
+    {
+      AE_CORE_ERROR("Texture '{0}' changed size or format, keeping the previous version until restart", m_Path);
+      return false;
+    }
+
+    glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, image->GetData());
+
+    AE_CORE_INFO("Reloaded texture '{0}'", m_Path);
+    return true;
   }
 
   void OpenGLTexture2D::SetData(void* data, uint32_t size)
@@ -76,59 +119,381 @@ namespace Ancora {
 
   void OpenGLTexture2D::Bind(uint32_t slot) const
   {
-    glBindTextureUnit(slot, m_RendererID);
+    OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
   }
 
 
-  OpenGLCubeMap::OpenGLCubeMap(const std::array<std::string, 6>& cubePaths)
+  static uint32_t GetMipCount(uint32_t size)
+  {
+    uint32_t levels = 1;
+    while (size >>= 1)
+      levels++;
+    return levels;
+  }
+
+  void OpenGLCubeMap::Allocate(uint32_t size, uint32_t levels, GLenum internalFormat)
   {
-    // Change this to be OpenGL 4.5 compatible
+    m_Size = size;
+    m_InternalFormat = internalFormat;
+
     glCreateTextures(GL_TEXTURE_CUBE_MAP, 1, &m_RendererID);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, m_RendererID);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    glTextureStorage2D(m_RendererID, levels, internalFormat, size, size);
+
+    glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+  }
+
+  void OpenGLCubeMap::AllocateFallback()
+  {
+    Allocate(1, 1, GL_RGBA8);
+    uint32_t black[6] = { 0xff000000, 0xff000000, 0xff000000, 0xff000000, 0xff000000, 0xff000000 };
+    glTextureSubImage3D(m_RendererID, 0, 0, 0, 0, 1, 1, 6, GL_RGBA, GL_UNSIGNED_BYTE, black);
+  }
+
+  OpenGLCubeMap::OpenGLCubeMap(const std::array<std::string, 6>& cubePaths)
+  {
+    // Cube map faces are stored top row first
+    std::array<Ref<Image>, 6> faces;
+    JobSystem::ParallelFor(6, [&](uint32_t i) { faces[i] = Image::Load(cubePaths[i], false); });
 
-    int width, height, channels;
+    for (uint32_t i = 0; i < 6; i++)
+    {
+      const Ref<Image>& face = faces[i];
+      bool matches = face && face->GetWidth() == face->GetHeight() && face->GetWidth() == faces[0]->GetWidth() && face->GetChannels() == faces[0]->GetChannels();
+      if (!matches || (face->GetChannels() != 3 && face->GetChannels() != 4))
+      {
+        AE_CORE_ERROR("CubeMap: face '{0}' is missing, not square, or differs in size or format from the first face", cubePaths[i]);
+        AllocateFallback();
+        return;
+      }
+    }
+
+    uint32_t size = faces[0]->GetWidth();
+    bool alpha = faces[0]->GetChannels() == 4;
+    Allocate(size, GetMipCount(size), alpha ? GL_RGBA8 : GL_RGB8);
+
+    // Rows of RGB faces are not 4-byte aligned in general
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (uint32_t i = 0; i < 6; i++)
+      glTextureSubImage3D(m_RendererID, 0, 0, 0, i, size, size, 1, alpha ? GL_RGBA : GL_RGB, GL_UNSIGNED_BYTE, faces[i]->GetData());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    glGenerateTextureMipmap(m_RendererID);
+  }
+
+  OpenGLCubeMap::OpenGLCubeMap(const std::string& path)
+  {
+    std::string extension = std::filesystem::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](char c) { return (char)std::tolower(c); });
 
-    for (GLuint i = 0; i < 6; i++)
+    bool loaded;
+    if (extension == ".ktx")
+      loaded = LoadKTX(path);
+    else if (extension == ".dds")
+      loaded = LoadDDS(path);
+    else
+      loaded = LoadEquirectangular(path);
+    if (!loaded)
     {
-      stbi_uc* data = stbi_load(cubePaths[i].c_str(), &width, &height, &channels, 0);
-      AE_CORE_ASSERT(data, "Failed to load image!");
-      m_Size = width;
+      if (m_RendererID)
+        OpenGLStateCache::DeleteTextures(1, &m_RendererID);
+      AllocateFallback();
+    }
+  }
+
+  // KTX 1 (https://registry.khronos.org/KTX/specs/1.0/ktxspec.v1.html), which stores OpenGL
+  // formats, so any format the driver supports, compressed ones included, is uploaded as is
+  bool OpenGLCubeMap::LoadKTX(const std::string& path)
+  {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in)
+    {
+      AE_CORE_ERROR("CubeMap: could not open '{0}'", path);
+      return false;
+    }
+    std::vector<char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    struct Header
+    {
+      uint8_t Identifier[12];
+      uint32_t Endianness, Type, TypeSize, Format, InternalFormat, BaseInternalFormat;
+      uint32_t Width, Height, Depth, ArrayElements, Faces, MipLevels, KeyValueBytes;
+    };
+
+    static const uint8_t identifier[12] = { 0xab, 'K', 'T', 'X', ' ', '1', '1', 0xbb, '\r', '\n', 0x1a, '\n' };
+    Header header;
+    if (file.size() < sizeof(Header) || (std::memcpy(&header, file.data(), sizeof(Header)), std::memcmp(header.Identifier, identifier, 12) != 0))
+    {
+      AE_CORE_ERROR("CubeMap: '{0}' is not a KTX file", path);
+      return false;
+    }
+
+    if (header.Endianness != 0x04030201 || header.Faces != 6 || header.Width != header.Height || header.Depth != 0 || header.ArrayElements != 0)
+    {
+      AE_CORE_ERROR("CubeMap: '{0}' is not a square cube map in native byte order", path);
+      return false;
+    }
 
-      GLenum internalFormat = 0, dataFormat = 0;
-      if (channels == 4)
+    // Type 0 marks compressed formats
+    bool compressed = header.Type == 0;
+    // No mips in the file: generated after the upload. The driver cannot generate them for
+    // compressed formats, so those get a single level.
+    bool generateMips = !compressed && header.MipLevels <= 1;
+    if (compressed && header.MipLevels == 0)
+      AE_CORE_WARN("CubeMap: '{0}' is compressed and has no mips, so it is used without them", path);
+    uint32_t levels = generateMips ? GetMipCount(header.Width) : std::max(header.MipLevels, 1u);
+    Allocate(header.Width, levels, header.InternalFormat);
+
+    size_t offset = sizeof(Header) + header.KeyValueBytes;
+    uint32_t storedLevels = std::max(header.MipLevels, 1u);
+    for (uint32_t level = 0; level < storedLevels; level++)
+    {
+      uint32_t faceSize;
+      if (offset + 4 > file.size())
       {
-        internalFormat = GL_RGBA;
-        dataFormat = GL_RGBA;
+        AE_CORE_ERROR("CubeMap: '{0}' is truncated", path);
+        return false;
       }
-      else if (channels == 3)
+      std::memcpy(&faceSize, file.data() + offset, 4);
+      offset += 4;
+
+      uint32_t size = std::max(header.Width >> level, 1u);
+      for (uint32_t face = 0; face < 6; face++)
       {
-        internalFormat = GL_RGB8;
-        dataFormat = GL_RGB;
+        if (offset + faceSize > file.size())
+        {
+          AE_CORE_ERROR("CubeMap: '{0}' is truncated", path);
+          return false;
+        }
+
+        const char* data = file.data() + offset;
+        if (compressed)
+          glCompressedTextureSubImage3D(m_RendererID, level, 0, 0, face, size, size, 1, header.InternalFormat, faceSize, data);
+        else
+          glTextureSubImage3D(m_RendererID, level, 0, 0, face, size, size, 1, header.Format, header.Type, data);
+
+        // Faces and levels are padded to 4 bytes, as are rows, which matches the default unpack alignment
+        offset += (faceSize + 3) & ~3u;
       }
+    }
 
-      m_InternalFormat = internalFormat;
-      m_DataFormat = dataFormat;
+    if (generateMips)
+      glGenerateTextureMipmap(m_RendererID);
+    return true;
+  }
 
-      AE_CORE_ASSERT(internalFormat & dataFormat, "Format not supported!");
+  // S3TC is an extension the loader does not generate, though every desktop driver has it
+  static const GLenum s_CompressedRGBAS3TCDXT1 = 0x83F1;
+  static const GLenum s_CompressedRGBAS3TCDXT3 = 0x83F2;
+  static const GLenum s_CompressedRGBAS3TCDXT5 = 0x83F3;
 
-      glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, dataFormat, GL_UNSIGNED_BYTE, data);
-      stbi_image_free(data);
+  static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+  {
+    return (uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24);
+  }
+
+  // DDS (https://learn.microsoft.com/windows/win32/direct3ddds/dx-graphics-dds-pguide), as
+  // written by cmft, texconv and most IBL bakers. Block compressed formats (BC1-3 and, through
+  // the DX10 header, BC6H and BC7) and the common RGBA formats are supported.
+  bool OpenGLCubeMap::LoadDDS(const std::string& path)
+  {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in)
+    {
+      AE_CORE_ERROR("CubeMap: could not open '{0}'", path);
+      return false;
+    }
+    std::vector<char> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+    struct Header
+    {
+      uint32_t Magic, Size, Flags, Height, Width, PitchOrLinearSize, Depth, MipMapCount;
+      uint32_t Reserved1[11];
+      uint32_t PixelFormatSize, PixelFormatFlags, FourCC, RGBBitCount, RBitMask, GBitMask, BBitMask, ABitMask;
+      uint32_t Caps, Caps2, Caps3, Caps4, Reserved2;
+    };
+
+    struct HeaderDX10
+    {
+      uint32_t Format, ResourceDimension, MiscFlag, ArraySize, MiscFlags2;
+    };
+
+    Header header;
+    if (file.size() < sizeof(Header) || (std::memcpy(&header, file.data(), sizeof(Header)), header.Magic != MakeFourCC('D', 'D', 'S', ' ')))
+    {
+      AE_CORE_ERROR("CubeMap: '{0}' is not a DDS file", path);
+      return false;
+    }
+
+    // Caps2 flags of a cube map with all six faces
+    static const uint32_t cubeMapFaces = 0x200 | 0xfc00;
+    bool cube = (header.Caps2 & cubeMapFaces) == cubeMapFaces;
+    size_t offset = sizeof(Header);
+
+    // Bytes per 4x4 block for compressed formats, per texel otherwise
+    uint32_t blockSize = 0;
+    bool compressed = true;
+    GLenum internalFormat = 0, format = GL_RGBA, type = 0;
+    switch (header.FourCC)
+    {
+      case MakeFourCC('D', 'X', 'T', '1'): internalFormat = s_CompressedRGBAS3TCDXT1; blockSize = 8; break;
+      case MakeFourCC('D', 'X', 'T', '3'): internalFormat = s_CompressedRGBAS3TCDXT3; blockSize = 16; break;
+      case MakeFourCC('D', 'X', 'T', '5'): internalFormat = s_CompressedRGBAS3TCDXT5; blockSize = 16; break;
+      // D3DFMT_A16B16G16R16F and D3DFMT_A32B32G32R32F
+      case 113: internalFormat = GL_RGBA16F; type = GL_HALF_FLOAT; blockSize = 8; compressed = false; break;
+      case 116: internalFormat = GL_RGBA32F; type = GL_FLOAT; blockSize = 16; compressed = false; break;
+      case MakeFourCC('D', 'X', '1', '0'):
+      {
+        HeaderDX10 dx10;
+        if (file.size() < offset + sizeof(HeaderDX10))
+        {
+          AE_CORE_ERROR("CubeMap: '{0}' is truncated", path);
+          return false;
+        }
+        std::memcpy(&dx10, file.data() + offset, sizeof(HeaderDX10));
+        offset += sizeof(HeaderDX10);
+
+        // D3D11_RESOURCE_MISC_TEXTURECUBE
+        cube = (dx10.MiscFlag & 0x4) != 0 && dx10.ArraySize == 1;
+        switch (dx10.Format)
+        {
+          case 2:  internalFormat = GL_RGBA32F; type = GL_FLOAT; blockSize = 16; compressed = false; break;
+          case 10: internalFormat = GL_RGBA16F; type = GL_HALF_FLOAT; blockSize = 8; compressed = false; break;
+          case 28: internalFormat = GL_RGBA8; type = GL_UNSIGNED_BYTE; blockSize = 4; compressed = false; break;
+          case 29: internalFormat = GL_SRGB8_ALPHA8; type = GL_UNSIGNED_BYTE; blockSize = 4; compressed = false; break;
+          case 71: internalFormat = s_CompressedRGBAS3TCDXT1; blockSize = 8; break;
+          case 74: internalFormat = s_CompressedRGBAS3TCDXT3; blockSize = 16; break;
+          case 77: internalFormat = s_CompressedRGBAS3TCDXT5; blockSize = 16; break;
+          case 95: internalFormat = GL_COMPRESSED_RGB_BPTC_UNSIGNED_FLOAT; blockSize = 16; break;
+          case 96: internalFormat = GL_COMPRESSED_RGB_BPTC_SIGNED_FLOAT; blockSize = 16; break;
+          case 98: internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; blockSize = 16; break;
+          case 99: internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; blockSize = 16; break;
+        }
+        break;
+      }
+    }
+
+    if (internalFormat == 0)
+    {
+      AE_CORE_ERROR("CubeMap: '{0}' has a DDS format that is not supported", path);
+      return false;
     }
+
+    if (!cube || header.Width != header.Height)
+    {
+      AE_CORE_ERROR("CubeMap: '{0}' is not a square cube map", path);
+      return false;
+    }
+
+    // As in LoadKTX, only uncompressed faces without mips get them generated
+    uint32_t storedLevels = std::max(header.MipMapCount, 1u);
+    bool generateMips = !compressed && storedLevels == 1;
+    uint32_t levels = generateMips ? GetMipCount(header.Width) : storedLevels;
+    Allocate(header.Width, levels, internalFormat);
+
+    // Every level of a face, then the next face
+    for (uint32_t face = 0; face < 6; face++)
+    {
+      for (uint32_t level = 0; level < storedLevels; level++)
+      {
+        uint32_t size = std::max(header.Width >> level, 1u);
+        uint32_t blocks = compressed ? (size + 3) / 4 : size;
+        size_t levelSize = (size_t)blocks * blocks * blockSize;
+        if (offset + levelSize > file.size())
+        {
+          AE_CORE_ERROR("CubeMap: '{0}' is truncated", path);
+          return false;
+        }
+
+        const char* data = file.data() + offset;
+        if (compressed)
+          glCompressedTextureSubImage3D(m_RendererID, level, 0, 0, face, size, size, 1, internalFormat, (GLsizei)levelSize, data);
+        else
+          glTextureSubImage3D(m_RendererID, level, 0, 0, face, size, size, 1, format, type, data);
+        offset += levelSize;
+      }
+    }
+
+    if (generateMips)
+      glGenerateTextureMipmap(m_RendererID);
+    return true;
+  }
+
+  // Direction through texel (s, t) of a face, both in [-1, 1], as defined by the OpenGL spec
+  static glm::vec3 GetCubeDirection(uint32_t face, float s, float t)
+  {
+    switch (face)
+    {
+      case 0: return {  1.0f,   -t,   -s };
+      case 1: return { -1.0f,   -t,    s };
+      case 2: return {     s, 1.0f,    t };
+      case 3: return {     s, -1.0f,  -t };
+      case 4: return {     s,   -t, 1.0f };
+      case 5: return {    -s,   -t, -1.0f };
+    }
+    return glm::vec3(0.0f);
+  }
+
+  bool OpenGLCubeMap::LoadEquirectangular(const std::string& path)
+  {
+    Ref<Image> panorama = Image::LoadHDR(path, false);
+    if (!panorama)
+      return false;
+
+    uint32_t width = panorama->GetWidth(), height = panorama->GetHeight();
+    uint32_t size = std::max(width / 4, 1u);
+    const float* source = panorama->GetHDRData();
+
+    auto sample = [&](float u, float v)
+    {
+      // Bilinear, wrapping around horizontally
+      float x = u * width - 0.5f, y = glm::clamp(v * height - 0.5f, 0.0f, (float)(height - 1));
+      int x0 = (int)std::floor(x), y0 = (int)y;
+      float fx = x - x0, fy = y - y0;
+      int x1 = x0 + 1, y1 = std::min(y0 + 1, (int)height - 1);
+      x0 = (x0 % (int)width + (int)width) % (int)width;
+      x1 = x1 % (int)width;
+
+      auto texel = [&](int tx, int ty) { const float* p = source + 3 * ((size_t)ty * width + tx); return glm::vec3(p[0], p[1], p[2]); };
+      return glm::mix(glm::mix(texel(x0, y0), texel(x1, y0), fx), glm::mix(texel(x0, y1), texel(x1, y1), fx), fy);
+    };
+
+    std::vector<glm::vec3> faces((size_t)6 * size * size);
+    JobSystem::ParallelFor(6, [&](uint32_t face)
+    {
+      glm::vec3* texels = faces.data() + (size_t)face * size * size;
+      for (uint32_t y = 0; y < size; y++)
+      {
+        for (uint32_t x = 0; x < size; x++)
+        {
+          glm::vec3 direction = glm::normalize(GetCubeDirection(face, 2.0f * (x + 0.5f) / size - 1.0f, 2.0f * (y + 0.5f) / size - 1.0f));
+          // The panorama's top row looks straight up
+          float u = std::atan2(direction.z, direction.x) / (2.0f * glm::pi<float>()) + 0.5f;
+          float v = std::acos(glm::clamp(direction.y, -1.0f, 1.0f)) / glm::pi<float>();
+          texels[y * size + x] = sample(u, v);
+        }
+      }
+    });
+
+    Allocate(size, GetMipCount(size), GL_RGB16F);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTextureSubImage3D(m_RendererID, 0, 0, 0, 0, size, size, 6, GL_RGB, GL_FLOAT, faces.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glGenerateTextureMipmap(m_RendererID);
+    return true;
   }
 
   OpenGLCubeMap::~OpenGLCubeMap()
   {
-    glDeleteTextures(1, &m_RendererID);
+    OpenGLStateCache::DeleteTextures(1, &m_RendererID);
   }
 
   void OpenGLCubeMap::Bind(uint32_t slot) const
   {
-    glBindTextureUnit(slot, m_RendererID);
+    OpenGLStateCache::BindTextureUnit(slot, m_RendererID);
   }
 
 }
@@ -11,35 +11,50 @@ namespace Ancora {
   public:
     OpenGLTexture2D(uint32_t width, uint32_t height);
     OpenGLTexture2D(const std::string& path);
+    OpenGLTexture2D(const Image& image);
     virtual ~OpenGLTexture2D();
 
     virtual uint32_t GetWidth() const override { return m_Width; }
     virtual uint32_t GetHeight() const override { return m_Height; }
     virtual std::string GetName() const override { return m_Path; }
+    virtual uint32_t GetRendererID() const override { return m_RendererID; }
 
     virtual void SetData(void* data, uint32_t size) override;
+    virtual bool Reload() override;
 
     virtual void Bind(uint32_t slot = 0) const override;
+  private:
+    void Init(const Image& image);
   private:
     std::string m_Path;
     uint32_t m_Width, m_Height;
     uint32_t m_RendererID;
     GLenum m_InternalFormat, m_DataFormat;
+    uint32_t m_WatchID = 0;
   };
 
   class OpenGLCubeMap : public CubeMap
   {
   public:
     OpenGLCubeMap(const std::array<std::string, 6>& cubePaths);
+    OpenGLCubeMap(const std::string& path);
     virtual ~OpenGLCubeMap();
 
     virtual uint32_t GetSize() const override { return m_Size; }
 
     virtual void Bind(uint32_t slot = 0) const override;
   private:
-    uint32_t m_Size;
-    uint32_t m_RendererID;
-    GLenum m_InternalFormat, m_DataFormat;
+    // Creates the immutable storage
+    void Allocate(uint32_t size, uint32_t levels, GLenum internalFormat);
+    bool LoadKTX(const std::string& path);
+    bool LoadDDS(const std::string& path);
+    bool LoadEquirectangular(const std::string& path);
+    // Black 1x1 faces, so a sky box that failed to load draws as nothing
+    void AllocateFallback();
+  private:
+    uint32_t m_Size = 0;
+    uint32_t m_RendererID = 0;
+    GLenum m_InternalFormat = 0;
   };
 
 }
@@ -0,0 +1,181 @@
+#include "aepch.h"
+#include "OpenGLTextureTable.h"
+#include "OpenGLStateCache.h"
+
+#include "Ancora/Core/FileWatcher.h"
+
+#include <GLFW/glfw3.h>
+
+namespace Ancora {
+
+  // GL_ARB_bindless_texture is not part of the generated loader
+  typedef GLuint64 (APIENTRYP PFNGLGETTEXTUREHANDLEARBPROC)(GLuint texture);
+  typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)(GLuint64 handle);
+  typedef void (APIENTRYP PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)(GLuint64 handle);
+
+  static PFNGLGETTEXTUREHANDLEARBPROC s_GetTextureHandle = nullptr;
+  static PFNGLMAKETEXTUREHANDLERESIDENTARBPROC s_MakeTextureHandleResident = nullptr;
+  static PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC s_MakeTextureHandleNonResident = nullptr;
+
+  static bool LoadBindlessTextures()
+  {
+    GLint extensionCount = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+    bool supported = false;
+    for (GLint i = 0; i < extensionCount && !supported; i++)
+      supported = std::strcmp((const char*)glGetStringi(GL_EXTENSIONS, i), "GL_ARB_bindless_texture") == 0;
+    if (!supported)
+      return false;
+
+    s_GetTextureHandle = (PFNGLGETTEXTUREHANDLEARBPROC)glfwGetProcAddress("glGetTextureHandleARB");
+    s_MakeTextureHandleResident = (PFNGLMAKETEXTUREHANDLERESIDENTARBPROC)glfwGetProcAddress("glMakeTextureHandleResidentARB");
+    s_MakeTextureHandleNonResident = (PFNGLMAKETEXTUREHANDLENONRESIDENTARBPROC)glfwGetProcAddress("glMakeTextureHandleNonResidentARB");
+    return s_GetTextureHandle && s_MakeTextureHandleResident && s_MakeTextureHandleNonResident;
+  }
+
+  // floor(log2(max(width, height))) + 1
+  static uint32_t GetMipCount(uint32_t width, uint32_t height)
+  {
+    uint32_t size = std::max(width, height), levels = 1;
+    while (size >>= 1)
+      levels++;
+    return levels;
+  }
+
+  // Pages have a full mip chain, so materials minify without aliasing
+  static uint32_t CreatePage(uint32_t width, uint32_t height, GLenum internalFormat, uint32_t layerCapacity)
+  {
+    uint32_t rendererID;
+    glCreateTextures(GL_TEXTURE_2D_ARRAY, 1, &rendererID);
+    glTextureStorage3D(rendererID, GetMipCount(width, height), internalFormat, width, height, layerCapacity);
+
+    glTextureParameteri(rendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTextureParameteri(rendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glTextureParameteri(rendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTextureParameteri(rendererID, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    return rendererID;
+  }
+
+  OpenGLTextureTable::OpenGLTextureTable(bool allowBindless)
+  {
+    m_Bindless = allowBindless && LoadBindlessTextures();
+    AE_CORE_INFO("Material textures: {0}", m_Bindless ? "bindless handles" : "texture array pages");
+
+    if (!m_Bindless)
+    {
+      Page white = { 0, 1, 1, GL_RGBA8, 1, 1 };
+      white.RendererID = CreatePage(1, 1, GL_RGBA8, 1);
+      uint32_t whiteTextureData = 0xffffffff;
+      glTextureSubImage3D(white.RendererID, 0, 0, 0, 0, 1, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, &whiteTextureData);
+      m_Pages.push_back(white);
+    }
+  }
+
+  OpenGLTextureTable::~OpenGLTextureTable()
+  {
+    for (uint32_t id : m_WatchIDs)
+      FileWatcher::Unwatch(id);
+
+    if (m_Bindless)
+    {
+      for (const auto& [texture, reference] : m_References)
+        s_MakeTextureHandleNonResident((GLuint64)reference.second.x | ((GLuint64)reference.second.y << 32));
+    }
+
+    for (const auto& page : m_Pages)
+      OpenGLStateCache::DeleteTextures(1, &page.RendererID);
+  }
+
+  glm::uvec2 OpenGLTextureTable::Add(const Ref<Texture2D>& texture)
+  {
+    auto it = m_References.find(texture.get());
+    if (it != m_References.end())
+      return it->second.second;
+
+    glm::uvec2 reference = m_Bindless ? AddHandle(texture) : AddLayer(texture);
+    m_References.emplace(texture.get(), std::make_pair(texture, reference));
+    return reference;
+  }
+
+  glm::uvec2 OpenGLTextureTable::AddHandle(const Ref<Texture2D>& texture)
+  {
+    // Creating the handle makes the texture's state immutable
+    GLuint64 handle = s_GetTextureHandle(texture->GetRendererID());
+    s_MakeTextureHandleResident(handle);
+    return { (uint32_t)(handle & 0xffffffff), (uint32_t)(handle >> 32) };
+  }
+
+  glm::uvec2 OpenGLTextureTable::AddLayer(const Ref<Texture2D>& texture)
+  {
+    uint32_t width = texture->GetWidth(), height = texture->GetHeight();
+    GLint internalFormat = 0;
+    glGetTextureLevelParameteriv(texture->GetRendererID(), 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+
+    uint32_t pageIndex = 1;
+    while (pageIndex < m_Pages.size())
+    {
+      const Page& page = m_Pages[pageIndex];
+      if (page.Width == width && page.Height == height && page.InternalFormat == (GLenum)internalFormat && page.LayerCount < (uint32_t)maxLayers)
+        break;
+      pageIndex++;
+    }
+
+    if (pageIndex == m_Pages.size())
+    {
+      if (m_Pages.size() == MaxPages)
+      {
+        AE_CORE_WARN("TextureTable: out of pages, {0} is replaced with white", texture->GetName());
+        return { 0, 0 };
+      }
+      m_Pages.push_back({ 0, width, height, (GLenum)internalFormat, 0, 0 });
+    }
+
+    // Pages grow by doubling; existing layers keep their index
+    Page& page = m_Pages[pageIndex];
+    if (page.LayerCount == page.LayerCapacity)
+    {
+      uint32_t capacity = std::min(std::max(page.LayerCapacity * 2, 4u), (uint32_t)maxLayers);
+      uint32_t rendererID = CreatePage(width, height, page.InternalFormat, capacity);
+      if (page.RendererID)
+      {
+        // Every level, so the old layers need no new mips
+        for (uint32_t level = 0; level < GetMipCount(width, height); level++)
+        {
+          uint32_t levelWidth = std::max(width >> level, 1u), levelHeight = std::max(height >> level, 1u);
+          glCopyImageSubData(page.RendererID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, rendererID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, levelWidth, levelHeight, page.LayerCount);
+        }
+        OpenGLStateCache::DeleteTextures(1, &page.RendererID);
+      }
+      page.RendererID = rendererID;
+      page.LayerCapacity = capacity;
+    }
+
+    uint32_t layer = page.LayerCount++;
+    glCopyImageSubData(texture->GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0, page.RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, width, height, 1);
+    glGenerateTextureMipmap(page.RendererID);
+
+    // The texture watched its file first, so it has reloaded itself by the time this runs
+    if (!texture->GetName().empty())
+    {
+      const Texture2D* source = texture.get();
+      m_WatchIDs.push_back(FileWatcher::Watch(texture->GetName(), [this, source, pageIndex, layer]()
+      {
+        glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D, 0, 0, 0, 0, m_Pages[pageIndex].RendererID, GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, source->GetWidth(), source->GetHeight(), 1);
+        glGenerateTextureMipmap(m_Pages[pageIndex].RendererID);
+      }));
+    }
+    return { pageIndex, layer };
+  }
+
+  void OpenGLTextureTable::Bind() const
+  {
+    for (uint32_t i = 0; i < m_Pages.size(); i++)
+      OpenGLStateCache::BindTextureUnit(FirstPageUnit + i, m_Pages[i].RendererID);
+  }
+
+}
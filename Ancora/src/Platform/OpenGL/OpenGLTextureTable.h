@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Ancora/Renderer/TextureTable.h"
+
+#include <glad/glad.h>
+
+namespace Ancora {
+
+  class OpenGLTextureTable : public TextureTable
+  {
+  public:
+    OpenGLTextureTable(bool allowBindless);
+    virtual ~OpenGLTextureTable();
+
+    virtual glm::uvec2 Add(const Ref<Texture2D>& texture) override;
+    virtual void Bind() const override;
+
+    virtual bool IsBindless() const override { return m_Bindless; }
+  private:
+    glm::uvec2 AddHandle(const Ref<Texture2D>& texture);
+    glm::uvec2 AddLayer(const Ref<Texture2D>& texture);
+  private:
+    struct Page
+    {
+      uint32_t RendererID = 0;
+      uint32_t Width, Height;
+      GLenum InternalFormat;
+      uint32_t LayerCount = 0;
+      uint32_t LayerCapacity = 0;
+    };
+
+    bool m_Bindless;
+    // Textures are kept alive while the table references them
+    std::unordered_map<const Texture2D*, std::pair<Ref<Texture2D>, glm::uvec2>> m_References;
+    std::vector<Page> m_Pages;
+    // Layers are copied again when their texture file changes
+    std::vector<uint32_t> m_WatchIDs;
+  };
+
+}
@@ -1,7 +1,7 @@
 #include "aepch.h"
 #include "OpenGLVertexArray.h"
 
-#include <glad/glad.h>
+#include "OpenGLStateCache.h"
 
 namespace Ancora {
 
@@ -33,24 +33,24 @@ namespace Ancora {
 
   OpenGLVertexArray::~OpenGLVertexArray()
   {
-    glDeleteVertexArrays(1, &m_RendererID);
+    OpenGLStateCache::DeleteVertexArray(m_RendererID);
   }
 
   void OpenGLVertexArray::Bind() const
   {
-    glBindVertexArray(m_RendererID);
+    OpenGLStateCache::BindVertexArray(m_RendererID);
   }
 
   void OpenGLVertexArray::Unbind() const
   {
-    glBindVertexArray(0);
+    OpenGLStateCache::BindVertexArray(0);
   }
 
   void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
   {
     AE_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-    glBindVertexArray(m_RendererID);
+    OpenGLStateCache::BindVertexArray(m_RendererID);
     vertexBuffer->Bind();
 
     uint32_t index = 0;
@@ -71,7 +71,7 @@ namespace Ancora {
 
   void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
   {
-    glBindVertexArray(m_RendererID);
+    OpenGLStateCache::BindVertexArray(m_RendererID);
     indexBuffer->Bind();
 
     m_IndexBuffer = indexBuffer;
@@ -0,0 +1,152 @@
+#include <Ancora.h>
+#include <Ancora/Core/SIMD.h>
+
+#include <chrono>
+#include <random>
+
+// Times the batched NarrowPhase kernels against the single-pair tests they are built from, on the
+// same random pairs, and checks that both give the same results. Run it from a Release build;
+// the first argument changes the number of pairs. Returns 1 if the results differ.
+
+static std::mt19937 s_Random(1234);
+
+static float RandomFloat(float min, float max)
+{
+  return std::uniform_real_distribution<float>(min, max)(s_Random);
+}
+
+static glm::vec3 RandomVector(float min, float max)
+{
+  return { RandomFloat(min, max), RandomFloat(min, max), RandomFloat(min, max) };
+}
+
+// Orthonormal basis from two vectors, by Gram-Schmidt
+static glm::mat3 Orthonormalize(const glm::vec3& x, const glm::vec3& y)
+{
+  glm::vec3 axisX = glm::normalize(x);
+  glm::vec3 axisY = glm::normalize(y - axisX * glm::dot(axisX, y));
+  return glm::mat3(axisX, axisY, glm::cross(axisX, axisY));
+}
+
+static Ancora::OBB RandomOBB()
+{
+  Ancora::OBB box;
+  box.Center = RandomVector(-2.0f, 2.0f);
+  box.Orientation = Orthonormalize(RandomVector(-1.0f, 1.0f) + glm::vec3(2.0f, 0.0f, 0.0f), RandomVector(-1.0f, 1.0f));
+  box.HalfExtents = RandomVector(0.1f, 1.0f);
+  return box;
+}
+
+// Fastest of several runs, in nanoseconds per pair
+template<typename Function>
+static double Time(uint32_t pairCount, Function&& function)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 10; run++)
+  {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+  }
+  return best / pairCount;
+}
+
+static bool BenchmarkOBBs(uint32_t pairCount)
+{
+  Ancora::OBBArray a, b;
+  a.Resize(pairCount);
+  b.Resize(pairCount);
+  for (uint32_t i = 0; i < pairCount; i++)
+  {
+    Ancora::OBB boxA = RandomOBB(), boxB = RandomOBB();
+    // Every fourth pair is nearly aligned, with edge axes around the length where they are
+    // treated as degenerate. Aligned boxes side by side are only separated by face axes.
+    if (i % 4 == 0)
+    {
+      float tilt = RandomFloat(0.0f, 3e-3f);
+      boxB.Orientation = Orthonormalize(boxA.Orientation[0] + RandomVector(-tilt, tilt), boxA.Orientation[1] + RandomVector(-tilt, tilt));
+      boxB.Center = boxA.Center + boxA.Orientation * RandomVector(-2.0f, 2.0f);
+    }
+    a.Set(i, boxA);
+    b.Set(i, boxB);
+  }
+
+  std::vector<uint8_t> single(pairCount), batched(pairCount);
+  double singleTime = Time(pairCount, [&]()
+  {
+    Ancora::Contact contact;
+    for (uint32_t i = 0; i < pairCount; i++)
+      single[i] = Ancora::NarrowPhase::Collide(a.Get(i), b.Get(i), contact) ? 1 : 0;
+  });
+  double batchedTime = Time(pairCount, [&]() { Ancora::NarrowPhase::TestOBBs(a, b, batched.data()); });
+
+  uint32_t mismatches = 0, overlaps = 0;
+  for (uint32_t i = 0; i < pairCount; i++)
+  {
+    mismatches += single[i] != batched[i];
+    overlaps += single[i];
+  }
+
+  AE_INFO("OBB vs OBB: {0} of {1} pairs overlap", overlaps, pairCount);
+  AE_INFO("  single-pair {0:.1f} ns, batched {1:.1f} ns per pair, {2:.1f}x", singleTime, batchedTime, singleTime / batchedTime);
+  if (mismatches)
+    AE_ERROR("  {0} pairs differ", mismatches);
+  return mismatches == 0;
+}
+
+static bool BenchmarkCapsules(uint32_t pairCount)
+{
+  Ancora::CapsuleArray a, b;
+  a.Resize(pairCount);
+  b.Resize(pairCount);
+  for (uint32_t i = 0; i < pairCount; i++)
+  {
+    Ancora::Capsule capsule;
+    capsule.A = RandomVector(-2.0f, 2.0f);
+    capsule.B = capsule.A + RandomVector(-1.0f, 1.0f);
+    capsule.Radius = RandomFloat(0.1f, 0.5f);
+    a.Set(i, capsule);
+
+    capsule.A = RandomVector(-2.0f, 2.0f);
+    // Every fourth capsule is parallel to its partner
+    capsule.B = capsule.A + (i % 4 == 0 ? a.Get(i).B - a.Get(i).A : RandomVector(-1.0f, 1.0f));
+    capsule.Radius = RandomFloat(0.1f, 0.5f);
+    b.Set(i, capsule);
+  }
+
+  std::vector<uint8_t> single(pairCount);
+  std::vector<float> separations(pairCount);
+  double singleTime = Time(pairCount, [&]()
+  {
+    Ancora::Contact contact;
+    for (uint32_t i = 0; i < pairCount; i++)
+      single[i] = Ancora::NarrowPhase::Collide(a.Get(i), b.Get(i), contact) ? 1 : 0;
+  });
+  double batchedTime = Time(pairCount, [&]() { Ancora::NarrowPhase::GetCapsuleSeparations(a, b, separations.data()); });
+
+  // Rounding may decide touching pairs either way
+  uint32_t mismatches = 0, overlaps = 0;
+  for (uint32_t i = 0; i < pairCount; i++)
+  {
+    mismatches += std::abs(separations[i]) > 1e-4f && single[i] != (separations[i] < 0.0f);
+    overlaps += single[i];
+  }
+
+  AE_INFO("Capsule vs capsule: {0} of {1} pairs overlap", overlaps, pairCount);
+  AE_INFO("  single-pair {0:.1f} ns, batched {1:.1f} ns per pair, {2:.1f}x", singleTime, batchedTime, singleTime / batchedTime);
+  if (mismatches)
+    AE_ERROR("  {0} pairs differ", mismatches);
+  return mismatches == 0;
+}
+
+int main(int argc, char** argv)
+{
+  Ancora::Log::Init();
+
+  uint32_t pairCount = argc > 1 ? (uint32_t)std::stoul(argv[1]) : 100000;
+  AE_INFO("NarrowPhase benchmark, {0} kernels", AE_SIMD_NAME);
+
+  bool agree = BenchmarkOBBs(pairCount);
+  agree = BenchmarkCapsules(pairCount) && agree;
+  return agree ? 0 : 1;
+}
@@ -2,8 +2,6 @@
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec2 a_TexCoords;
-layout(location = 2) in vec3 a_Normal;
 
 uniform mat4 u_ViewProjection;
 uniform mat4 u_Transform;
@@ -13,7 +11,9 @@ out vec3 v_TexCoord;
 void main()
 {
   v_TexCoord = vec3(u_Transform * vec4(a_Position, 1.0));
-  gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+  // z = w puts the sky on the far plane, behind everything drawn before it
+  vec4 position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+  gl_Position = position.xyww;
 }
 
 #type fragment
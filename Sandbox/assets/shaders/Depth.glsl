@@ -0,0 +1,25 @@
+#type vertex
+#version 450 core
+
+// Position-only pass for shadow maps and the depth pre-pass. gl_Position must be computed
+// exactly like Lighting.glsl so the main pass can test against it with GL_EQUAL.
+
+layout(location = 0) in vec3 a_Position;
+
+uniform mat4 u_ViewProjection;
+uniform mat4 u_Transform;
+
+invariant gl_Position;
+
+void main()
+{
+  gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+// Depth only
+void main()
+{
+}
@@ -0,0 +1,43 @@
+#type compute
+#version 450 core
+
+// Builds one level of the Hi-Z pyramid. Depth uses GL_LESS, so every texel keeps
+// the farthest of the texels it covers.
+
+layout(local_size_x = 8, local_size_y = 8) in;
+
+layout(binding = 0) uniform sampler2D u_Source;
+layout(r32f, binding = 0) writeonly uniform image2D u_Destination;
+
+uniform int u_SourceLevel;
+uniform int u_Reduce;
+
+void main()
+{
+  ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+  ivec2 size = imageSize(u_Destination);
+  if (texel.x >= size.x || texel.y >= size.y)
+    return;
+
+  if (u_Reduce == 0)
+  {
+    imageStore(u_Destination, texel, vec4(texelFetch(u_Source, texel, 0).r));
+    return;
+  }
+
+  // With an odd source size the last texel also takes the leftover row/column
+  ivec2 sourceSize = textureSize(u_Source, u_SourceLevel);
+  ivec2 extent = ivec2(2) + ivec2(equal(texel, size - 1)) * (sourceSize & 1);
+
+  float depth = 0.0;
+  for (int y = 0; y < extent.y; y++)
+  {
+    for (int x = 0; x < extent.x; x++)
+    {
+      ivec2 source = min(texel * 2 + ivec2(x, y), sourceSize - 1);
+      depth = max(depth, texelFetch(u_Source, source, u_SourceLevel).r);
+    }
+  }
+
+  imageStore(u_Destination, texel, vec4(depth));
+}
@@ -1,3 +1,5 @@
+#permutation BINDLESS_TEXTURES
+
 #type vertex
 #version 450 core
 
@@ -12,16 +14,21 @@ out vec3 v_Normal;
 out vec3 v_Position;
 out vec2 v_TexCoords;
 
+invariant gl_Position;
+
 void main()
 {
   gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
   v_Position = vec3(u_Transform * vec4(a_Position, 1.0));
-  v_Normal = a_Normal;
+  v_Normal = mat3(u_Transform) * a_Normal;
   v_TexCoords = a_TexCoords;
 }
 
 #type fragment
 #version 450 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
 
 layout(location = 0) out vec4 color;
 
@@ -29,12 +36,7 @@ in vec3 v_Normal;
 in vec3 v_Position;
 in vec2 v_TexCoords;
 
-struct Material
-{
-  sampler2D diffuse;
-  sampler2D specular;
-  float shininess;
-};
+#include "include/Material.glsl"
 
 struct DirLight
 {
@@ -45,26 +47,48 @@ struct DirLight
   vec3 specular;
 };
 
+uniform int u_MaterialIndex;
+// Flat color of the draw, white for most
+uniform vec4 u_Color;
 uniform vec3 u_CameraPosition;
-uniform Material u_Material;
 uniform DirLight u_DirLight;
 
+#include "include/Shadows.glsl"
+
 // TO-DO: Implement this in view space instead of world space.
 void main()
 {
+  uint materialIndex = uint(u_MaterialIndex);
+  Material material = materials[materialIndex];
+
+  vec4 albedo = material.color * u_Color;
+  if (HasMaterialTexture(material, DiffuseSlot))
+    albedo *= SampleMaterialTexture(materialIndex, DiffuseSlot, v_TexCoords);
+  if (HasMaterialTexture(material, OpacitySlot))
+    albedo.a *= SampleMaterialTexture(materialIndex, OpacitySlot, v_TexCoords).r;
+
+  vec3 specularColor = vec3(1.0);
+  if (HasMaterialTexture(material, SpecularSlot))
+    specularColor = SampleMaterialTexture(materialIndex, SpecularSlot, v_TexCoords).rgb;
+
+  vec3 emissive = material.emissive.rgb;
+  if (HasMaterialTexture(material, EmissiveSlot))
+    emissive *= SampleMaterialTexture(materialIndex, EmissiveSlot, v_TexCoords).rgb;
+
   // Ambient light
-  vec3 ambient = vec3(texture(u_Material.diffuse, v_TexCoords)) * u_DirLight.ambient;
+  vec3 ambient = albedo.rgb * u_DirLight.ambient;
 
   // Diffuse light
   vec3 normal = normalize(v_Normal);
   vec3 lightDirection = normalize(-u_DirLight.direction);
-  vec3 diffuse = vec3(texture(u_Material.diffuse, v_TexCoords)) * max(dot(normal, lightDirection), 0.0f) * u_DirLight.diffuse;
+  vec3 diffuse = albedo.rgb * max(dot(normal, lightDirection), 0.0f) * u_DirLight.diffuse;
 
   // Specular light
   vec3 cameraDirection = normalize(u_CameraPosition - v_Position);
   vec3 reflectDirection = reflect(-lightDirection, normal);
-  vec3 specular = vec3(texture(u_Material.specular, v_TexCoords)) * pow(max(dot(cameraDirection, reflectDirection), 0.0f), u_Material.shininess) * u_DirLight.specular;
+  vec3 specular = specularColor * pow(max(dot(cameraDirection, reflectDirection), 0.0f), material.shininess) * u_DirLight.specular;
 
   // Compute final color
-  color = vec4(ambient + diffuse + specular, 1.0f);
+  float shadow = ShadowFactor(v_Position, normal);
+  color = vec4(ambient + shadow * (diffuse + specular) + emissive, albedo.a);
 }
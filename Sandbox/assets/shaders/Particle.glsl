@@ -0,0 +1,54 @@
+// Camera-facing quads, one instance per entry of the alive list. Bindings match ParticleSystem::Binding.
+
+#type vertex
+#version 450 core
+
+layout(location = 0) in vec2 a_Corner;
+
+struct Particle
+{
+  vec4 positionLife;
+  vec4 velocityLifetime;
+};
+
+layout(std430, binding = 0) readonly buffer Particles { Particle particles[]; };
+layout(std430, binding = 2) readonly buffer AliveList { uint aliveList[]; };
+
+uniform mat4 u_ViewProjection;
+uniform vec3 u_CameraRight;
+uniform vec3 u_CameraUp;
+uniform vec4 u_ColorBegin;
+uniform vec4 u_ColorEnd;
+uniform vec2 u_Size;
+
+out vec4 v_Color;
+out vec2 v_Corner;
+
+void main()
+{
+  Particle particle = particles[aliveList[gl_InstanceID]];
+  float age = 1.0 - clamp(particle.positionLife.w / particle.velocityLifetime.w, 0.0, 1.0);
+  float size = mix(u_Size.x, u_Size.y, age);
+
+  vec3 position = particle.positionLife.xyz + (u_CameraRight * a_Corner.x + u_CameraUp * a_Corner.y) * size;
+  v_Color = mix(u_ColorBegin, u_ColorEnd, age);
+  v_Corner = a_Corner;
+  gl_Position = u_ViewProjection * vec4(position, 1.0);
+}
+
+#type fragment
+#version 450 core
+
+layout(location = 0) out vec4 color;
+
+in vec4 v_Color;
+in vec2 v_Corner;
+
+void main()
+{
+  // Round, with a soft edge
+  float alpha = v_Color.a * (1.0 - smoothstep(0.3, 0.5, length(v_Corner)));
+  if (alpha < 0.01)
+    discard;
+  color = vec4(v_Color.rgb, alpha);
+}
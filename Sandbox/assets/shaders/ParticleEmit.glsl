@@ -0,0 +1,78 @@
+#type compute
+#version 450 core
+
+// Pops a free slot off the dead list for every new particle and starts it at the emitter.
+// Bindings match ParticleSystem::Binding. Dispatched before ParticleSimulate.glsl, so the new
+// particles are moved in the same frame.
+
+layout(local_size_x = 64) in;
+
+struct Particle
+{
+  vec4 positionLife;
+  vec4 velocityLifetime;
+};
+
+layout(std430, binding = 0) writeonly buffer Particles { Particle particles[]; };
+layout(std430, binding = 1) readonly buffer DeadList { uint deadList[]; };
+layout(std430, binding = 3) buffer Counters { uint drawCommand[5]; uint drawCount; int deadCount; };
+
+uniform int u_EmitCount;
+uniform int u_Seed;
+uniform vec3 u_Position;
+uniform float u_SpawnRadius;
+uniform vec3 u_Direction;
+uniform float u_Spread;
+uniform vec2 u_Speed;
+uniform vec2 u_Lifetime;
+
+// PCG hash
+uint Hash(uint value)
+{
+  uint state = value * 747796405u + 2891336453u;
+  uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+  return (word >> 22u) ^ word;
+}
+
+float Random(inout uint state)
+{
+  state = Hash(state);
+  return float(state) / 4294967295.0;
+}
+
+// Uniformly distributed within spread radians of axis. Matches ConeDirection in ParticleSystem.cpp.
+vec3 ConeDirection(vec3 axis, float spread, float u, float v)
+{
+  vec3 direction = normalize(axis);
+  vec3 tangent = normalize(cross(direction, abs(direction.y) < 0.99 ? vec3(0.0, 1.0, 0.0) : vec3(1.0, 0.0, 0.0)));
+  vec3 bitangent = cross(direction, tangent);
+
+  float cosTheta = mix(1.0, cos(spread), u);
+  float sinTheta = sqrt(max(1.0 - cosTheta * cosTheta, 0.0));
+  float phi = 6.2831853 * v;
+  return direction * cosTheta + (tangent * cos(phi) + bitangent * sin(phi)) * sinTheta;
+}
+
+void main()
+{
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= uint(u_EmitCount))
+    return;
+
+  // More particles than free slots: give the slot back and emit nothing
+  int previous = atomicAdd(deadCount, -1);
+  if (previous <= 0)
+  {
+    atomicAdd(deadCount, 1);
+    return;
+  }
+  uint index = deadList[previous - 1];
+
+  uint state = Hash(uint(u_Seed) ^ Hash(id));
+  vec3 offset = ConeDirection(u_Direction, 3.14159265, Random(state), Random(state)) * u_SpawnRadius * pow(Random(state), 1.0 / 3.0);
+  vec3 velocity = ConeDirection(u_Direction, u_Spread, Random(state), Random(state)) * mix(u_Speed.x, u_Speed.y, Random(state));
+  float lifetime = max(mix(u_Lifetime.x, u_Lifetime.y, Random(state)), 0.001);
+
+  particles[index].positionLife = vec4(u_Position + offset, lifetime);
+  particles[index].velocityLifetime = vec4(velocity, lifetime);
+}
@@ -0,0 +1,71 @@
+#type compute
+#version 450 core
+
+// Moves every live particle, pushes the ones that died onto the dead list and appends the rest
+// to the alive list, whose length is the instance count of the draw. Bindings match
+// ParticleSystem::Binding. The instance count is reset before the dispatch.
+
+layout(local_size_x = 64) in;
+
+struct Particle
+{
+  vec4 positionLife;
+  vec4 velocityLifetime;
+};
+
+layout(std430, binding = 0) buffer Particles { Particle particles[]; };
+layout(std430, binding = 1) writeonly buffer DeadList { uint deadList[]; };
+layout(std430, binding = 2) writeonly buffer AliveList { uint aliveList[]; };
+layout(std430, binding = 3) buffer Counters { uint drawCommand[5]; uint drawCount; int deadCount; };
+layout(std430, binding = 4) buffer Statistics { uint aliveCount; };
+
+uniform int u_MaxParticles;
+uniform float u_Timestep;
+uniform vec3 u_Acceleration;
+uniform float u_Drag;
+
+// Survivors are counted per work group first, so the global counters see one atomic per group
+shared uint s_GroupAliveCount;
+shared uint s_GroupAliveOffset;
+
+void main()
+{
+  if (gl_LocalInvocationIndex == 0)
+    s_GroupAliveCount = 0;
+  barrier();
+
+  uint index = gl_GlobalInvocationID.x;
+  bool alive = false;
+  uint slot = 0;
+  if (index < uint(u_MaxParticles))
+  {
+    Particle particle = particles[index];
+    // Dead particles are already on the dead list
+    if (particle.positionLife.w > 0.0)
+    {
+      particle.velocityLifetime.xyz = (particle.velocityLifetime.xyz + u_Acceleration * u_Timestep) * max(1.0 - u_Drag * u_Timestep, 0.0);
+      particle.positionLife.xyz += particle.velocityLifetime.xyz * u_Timestep;
+      particle.positionLife.w -= u_Timestep;
+      particles[index] = particle;
+
+      if (particle.positionLife.w > 0.0)
+      {
+        alive = true;
+        slot = atomicAdd(s_GroupAliveCount, 1u);
+      }
+      else
+        deadList[atomicAdd(deadCount, 1)] = index;
+    }
+  }
+  barrier();
+
+  if (gl_LocalInvocationIndex == 0)
+  {
+    s_GroupAliveOffset = atomicAdd(drawCommand[1], s_GroupAliveCount);
+    atomicAdd(aliveCount, s_GroupAliveCount);
+  }
+  barrier();
+
+  if (alive)
+    aliveList[s_GroupAliveOffset + slot] = index;
+}
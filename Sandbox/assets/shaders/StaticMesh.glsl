@@ -0,0 +1,108 @@
+#permutation BINDLESS_TEXTURES
+
+#type vertex
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+layout(location = 0) in vec3 a_Position;
+layout(location = 1) in vec2 a_TexCoords;
+layout(location = 2) in vec3 a_Normal;
+
+struct Instance
+{
+  mat4 transform;
+  uint meshID;
+  uint materialID;
+};
+
+layout(std430, binding = 1) readonly buffer Instances { Instance instances[]; };
+layout(std430, binding = 4) readonly buffer VisibleInstances { uint visibleInstances[]; };
+
+uniform mat4 u_ViewProjection;
+// First command of the current indirect call within visibleInstances
+uniform int u_DrawOffset;
+
+out vec3 v_Normal;
+out vec3 v_Position;
+out vec2 v_TexCoords;
+flat out uint v_MaterialID;
+
+invariant gl_Position;
+
+void main()
+{
+  // Draw i was written by the cull shader for visibleInstances[i]
+  Instance instance = instances[visibleInstances[u_DrawOffset + gl_DrawIDARB]];
+
+  vec4 position = instance.transform * vec4(a_Position, 1.0);
+  gl_Position = u_ViewProjection * position;
+  v_Position = vec3(position);
+  v_Normal = mat3(instance.transform) * a_Normal;
+  v_TexCoords = a_TexCoords;
+  v_MaterialID = instance.materialID;
+}
+
+#type fragment
+#version 450 core
+#ifdef BINDLESS_TEXTURES
+#extension GL_ARB_bindless_texture : require
+#endif
+
+layout(location = 0) out vec4 color;
+
+in vec3 v_Normal;
+in vec3 v_Position;
+in vec2 v_TexCoords;
+flat in uint v_MaterialID;
+
+#include "include/Material.glsl"
+
+struct DirLight
+{
+  vec3 direction;
+
+  vec3 ambient;
+  vec3 diffuse;
+  vec3 specular;
+};
+
+uniform vec3 u_CameraPosition;
+uniform DirLight u_DirLight;
+
+#include "include/Shadows.glsl"
+
+void main()
+{
+  Material material = materials[v_MaterialID];
+
+  vec4 albedo = material.color;
+  if (HasMaterialTexture(material, DiffuseSlot))
+    albedo *= SampleMaterialTexture(v_MaterialID, DiffuseSlot, v_TexCoords);
+  if (HasMaterialTexture(material, OpacitySlot))
+    albedo.a *= SampleMaterialTexture(v_MaterialID, OpacitySlot, v_TexCoords).r;
+
+  vec3 specularColor = vec3(1.0);
+  if (HasMaterialTexture(material, SpecularSlot))
+    specularColor = SampleMaterialTexture(v_MaterialID, SpecularSlot, v_TexCoords).rgb;
+
+  vec3 emissive = material.emissive.rgb;
+  if (HasMaterialTexture(material, EmissiveSlot))
+    emissive *= SampleMaterialTexture(v_MaterialID, EmissiveSlot, v_TexCoords).rgb;
+
+  // Ambient light
+  vec3 ambient = albedo.rgb * u_DirLight.ambient;
+
+  // Diffuse light
+  vec3 normal = normalize(v_Normal);
+  vec3 lightDirection = normalize(-u_DirLight.direction);
+  vec3 diffuse = albedo.rgb * max(dot(normal, lightDirection), 0.0f) * u_DirLight.diffuse;
+
+  // Specular light
+  vec3 cameraDirection = normalize(u_CameraPosition - v_Position);
+  vec3 reflectDirection = reflect(-lightDirection, normal);
+  vec3 specular = specularColor * pow(max(dot(cameraDirection, reflectDirection), 0.0f), material.shininess) * u_DirLight.specular;
+
+  // Compute final color
+  float shadow = ShadowFactor(v_Position, normal);
+  color = vec4(ambient + shadow * (diffuse + specular) + emissive, albedo.a);
+}
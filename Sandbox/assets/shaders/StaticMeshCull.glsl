@@ -0,0 +1,155 @@
+#type compute
+#version 450 core
+
+// Frustum and occlusion culls every instance of a StaticMeshBatch, picks its LOD
+// and appends a draw command for it. Bindings match StaticMeshBatch::Binding.
+//
+// Occlusion culling runs in two phases. Phase 0 draws whatever was visible last
+// frame without an occlusion test. The Hi-Z pyramid is then built from that depth,
+// and phase 1 tests every instance against it, draws the ones that became visible
+// and records visibility for the next frame.
+
+layout(local_size_x = 64) in;
+
+struct MeshInfo
+{
+  vec4 boundingSphere;
+  uint lodCount;
+  int baseVertex;
+  uint firstIndex[5];
+  uint indexCount[5];
+};
+
+struct Instance
+{
+  mat4 transform;
+  uint meshID;
+  uint materialID;
+};
+
+struct DrawCommand
+{
+  uint count;
+  uint instanceCount;
+  uint firstIndex;
+  int baseVertex;
+  uint baseInstance;
+};
+
+layout(std430, binding = 0) readonly buffer Meshes { MeshInfo meshes[]; };
+layout(std430, binding = 1) readonly buffer Instances { Instance instances[]; };
+layout(std430, binding = 2) writeonly buffer Commands { DrawCommand commands[]; };
+layout(std430, binding = 3) buffer Counters { uint drawCount[2]; uint occludedCount; };
+layout(std430, binding = 4) writeonly buffer VisibleInstances { uint visibleInstances[]; };
+layout(std430, binding = 6) buffer Visibility { uint visibility[]; };
+
+layout(binding = 0) uniform sampler2D u_HiZ;
+
+uniform int u_InstanceCount;
+uniform vec4 u_FrustumPlanes[6];
+uniform vec3 u_CameraPosition;
+uniform float u_ProjectionScale;
+uniform vec4 u_LODScreenSizes;
+uniform int u_Phase;
+uniform int u_OcclusionCulling;
+uniform mat4 u_ViewProjection;
+
+bool IsOccluded(vec3 center, float radius)
+{
+  // Screen rectangle and nearest depth of the bounding box
+  vec2 rectMin = vec2(1.0);
+  vec2 rectMax = vec2(-1.0);
+  float nearestDepth = 1.0;
+  for (int i = 0; i < 8; i++)
+  {
+    vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);
+    vec4 clip = u_ViewProjection * vec4(corner, 1.0);
+    // Crosses the near plane, so it covers the camera
+    if (clip.w <= 0.0)
+      return false;
+
+    vec3 ndc = clip.xyz / clip.w;
+    rectMin = min(rectMin, ndc.xy);
+    rectMax = max(rectMax, ndc.xy);
+    nearestDepth = min(nearestDepth, ndc.z * 0.5 + 0.5);
+  }
+
+  rectMin = clamp(rectMin * 0.5 + 0.5, 0.0, 1.0);
+  rectMax = clamp(rectMax * 0.5 + 0.5, 0.0, 1.0);
+
+  // Pick the level where the rectangle spans about two texels
+  vec2 extent = (rectMax - rectMin) * vec2(textureSize(u_HiZ, 0));
+  int level = int(ceil(log2(max(max(extent.x, extent.y), 1.0))));
+  level = min(level, textureQueryLevels(u_HiZ) - 1);
+
+  // Odd level sizes fold the last row/column into the previous texel, so look one texel further
+  ivec2 levelSize = textureSize(u_HiZ, level);
+  ivec2 texelMin = min(ivec2(rectMin * vec2(levelSize)), levelSize - 1);
+  ivec2 texelMax = min(ivec2(rectMax * vec2(levelSize)) + 1, levelSize - 1);
+
+  float depth = 0.0;
+  for (int y = texelMin.y; y <= texelMax.y; y++)
+  {
+    for (int x = texelMin.x; x <= texelMax.x; x++)
+      depth = max(depth, texelFetch(u_HiZ, ivec2(x, y), level).r);
+  }
+  return nearestDepth > depth;
+}
+
+void main()
+{
+  uint id = gl_GlobalInvocationID.x;
+  if (id >= uint(u_InstanceCount))
+    return;
+
+  Instance instance = instances[id];
+  MeshInfo mesh = meshes[instance.meshID];
+
+  vec3 center = vec3(instance.transform * vec4(mesh.boundingSphere.xyz, 1.0));
+  float scale = max(length(instance.transform[0].xyz), max(length(instance.transform[1].xyz), length(instance.transform[2].xyz)));
+  float radius = mesh.boundingSphere.w * scale;
+
+  bool visible = true;
+  for (int i = 0; i < 6; i++)
+  {
+    if (dot(u_FrustumPlanes[i].xyz, center) + u_FrustumPlanes[i].w < -radius)
+      visible = false;
+  }
+
+  bool drawnInFirstPhase = u_OcclusionCulling == 0 || visibility[id] != 0;
+  if (u_Phase == 0)
+  {
+    if (!visible || !drawnInFirstPhase)
+      return;
+  }
+  else
+  {
+    if (visible && IsOccluded(center, radius))
+    {
+      atomicAdd(occludedCount, 1);
+      visible = false;
+    }
+
+    // Phase 0 only drew instances that are in the frustum, which is what visibility[id] && visible checks
+    bool alreadyDrawn = visible && drawnInFirstPhase;
+    visibility[id] = visible ? 1 : 0;
+    if (!visible || alreadyDrawn)
+      return;
+  }
+
+  // Same projected size metric as the CPU path, without the hysteresis
+  float distance = length(center - u_CameraPosition);
+  float screenSize = distance > radius ? radius * u_ProjectionScale / distance : 1.0;
+  uint lod = 0;
+  while (lod + 1 < mesh.lodCount && screenSize < u_LODScreenSizes[lod])
+    lod++;
+
+  // Phase 1 fills the second half of the command buffer
+  uint slot = atomicAdd(drawCount[u_Phase], 1) + uint(u_Phase * u_InstanceCount);
+  commands[slot].count = mesh.indexCount[lod];
+  commands[slot].instanceCount = 1;
+  commands[slot].firstIndex = mesh.firstIndex[lod];
+  commands[slot].baseVertex = mesh.baseVertex;
+  commands[slot].baseInstance = 0;
+  visibleInstances[slot] = id;
+}
@@ -0,0 +1,39 @@
+#type vertex
+#version 450 core
+#extension GL_ARB_shader_draw_parameters : require
+
+// Position-only version of StaticMesh.glsl, computing gl_Position the same way
+
+layout(location = 0) in vec3 a_Position;
+
+struct Instance
+{
+  mat4 transform;
+  uint meshID;
+  uint materialID;
+};
+
+layout(std430, binding = 1) readonly buffer Instances { Instance instances[]; };
+layout(std430, binding = 4) readonly buffer VisibleInstances { uint visibleInstances[]; };
+
+uniform mat4 u_ViewProjection;
+// First command of the current indirect call within visibleInstances
+uniform int u_DrawOffset;
+
+invariant gl_Position;
+
+void main()
+{
+  Instance instance = instances[visibleInstances[u_DrawOffset + gl_DrawIDARB]];
+
+  vec4 position = instance.transform * vec4(a_Position, 1.0);
+  gl_Position = u_ViewProjection * position;
+}
+
+#type fragment
+#version 450 core
+
+// Depth only
+void main()
+{
+}
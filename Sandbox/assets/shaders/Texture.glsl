@@ -1,20 +1,26 @@
-// Basic Texture shader
+// Batched quad shader of Renderer2D
 
 #type vertex
 #version 450 core
 
 layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec2 a_TexCoord;
+layout(location = 1) in vec4 a_Color;
+layout(location = 2) in vec2 a_TexCoord;
+layout(location = 3) in float a_TexIndex;
+layout(location = 4) in float a_TilingFactor;
 
 uniform mat4 u_ViewProjection;
-uniform mat4 u_Transform;
 
+out vec4 v_Color;
 out vec2 v_TexCoord;
+flat out int v_TexIndex;
 
 void main()
 {
-  v_TexCoord = a_TexCoord;
-  gl_Position = u_ViewProjection * u_Transform * vec4(a_Position, 1.0);
+  v_Color = a_Color;
+  v_TexCoord = a_TexCoord * a_TilingFactor;
+  v_TexIndex = int(a_TexIndex);
+  gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
 }
 
 #type fragment
@@ -22,13 +28,35 @@ void main()
 
 layout(location = 0) out vec4 color;
 
+in vec4 v_Color;
 in vec2 v_TexCoord;
+flat in int v_TexIndex;
 
-uniform vec4 u_Color;
-uniform sampler2D u_Texture;
-uniform int u_TilingFactor;
+// One per texture slot of Renderer2D, bound to units 0 to 15
+layout(binding = 0) uniform sampler2D u_Textures[16];
 
 void main()
 {
-  color = texture(u_Texture, v_TexCoord * u_TilingFactor) * u_Color;
+  // Sampler arrays may only be indexed uniformly, and the index differs between quads of a batch
+  vec4 texColor;
+  switch (v_TexIndex)
+  {
+    case  0: texColor = texture(u_Textures[ 0], v_TexCoord); break;
+    case  1: texColor = texture(u_Textures[ 1], v_TexCoord); break;
+    case  2: texColor = texture(u_Textures[ 2], v_TexCoord); break;
+    case  3: texColor = texture(u_Textures[ 3], v_TexCoord); break;
+    case  4: texColor = texture(u_Textures[ 4], v_TexCoord); break;
+    case  5: texColor = texture(u_Textures[ 5], v_TexCoord); break;
+    case  6: texColor = texture(u_Textures[ 6], v_TexCoord); break;
+    case  7: texColor = texture(u_Textures[ 7], v_TexCoord); break;
+    case  8: texColor = texture(u_Textures[ 8], v_TexCoord); break;
+    case  9: texColor = texture(u_Textures[ 9], v_TexCoord); break;
+    case 10: texColor = texture(u_Textures[10], v_TexCoord); break;
+    case 11: texColor = texture(u_Textures[11], v_TexCoord); break;
+    case 12: texColor = texture(u_Textures[12], v_TexCoord); break;
+    case 13: texColor = texture(u_Textures[13], v_TexCoord); break;
+    case 14: texColor = texture(u_Textures[14], v_TexCoord); break;
+    case 15: texColor = texture(u_Textures[15], v_TexCoord); break;
+  }
+  color = texColor * v_Color;
 }
@@ -0,0 +1,52 @@
+// Material parameters and texture lookups of the lit shaders, for fragment stages.
+// Stages that include this must enable GL_ARB_bindless_texture when BINDLESS_TEXTURES is defined.
+
+// Mirrors MaterialParameters
+struct Material
+{
+  vec4 color;
+  vec4 emissive;
+  float shininess;
+  uint textureMask;
+};
+
+layout(std430, binding = 5) readonly buffer Materials { Material materials[]; };
+// TextureTable reference of every slot, MaterialTextureCount per material
+layout(std430, binding = 7) readonly buffer MaterialTextures { uvec2 materialTextures[]; };
+
+// MaterialTexture slots
+const uint MaterialTextureCount = 11u;
+const uint DiffuseSlot = 0u;
+const uint SpecularSlot = 1u;
+const uint EmissiveSlot = 3u;
+const uint OpacitySlot = 7u;
+
+#ifndef BINDLESS_TEXTURES
+// References are a page and a layer of these arrays, otherwise bindless handles
+layout(binding = 16) uniform sampler2DArray u_TexturePages[8];
+#endif
+
+bool HasMaterialTexture(Material material, uint slot)
+{
+  return (material.textureMask & (1u << slot)) != 0u;
+}
+
+vec4 SampleMaterialTexture(uint materialIndex, uint slot, vec2 uv)
+{
+  uvec2 reference = materialTextures[materialIndex * MaterialTextureCount + slot];
+#ifdef BINDLESS_TEXTURES
+  return texture(sampler2D(reference), uv);
+#else
+  // The page is selected with a loop so the array is only indexed by uniform values;
+  // derivatives are taken outside the branch
+  vec2 dx = dFdx(uv);
+  vec2 dy = dFdy(uv);
+  vec4 result = vec4(1.0);
+  for (uint i = 0u; i < 8u; i++)
+  {
+    if (i == reference.x)
+      result = textureGrad(u_TexturePages[i], vec3(uv, float(reference.y)), dx, dy);
+  }
+  return result;
+#endif
+}
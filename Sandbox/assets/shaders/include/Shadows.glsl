@@ -0,0 +1,34 @@
+// Cascaded shadow map lookup of the lit shaders, for fragment stages
+
+uniform sampler2DArrayShadow u_ShadowMap;
+uniform mat4 u_LightSpaceMatrices[4];
+uniform float u_CascadeTexelSizes[4];
+// 0 when shadows are off
+uniform int u_CascadeCount;
+uniform int u_PCFRadius;
+
+// 1 when lit, 0 when fully in shadow. Uses the first, finest cascade that covers the position.
+float ShadowFactor(vec3 position, vec3 normal)
+{
+  for (int i = 0; i < u_CascadeCount; i++)
+  {
+    // Offset along the normal by the texel size of the cascade to avoid acne
+    vec4 lightSpace = u_LightSpaceMatrices[i] * vec4(position + normal * u_CascadeTexelSizes[i] * 1.5, 1.0);
+    vec3 coords = lightSpace.xyz / lightSpace.w * 0.5 + 0.5;
+    if (any(lessThan(coords, vec3(0.0))) || any(greaterThan(coords, vec3(1.0))))
+      continue;
+
+    // Every tap is a hardware-filtered 2x2 comparison
+    vec2 texelSize = 1.0 / vec2(textureSize(u_ShadowMap, 0).xy);
+    float lit = 0.0;
+    for (int y = -u_PCFRadius; y <= u_PCFRadius; y++)
+    {
+      for (int x = -u_PCFRadius; x <= u_PCFRadius; x++)
+        lit += texture(u_ShadowMap, vec4(coords.xy + vec2(x, y) * texelSize, float(i), coords.z - 0.0005));
+    }
+
+    int taps = 2 * u_PCFRadius + 1;
+    return lit / float(taps * taps);
+  }
+  return 1.0;
+}
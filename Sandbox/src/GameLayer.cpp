@@ -1,5 +1,7 @@
 #include "GameLayer.h"
 
+#include <imgui.h>
+
 GameLayer::GameLayer()
   : Layer("GameLayer")
 {
@@ -25,6 +27,9 @@ void GameLayer::OnUpdate(Ancora::Timestep ts)
   m_Time += ts;
   m_FPS = 1 / ts;
 
+  Ancora::Renderer3D::ResetStats();
+  Ancora::RenderCommand::ResetStateStats();
+
   if (m_Level.IsGameOver())
     m_State = GameState::GameOver;
 
@@ -51,6 +56,67 @@ void GameLayer::OnUpdate(Ancora::Timestep ts)
 void GameLayer::OnImGuiRender()
 {
   // (*) Implement UI
+
+  auto stats = Ancora::Renderer3D::GetStats();
+  ImGui::Begin("Renderer Stats");
+  ImGui::Text("FPS: %d", m_FPS);
+  ImGui::Text("Draw Calls: %d", stats.DrawCalls);
+  ImGui::Text("Material Binds: %d", stats.MaterialBinds);
+  ImGui::Text("Triangles: %d", stats.GetTotalTriangleCount());
+  for (uint32_t i = 0; i < Ancora::Mesh::MaxLODs; i++)
+    ImGui::Text("  LOD %d: %d", i, stats.LODTriangleCount[i]);
+  ImGui::Text("Occluded Objects: %d", stats.OccludedObjects);
+  ImGui::Text("Shadow Cascades Rendered: %d", stats.ShadowCascadesRendered);
+  ImGui::Text("Shadow Casters: %d", stats.ShadowCasters);
+  auto stateStats = Ancora::RenderCommand::GetStateStats();
+  ImGui::Text("State Changes: %d (%d filtered)", stateStats.StateChanges, stateStats.FilteredStateChanges);
+  ImGui::Text("Resolution Scale: %.2f", Ancora::Renderer3D::GetResolutionScale());
+
+  bool depthPrePass = Ancora::Renderer3D::GetDepthPrePass();
+  if (ImGui::Checkbox("Depth Pre-Pass", &depthPrePass))
+    Ancora::Renderer3D::SetDepthPrePass(depthPrePass);
+
+  bool occlusionCulling = Ancora::Renderer3D::GetOcclusionCulling();
+  if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling))
+    Ancora::Renderer3D::SetOcclusionCulling(occlusionCulling);
+
+  bool dynamicResolution = Ancora::Renderer3D::GetDynamicResolution();
+  if (ImGui::Checkbox("Dynamic Resolution", &dynamicResolution))
+    Ancora::Renderer3D::SetDynamicResolution(dynamicResolution);
+
+  bool stateValidation = Ancora::RenderCommand::GetStateValidation();
+  if (ImGui::Checkbox("Validate GL State", &stateValidation))
+    Ancora::RenderCommand::SetStateValidation(stateValidation);
+  ImGui::End();
+
+  const auto& physicsStats = m_Level.GetBroadphase().GetStats();
+  ImGui::Begin("Physics Stats");
+  ImGui::Text("Proxies: %d", physicsStats.ProxyCount);
+  ImGui::Text("Moved Proxies: %d", physicsStats.MovedProxies);
+  ImGui::Text("Pairs: %d", physicsStats.PairCount);
+  ImGui::Text("Broadphase Time: %.3f ms", physicsStats.UpdateTime);
+  ImGui::End();
+
+  const auto& roadStats = m_Level.GetRoadMap().GetStats();
+  ImGui::Begin("Streaming Stats");
+  ImGui::Text("Resident Chunks: %d", roadStats.ResidentChunks);
+  ImGui::Text("Generating Chunks: %d", roadStats.GeneratingChunks);
+  ImGui::Text("Pending Uploads: %d", roadStats.PendingUploads);
+  ImGui::Text("Uploaded: %.1f KB", roadStats.UploadedBytes / 1024.0f);
+  ImGui::Text("Evicted Chunks: %d", roadStats.EvictedChunks);
+  ImGui::End();
+
+  const auto& particles = m_Level.GetParticles();
+  ImGui::Begin("Particle Stats");
+  ImGui::Text("Simulation: %s", particles->GetSimulation() == Ancora::ParticleSimulation::GPU ? "GPU" : "CPU");
+  for (uint32_t i = 0; i < particles->GetEmitterCount(); i++)
+  {
+    auto emitterStats = particles->GetStats(i);
+    ImGui::Text("Emitter %d: %d particles", i, emitterStats.AliveParticles);
+    ImGui::Text("  Simulation: %.3f ms", emitterStats.SimulationTime);
+    ImGui::Text("  Draw: %.3f ms", emitterStats.DrawTime);
+  }
+  ImGui::End();
 }
 
 void GameLayer::OnEvent(Ancora::Event& e)
@@ -18,6 +18,45 @@ void GameLevel::Init()
 
   // (#) Call LoadAssets for every object.
   // ($) m_Player.LoadAssets();
+  m_RoadMap.LoadAssets();
+
+  Ancora::BroadphaseSpecification broadphaseSpec;
+  broadphaseSpec.Type = Ancora::BroadphaseType::SpatialHash;
+  m_Broadphase = Ancora::Broadphase::Create(broadphaseSpec);
+
+  m_Particles = Ancora::CreateRef<Ancora::ParticleSystem>();
+
+  Ancora::ParticleEmitterProps dust;
+  dust.SpawnRadius = 3.0f;
+  dust.Spread = 1.2f;
+  dust.SpeedMin = 0.5f;
+  dust.SpeedMax = 2.0f;
+  dust.LifetimeMin = 1.0f;
+  dust.LifetimeMax = 3.0f;
+  dust.Acceleration = { 0.0f, -0.5f, 2.0f };
+  dust.Drag = 0.5f;
+  dust.ColorBegin = { 0.6f, 0.5f, 0.4f, 0.5f };
+  dust.ColorEnd = { 0.6f, 0.5f, 0.4f, 0.0f };
+  dust.SizeBegin = 0.1f;
+  dust.SizeEnd = 0.6f;
+  dust.EmissionRate = 4000.0f;
+  m_DustEmitter = m_Particles->AddEmitter(dust, 16384);
+
+  Ancora::ParticleEmitterProps smoke;
+  smoke.Direction = { 0.0f, 0.3f, 1.0f };
+  smoke.Spread = 0.4f;
+  smoke.SpeedMin = 1.0f;
+  smoke.SpeedMax = 3.0f;
+  smoke.LifetimeMin = 0.5f;
+  smoke.LifetimeMax = 1.5f;
+  smoke.Acceleration = { 0.0f, 0.8f, 0.0f };
+  smoke.Drag = 1.0f;
+  smoke.ColorBegin = { 0.3f, 0.3f, 0.3f, 0.6f };
+  smoke.ColorEnd = { 0.5f, 0.5f, 0.5f, 0.0f };
+  smoke.SizeBegin = 0.2f;
+  smoke.SizeEnd = 1.0f;
+  smoke.EmissionRate = 600.0f;
+  m_SmokeEmitter = m_Particles->AddEmitter(smoke, 2048);
 
   // Load lights
   m_SceneData.DirLight = Ancora::Light::CreateDirectionalLight(glm::vec3(1.0f, -1.0f, 1.0f));
@@ -28,6 +67,20 @@ void GameLevel::OnUpdate(Ancora::Timestep ts)
   // (#) Call OnUpdate for every object.
   // ($) m_Player.OnUpdate(ts);
 
+  // (#) Stream the road around the player instead: m_RoadMap.SetViewerDistance(-m_Player.GetPosition().z);
+  if (m_SceneData.Camera)
+    m_RoadMap.SetViewerDistance(-m_SceneData.Camera->GetPosition().z);
+  m_RoadMap.OnUpdate(ts);
+
+  // (#) Attach the smoke to the player's exhaust instead
+  if (m_SceneData.Camera)
+  {
+    const glm::vec3& position = m_SceneData.Camera->GetPosition();
+    m_Particles->GetEmitter(m_DustEmitter).Position = position + glm::vec3(0.0f, -1.5f, -10.0f);
+    m_Particles->GetEmitter(m_SmokeEmitter).Position = position + glm::vec3(0.5f, -1.0f, -4.0f);
+  }
+  m_Particles->OnUpdate(ts);
+
   // (#) If the player collides with anything.
   // (#) All Collisions tests to be called here.
   // ($) if (CollisionTest())
@@ -36,6 +89,11 @@ void GameLevel::OnUpdate(Ancora::Timestep ts)
 
   // (#) Check if player crossed finish line here.
 
+  // After every object has set its local transform
+  m_SceneGraph.Update();
+
+  // (#) Move the broadphase proxy of every object here.
+  m_Broadphase->UpdatePairs();
 }
 
 void GameLevel::OnRender()
@@ -45,18 +103,17 @@ void GameLevel::OnRender()
   // Render the player
   // ($) m_Player.OnRender();
 
-  // (#) Render other bikers
-
-  // (#) Render other vehicles (if any)
-
-  // (#) Render pedestrians (if any)
+  // Render other bikers, vehicles and pedestrians
+  Ancora::SceneRenderer::Submit(m_World);
 
   // Render the road
-  // ($) m_RoadMap.OnRender();
+  m_RoadMap.OnRender();
 
   // Render the environment
   Ancora::Renderer3D::SkyBox(m_CubeMap, glm::vec3(0.0f), glm::vec3(100.0f));
 
+  Ancora::Renderer3D::DrawParticles(m_Particles);
+
   Ancora::Renderer3D::EndScene();
 }
 
@@ -66,6 +123,7 @@ void GameLevel::Reset()
 
   // Reset the player
   // ($) m_Player.Reset();
+  m_RoadMap.Reset();
 
   // (#) Reset all other objects.
 }
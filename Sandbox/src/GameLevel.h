@@ -4,6 +4,7 @@
 
 // (#) Include all the implementations of GameObjects here.
 // ($) #include "Player.h"
+#include "RoadMap.h"
 
 class GameLevel
 {
@@ -19,18 +20,35 @@ public:
   void UpdateCamera(const Ancora::Ref<Ancora::PerspectiveCamera>& camera) { m_SceneData.Camera = camera; }
 
   // ($) Player& GetPlayer() { return m_Player; }
+  const Ancora::Broadphase& GetBroadphase() const { return *m_Broadphase; }
+  const RoadMap& GetRoadMap() const { return m_RoadMap; }
+  const Ancora::Ref<Ancora::ParticleSystem>& GetParticles() const { return m_Particles; }
 private:
   // ($) All private methods here
   // (#) Write different collision tests for player colliding with different objects.
+  // (#) Only test the pairs reported by m_Broadphase->UpdatePairs().
   // ($) bool CollisionTest();
 private:
   // ($) All private members here
   // (#) Game objects
   // ($) Player m_Player;
-  // ($) RoadMap m_RoadMap;
-  // ($) std::vector<Bikers> m_Bikers;
-  // ($) std::vector<Vehicles> m_Vehicles;
-  // ($) std::vector<Pedestrians> m_Pedestrians;
+  RoadMap m_RoadMap;
+
+  // Bikers, vehicles and pedestrians are entities with Transform and Model components rather
+  // than GameObjects, so they are updated by component queries and drawn by the SceneRenderer
+  Ancora::World m_World;
+
+  // Bounding boxes of all objects, which find the pairs that may collide. A spatial hash, since
+  // the objects are spread along the road.
+  Ancora::Scope<Ancora::Broadphase> m_Broadphase;
+
+  // Transforms of all objects. Attachments (rider and wheels on a bike) are child nodes.
+  Ancora::SceneGraph m_SceneGraph;
+
+  // Dust kicked up on the road ahead and exhaust smoke, both following the camera
+  Ancora::Ref<Ancora::ParticleSystem> m_Particles;
+  uint32_t m_DustEmitter = 0;
+  uint32_t m_SmokeEmitter = 0;
 
   // CubeMap for the environment
   Ancora::Ref<Ancora::CubeMap> m_CubeMap;
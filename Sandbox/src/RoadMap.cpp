@@ -0,0 +1,206 @@
+#include "RoadMap.h"
+
+// Layers of a chunk
+enum RoadLayer
+{
+  Surface = 0, Terrain, Posts, Count
+};
+
+static const float s_ChunkLength = 50.0f;
+// Rows of vertices along a chunk; chunks share their edge rows, so there are no seams
+static const uint32_t s_Segments = 25;
+static const uint32_t s_SurfaceColumns = 4;
+static const uint32_t s_TerrainColumns = 6;
+static const float s_TerrainWidth = 60.0f;
+static const float s_PostSpacing = 10.0f;
+static const uint32_t s_PostsPerSide = (uint32_t)(s_ChunkLength / s_PostSpacing);
+
+glm::vec3 RoadMap::GetCenter(float distance)
+{
+  // Long sweeping bends with tighter ones on top, and gentle hills
+  float x = 30.0f * std::sin(distance / 180.0f) + 12.0f * std::sin(distance / 67.0f + 1.3f);
+  float y = 4.0f * std::sin(distance / 120.0f) + 1.5f * std::sin(distance / 41.0f);
+  return { x, y, -distance };
+}
+
+glm::vec3 RoadMap::GetForward(float distance)
+{
+  return glm::normalize(GetCenter(distance + 0.5f) - GetCenter(distance - 0.5f));
+}
+
+// Frame of the road at a distance: right across the road, up out of it
+static void GetFrame(float distance, glm::vec3& right, glm::vec3& up)
+{
+  glm::vec3 forward = RoadMap::GetForward(distance);
+  right = glm::normalize(glm::cross(forward, glm::vec3(0.0f, 1.0f, 0.0f)));
+  up = glm::cross(right, forward);
+}
+
+// Grid of rows along the road and columns across, each row given by position(row, column).
+// Normals are smoothed over the faces around each vertex. Rows -1 and s_Segments + 1 belong
+// to the neighbouring chunks and only add their faces, so edge normals match across chunks.
+template<typename Function>
+static void AddGrid(Ancora::Mesh& mesh, uint32_t columns, const Function& position)
+{
+  uint32_t rows = s_Segments + 3;
+  std::vector<glm::vec3> positions(rows * (columns + 1));
+  std::vector<glm::vec3> normals(positions.size(), glm::vec3(0.0f));
+  std::vector<glm::vec2> texCoords(positions.size());
+  for (uint32_t row = 0; row < rows; row++)
+  {
+    for (uint32_t column = 0; column <= columns; column++)
+    {
+      uint32_t i = row * (columns + 1) + column;
+      positions[i] = position((int32_t)row - 1, column, texCoords[i]);
+    }
+  }
+
+  auto addFace = [&](uint32_t a, uint32_t b, uint32_t c)
+  {
+    glm::vec3 normal = glm::cross(positions[b] - positions[a], positions[c] - positions[a]);
+    normals[a] += normal;
+    normals[b] += normal;
+    normals[c] += normal;
+  };
+  for (uint32_t row = 0; row + 1 < rows; row++)
+  {
+    for (uint32_t column = 0; column < columns; column++)
+    {
+      uint32_t a = row * (columns + 1) + column;
+      uint32_t b = a + columns + 1;
+      addFace(a, a + 1, b);
+      addFace(a + 1, b + 1, b);
+    }
+  }
+
+  uint32_t first = (uint32_t)mesh.Vertices.size();
+  for (uint32_t i = columns + 1; i < (rows - 1) * (columns + 1); i++)
+    mesh.Vertices.push_back({ positions[i], texCoords[i], glm::normalize(normals[i]) });
+
+  for (uint32_t row = 0; row < s_Segments; row++)
+  {
+    for (uint32_t column = 0; column < columns; column++)
+    {
+      uint32_t a = first + row * (columns + 1) + column;
+      uint32_t b = a + columns + 1;
+      mesh.Indices.insert(mesh.Indices.end(), { a, a + 1, b, a + 1, b + 1, b });
+    }
+  }
+}
+
+// Box with flat faces, oriented along axes (right-handed)
+static void AddBox(Ancora::Mesh& mesh, const glm::vec3& center, const glm::vec3 axes[3], const glm::vec3& halfExtents)
+{
+  for (int axis = 0; axis < 3; axis++)
+  {
+    for (float sign : { 1.0f, -1.0f })
+    {
+      glm::vec3 normal = axes[axis] * sign;
+      // u x v = normal, so the corners below run counter-clockwise seen from outside
+      glm::vec3 u = axes[(axis + 1) % 3] * halfExtents[(axis + 1) % 3];
+      glm::vec3 v = axes[(axis + 2) % 3] * halfExtents[(axis + 2) % 3];
+      if (sign < 0.0f)
+        std::swap(u, v);
+
+      glm::vec3 faceCenter = center + normal * halfExtents[axis];
+      uint32_t first = (uint32_t)mesh.Vertices.size();
+      mesh.Vertices.push_back({ faceCenter - u - v, { 0.0f, 0.0f }, normal });
+      mesh.Vertices.push_back({ faceCenter + u - v, { 1.0f, 0.0f }, normal });
+      mesh.Vertices.push_back({ faceCenter + u + v, { 1.0f, 1.0f }, normal });
+      mesh.Vertices.push_back({ faceCenter - u + v, { 0.0f, 1.0f }, normal });
+      mesh.Indices.insert(mesh.Indices.end(), { first, first + 1, first + 2, first, first + 2, first + 3 });
+    }
+  }
+}
+
+void RoadMap::GenerateChunk(int64_t chunk, std::vector<Ancora::Mesh>& layers)
+{
+  float start = chunk * s_ChunkLength;
+  auto rowDistance = [start](int32_t row) { return start + row * (s_ChunkLength / s_Segments); };
+
+  AddGrid(layers[Surface], s_SurfaceColumns, [&](int32_t row, uint32_t column, glm::vec2& texCoord)
+  {
+    float distance = rowDistance(row);
+    glm::vec3 right, up;
+    GetFrame(distance, right, up);
+
+    float across = (float)column / s_SurfaceColumns;
+    texCoord = { across, distance / s_RoadWidth };
+    return GetCenter(distance) + right * ((across - 0.5f) * s_RoadWidth);
+  });
+
+  // Both sides rise from the road edge into rolling hills
+  for (float side : { -1.0f, 1.0f })
+  {
+    AddGrid(layers[Terrain], s_TerrainColumns, [&](int32_t row, uint32_t column, glm::vec2& texCoord)
+    {
+      float distance = rowDistance(row);
+      glm::vec3 right, up;
+      GetFrame(distance, right, up);
+
+      // Columns run away from the road on the left and towards it on the right, to keep the winding
+      float outward = side > 0.0f ? (float)column / s_TerrainColumns : 1.0f - (float)column / s_TerrainColumns;
+      glm::vec3 position = GetCenter(distance) + right * (side * (0.5f * s_RoadWidth + outward * s_TerrainWidth));
+      float hills = 6.0f + 5.0f * std::sin(position.x * 0.03f + position.z * 0.02f);
+      position.y += outward * outward * hills - 0.05f;
+
+      texCoord = { position.x * 0.1f, position.z * 0.1f };
+      return position;
+    });
+  }
+
+  // Posts at fixed distances, so they line up across chunks
+  for (uint32_t i = 0; i < s_PostsPerSide; i++)
+  {
+    float distance = start + i * s_PostSpacing;
+    glm::vec3 axes[3];
+    GetFrame(distance, axes[0], axes[1]);
+    axes[2] = glm::cross(axes[0], axes[1]);
+
+    for (float side : { -1.0f, 1.0f })
+    {
+      glm::vec3 base = GetCenter(distance) + axes[0] * (side * (0.5f * s_RoadWidth + 1.0f));
+      AddBox(layers[Posts], base + axes[1] * 0.6f, axes, { 0.15f, 0.6f, 0.15f });
+    }
+  }
+}
+
+void RoadMap::LoadAssets()
+{
+  auto createMaterial = [](const glm::vec4& color)
+  {
+    Ancora::Ref<Ancora::Material> material = Ancora::CreateRef<Ancora::Material>();
+    Ancora::MaterialParameters parameters;
+    parameters.Color = color;
+    material->SetParameters(parameters);
+    return material;
+  };
+
+  Ancora::ChunkStreamerSpecification spec;
+  spec.ChunkLength = s_ChunkLength;
+  spec.ChunksAhead = 8;
+  spec.ChunksBehind = 2;
+  spec.Layers.resize(RoadLayer::Count);
+  spec.Layers[Surface] = { (s_Segments + 1) * (s_SurfaceColumns + 1), s_Segments * s_SurfaceColumns * 6, createMaterial({ 0.2f, 0.2f, 0.22f, 1.0f }) };
+  spec.Layers[Terrain] = { 2 * (s_Segments + 1) * (s_TerrainColumns + 1), 2 * s_Segments * s_TerrainColumns * 6, createMaterial({ 0.25f, 0.45f, 0.2f, 1.0f }) };
+  spec.Layers[Posts] = { 2 * s_PostsPerSide * 24, 2 * s_PostsPerSide * 36, createMaterial({ 0.9f, 0.9f, 0.9f, 1.0f }) };
+  spec.Generate = &RoadMap::GenerateChunk;
+  m_Streamer = Ancora::CreateScope<Ancora::ChunkStreamer>(spec);
+}
+
+void RoadMap::OnUpdate(Ancora::Timestep ts)
+{
+  m_Position = GetCenter(m_ViewerDistance);
+  m_Streamer->Update(m_ViewerDistance);
+}
+
+void RoadMap::OnRender()
+{
+  m_Streamer->Submit();
+}
+
+void RoadMap::Reset()
+{
+  m_ViewerDistance = 0.0f;
+  m_Position = GetCenter(0.0f);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "GameObject.h"
+
+// Endless procedural road: a winding, hilly spline with terrain and roadside posts on both
+// sides. The road runs along -z; distances are measured along z from the start line. Chunks
+// ahead of the viewer are generated on worker threads and the ones behind are recycled.
+class RoadMap : public GameObject
+{
+public:
+  virtual void LoadAssets() override;
+
+  virtual void OnUpdate(Ancora::Timestep ts) override;
+  virtual void OnRender() override;
+
+  virtual void Reset() override;
+
+  // Centre of the road at the viewer
+  virtual const glm::vec3& GetPosition() const override { return m_Position; }
+
+  // Distance of the viewer (the player) from the start line, which decides what is streamed in
+  void SetViewerDistance(float distance) { m_ViewerDistance = distance; }
+
+  // Centre of the road surface and the direction it runs in, at a distance from the start line
+  static glm::vec3 GetCenter(float distance);
+  static glm::vec3 GetForward(float distance);
+  static float GetWidth() { return s_RoadWidth; }
+
+  const Ancora::ChunkStreamer::Statistics& GetStats() const { return m_Streamer->GetStats(); }
+private:
+  static void GenerateChunk(int64_t chunk, std::vector<Ancora::Mesh>& layers);
+private:
+  static constexpr float s_RoadWidth = 12.0f;
+
+  Ancora::Scope<Ancora::ChunkStreamer> m_Streamer;
+  float m_ViewerDistance = 0.0f;
+  glm::vec3 m_Position = glm::vec3(0.0f);
+};
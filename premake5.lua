@@ -1,3 +1,9 @@
+newoption
+{
+	trigger = "avx",
+	description = "Build with AVX, so the SIMD kernels (Core/SIMD.h) run eight lanes instead of SSE2's four. Needs a CPU with AVX."
+}
+
 workspace "Ancora"
 	architecture "x64"
 	startproject "Sandbox"
@@ -15,6 +21,12 @@ workspace "Ancora"
 		"windows"
 	}
 
+	-- Every project, so FloatWide is the same type on both sides of the engine's interface
+	filter "options:avx"
+		vectorextensions "AVX"
+
+	filter {}
+
 outputdir = "%{cfg.buildcfg}-%{cfg.system}-%{cfg.architecture}"
 
 IncludeDir = {}
@@ -201,6 +213,74 @@ project "Sandbox"
 		}
 
 
+	filter "configurations:Debug"
+		defines
+		{
+			"AE_DEBUG",
+			"AE_ENABLE_ASSERTS"
+		}
+		runtime "Debug"
+		symbols "on"
+
+	filter "configurations:Release"
+		defines "AE_RELEASE"
+		runtime "Release"
+		optimize "on"
+
+	filter "configurations:Dist"
+		defines "AE_DIST"
+		runtime "Release"
+		optimize "on"
+
+-- Times the engine's kernels against their reference implementations and exits with 1 if they disagree
+project "Benchmarks"
+	location "Benchmarks"
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++17"
+	staticruntime "on"
+
+	targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+	objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+	files
+	{
+		"%{prj.name}/src/**.h",
+		"%{prj.name}/src/**.cpp"
+	}
+
+	includedirs
+	{
+		"Ancora/vendor/spdlog/include",
+		"Ancora/src",
+		"%{IncludeDir.glm}",
+		"%{IncludeDir.ImGui}",
+		"%{IncludeDir.assimp}"
+	}
+
+	links
+	{
+		"Ancora",
+		"assimp"
+	}
+
+	filter "system:linux"
+
+		defines
+		{
+			"AE_PLATFORM_LINUX",
+			"AE_BUILD_DLL"
+		}
+
+	filter "system:windows"
+		systemversion "latest"
+
+		defines
+		{
+			"AE_PLATFORM_WINDOWS"
+		}
+
+
 	filter "configurations:Debug"
 		defines
 		{
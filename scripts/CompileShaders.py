@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# Offline shader build: resolves #include lines, expands the #permutation matrix of every
+# shader and validates each stage of each permutation with glslangValidator. With --spirv,
+# OpenGL SPIR-V binaries are written as well, one per stage and permutation.
+#
+# The engine still compiles GLSL at runtime (and caches the linked programs), because its
+# shaders set uniforms by name, which SPIR-V programs in OpenGL do not support.
+
+import argparse
+import itertools
+import os
+import subprocess
+import sys
+import tempfile
+
+STAGE_EXTENSIONS = { "vertex": "vert", "fragment": "frag", "pixel": "frag", "compute": "comp" }
+
+
+def resolve_includes(source, directory, included):
+  lines = []
+  for line in source.splitlines():
+    stripped = line.strip()
+    if not stripped.startswith("#include"):
+      lines.append(line)
+      continue
+
+    path = os.path.normpath(os.path.join(directory, stripped.split('"')[1]))
+    if path in included:
+      continue
+    included.add(path)
+    with open(path) as file:
+      lines.append(resolve_includes(file.read(), os.path.dirname(path), included))
+  return "\n".join(lines)
+
+
+# Returns the declared permutation defines and the source of every stage, like OpenGLShader::PreProcess
+def parse_shader(path):
+  with open(path) as file:
+    source = file.read()
+
+  permutations = []
+  stages = {}
+  stage = None
+  for line in source.splitlines():
+    if line.startswith("#type"):
+      stage = line.split()[1]
+      stages[stage] = []
+    elif stage:
+      stages[stage].append(line)
+    elif line.startswith("#permutation"):
+      permutations += line.split()[1:]
+
+  directory = os.path.dirname(path)
+  return permutations, { stage: resolve_includes("\n".join(lines), directory, set()) for stage, lines in stages.items() }
+
+
+def insert_defines(source, defines):
+  lines = source.splitlines()
+  version = next(i for i, line in enumerate(lines) if line.startswith("#version"))
+  return "\n".join(lines[:version + 1] + ["#define " + define for define in defines] + lines[version + 1:]) + "\n"
+
+
+def main():
+  parser = argparse.ArgumentParser(description="Validate every shader permutation and optionally compile them to SPIR-V")
+  parser.add_argument("--shaders", default="Sandbox/assets/shaders", help="directory of the .glsl files")
+  parser.add_argument("--spirv", help="directory to write <shader>[.<define>...].<stage>.spv files to")
+  parser.add_argument("--glslang", default="glslangValidator", help="glslangValidator executable")
+  args = parser.parse_args()
+
+  if args.spirv:
+    os.makedirs(args.spirv, exist_ok=True)
+
+  failures = 0
+  variants = 0
+  with tempfile.TemporaryDirectory() as temp:
+    for filename in sorted(os.listdir(args.shaders)):
+      if not filename.endswith(".glsl"):
+        continue
+
+      name = filename[:-len(".glsl")]
+      permutations, stages = parse_shader(os.path.join(args.shaders, filename))
+      for count in range(len(permutations) + 1):
+        for defines in itertools.combinations(permutations, count):
+          variants += 1
+          variant = ".".join([name] + list(defines))
+          for stage, source in stages.items():
+            extension = STAGE_EXTENSIONS[stage]
+            stage_path = os.path.join(temp, variant + "." + extension)
+            with open(stage_path, "w") as file:
+              file.write(insert_defines(source, defines))
+
+            command = [args.glslang, stage_path]
+            if args.spirv:
+              # Plain uniforms need locations in SPIR-V, so let glslang assign them
+              command += ["-G", "--auto-map-locations", "--auto-map-bindings", "-o", os.path.join(args.spirv, variant + "." + extension + ".spv")]
+
+            result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, universal_newlines=True)
+            if result.returncode != 0:
+              failures += 1
+              print("FAILED {0} ({1})".format(variant, stage))
+              print(result.stdout)
+
+  print("{0} shader variants, {1} failed stages".format(variants, failures))
+  return 1 if failures else 0
+
+
+if __name__ == "__main__":
+  sys.exit(main())